@@ -366,9 +366,10 @@ bool Cel::usingUUIDPostfix() {
 
 /*!
     Used during a paint method to draw presentation data about the Cel.  Sublcasses
-    Should always call this method in their paint() overload.
+    Should always call this method in their paint() overload.  \a exposed is the
+    area of the Cel that actually needs to be drawn; a null rect means all of it.
 */
-void Cel::paint(QPainter *painter) {
+void Cel::paint(QPainter *painter, const QRectF &exposed) {
     // Much ado about nothing...
 }
 
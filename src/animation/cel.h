@@ -20,6 +20,8 @@
 #include <QPointer>
 #include <QSize>
 #include <QSet>
+#include <QRect>
+#include <QRectF>
 class Animation;
 class CelRef;
 class QStringList;
@@ -67,7 +69,7 @@ public:
     bool usingUUIDPostfix();
 
     // Painting info for the QGraphicsScene
-    virtual void paint(QPainter *painter);
+    virtual void paint(QPainter *painter, const QRectF &exposed=QRectF());
 
     // Cel Referecnes
     void registerRef(CelRef *ref);
@@ -87,6 +89,7 @@ signals:
     void deactivated();
     void nameChanged(QString name);
     void resized(QSize size);
+    void damaged(QRect rect);
 
 
 protected:
@@ -172,7 +172,7 @@ QPointer<CelRefItem> CelRef::mkItem() {
 */
 void CelRef::update(const QRectF &rect) {
     for (auto iter = _cris.begin(); iter != _cris.end(); iter++)
-        (*iter)->update();
+        (*iter)->update(rect);
 }
 
 
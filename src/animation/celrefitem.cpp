@@ -9,6 +9,7 @@
 #include "widgets/drawing/canvas.h"
 #include <QGraphicsRectItem>
 #include <QGraphicsTextItem>
+#include <QStyleOptionGraphicsItem>
 #include <QDebug>
 
 
@@ -34,6 +35,9 @@ CelRefItem::CelRefItem(CelRef *ref) :
     QGraphicsObject(NULL),
     _ref(ref)
 {
+    // So exposedRect is filled in for paint()
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+
     // If we have a reference, hookup the position changed signal
     if (_ref) {
         Cel *cel = _ref->cel();
@@ -95,11 +99,12 @@ QRectF CelRefItem::boundingRect() const {
 
 
 /*!
-    Required to be implemented by QGraphicsObject.  Will draw the Cel onto the painter.
+    Required to be implemented by QGraphicsObject.  Will draw the Cel onto the painter,
+    only the exposed part of it though.
 */
 void CelRefItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
     if (_ref && _ref->_cel)
-        _ref->_cel->paint(painter);
+        _ref->_cel->paint(painter, option->exposedRect);
     else
         return;
 }
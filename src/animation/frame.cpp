@@ -59,6 +59,7 @@
 #include "animation/frameitem.h"
 #include "animation/animation.h"
 #include "util.h"
+#include <QRect>
 #include <QPainter>
 #include <QDebug>
 
@@ -242,10 +243,14 @@ void Frame::addCel(CelRef *ref, int at) {
 
     // Add signals
     connect(ref, &CelRef::positionChanged, this, &Frame::_onCelRefPositionChanged);
+    connect(ref->cel(), &Cel::damaged, this, &Frame::_onContentChanged, Qt::UniqueConnection);
+    connect(ref->cel(), &Cel::resized, this, &Frame::_onContentChanged, Qt::UniqueConnection);
 
     // If the frame is active, then activate the Cel as well
     if (_active)
         ref->cel()->activate();
+
+    _onContentChanged();
 }
 
 
@@ -265,9 +270,15 @@ CelRef *Frame::removeCel(int at) {
     emit celRemoved(ref);
     ref->setFrame(NULL);                                    // Unlink with the CelRef
 
-    // Removed signals
+    // Removed signals, the Cel's only if it isn't in here again
     disconnect(ref, 0, this, 0);
+    bool celStillUsed = false;
+    for (auto iter = _celRefs.begin(); iter != _celRefs.end(); iter++)
+        celStillUsed |= ((*iter)->cel() == ref->cel());
+    if (!celStillUsed)
+        disconnect(ref->cel(), 0, this, 0);
 
+    _onContentChanged();
     return ref;
 }
 
@@ -282,6 +293,7 @@ void Frame::moveCel(int at, int to) {
     _celRefs.move(at, to);
     _updateCelRefOrder(qMin(at, to));
     emit celMoved(_celRefs[to]);
+    _onContentChanged();
 }
 
 
@@ -365,18 +377,35 @@ QList<QPointer<TimedFrame>> Frame::timedFrames() {
     it will render a Null QImage.
 */
 QImage Frame::render() {
-    QImage img = util::mkBlankImage(_anim->frameSize());
+    return render(QRect(QPoint(0, 0), _anim->frameSize()));
+}
+
+
+/*!
+    Renders only \a region (in Frame coordinates) of the Frame.  The returned image
+    is the size of \a region, and its top left corner is the top left of \a region.
+    Cels that are outside of \a region are skipped, and only the overlapping part
+    of the others is drawn.
+*/
+QImage Frame::render(const QRect &region) {
+    QImage img = util::mkBlankImage(region.size());
 
-    if (numCels() == 0)
+    if ((numCels() == 0) || img.isNull())
         return img;
     else {
         // Paint all of the Cels
         QPainter p(&img);
+        p.translate(-region.topLeft());
 
         // Need to paint them in the reverse order of how they appear un the list
         for (auto iter = (_celRefs.end() - 1); iter != (_celRefs.begin() - 1); iter--) {
             CelRef *cr = *iter;
-            p.drawImage(cr->pos(), cr->cel()->image());
+            QRect celRect(cr->pos().toPoint(), cr->cel()->size());
+            QRect overlap = celRect & region;
+            if (overlap.isEmpty())
+                continue;
+
+            p.drawImage(overlap.topLeft(), cr->cel()->image(), overlap.translated(-celRect.topLeft()));
         }
     }
 
@@ -384,6 +413,19 @@ QImage Frame::render() {
 }
 
 
+/*!
+    Returns the content generation of the Frame.  It goes up each time something changes
+    what render() would give back (Cels added, removed, moved or drawn on), so a copy of a
+    render can be checked against it to see if it's out of date.  It starts at zero each
+    time the Frame is made, so it means nothing across runs.
+
+    \sa contentChanged()
+*/
+quint32 Frame::generation() {
+    return _generation;
+}
+
+
 /*!
     Returns the current frameSize set in the Animation object this is connected to.
 
@@ -456,6 +498,17 @@ void Frame::deactivate() {
 */
 void Frame::_onCelRefPositionChanged(QPointF pos) {
     emit celRefPositionChanged((CelRef *)sender());
+    _onContentChanged();
+}
+
+
+/*!
+    Internal function.  Called when anything that changes what the Frame looks like happens
+    (e.g. one of its Cels is drawn on).  Bumps the generation and emits contentChanged().
+*/
+void Frame::_onContentChanged() {
+    _generation++;
+    emit contentChanged();
 }
 
 
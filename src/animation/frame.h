@@ -22,6 +22,7 @@ class Animation;
 class TimedFrame;
 class FrameItem;
 class QImage;
+class QRect;
 
 
 
@@ -59,6 +60,8 @@ public:
 
     // Rendering
     QImage render();
+    QImage render(const QRect &region);
+    quint32 generation();
 
     // Animation stuff
     QSize frameSize();
@@ -85,11 +88,13 @@ signals:
     void celRemoved(CelRef *cel);
     void celMoved(CelRef *cel);
     void celRefPositionChanged(CelRef *ref);
+    void contentChanged();
 
 
 private:
     // Cel stuff
     void _onCelRefPositionChanged(QPointF pos);
+    void _onContentChanged();
 
 
 protected:
@@ -103,6 +108,7 @@ protected:
     bool _usingRandomName = false;                // If a name was randomly generated for the Frame, then this flag is set, the postfix is it's given name
     bool _usingUUIDPostfix = false;                // When assigning a name, if the name is taken, then it will automatically assing a UUID postfix
     bool _active = false;                        // Flag to see if the Frame is currently marked as active or not
+    quint32 _generation = 0;                    // Goes up each time what the Frame looks like changes, see generation()
 
     // Scence & View stuff
     QList<CelRef *> _celRefs;                    // List of pointers to Cel objects; order is important and matters for layering
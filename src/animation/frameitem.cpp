@@ -15,7 +15,10 @@
 #include "animation/frameitem.h"
 #include "animation/frame.h"
 #include "animation/celref.h"
+#include "animation/cel.h"
+#include "util.h"
 #include <QPainter>
+#include <QStyleOptionGraphicsItem>
 #include <QDebug>
 
 
@@ -27,12 +30,21 @@ FrameItem::FrameItem(Frame *frame) :
     QGraphicsObject(NULL),
     _frame(frame)
 {
+    // So exposedRect is filled in for paint()
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+
     // got a Frame? do things
     if (_frame) {
         // connect signals & slots
         connect(_frame, &Frame::celAdded, this, &FrameItem::_onCelAdded);
         connect(_frame, &Frame::celRemoved, this, &FrameItem::_onCelRemoved);
         connect(_frame, &Frame::celMoved, this, &FrameItem::_onCelMoved);
+        connect(_frame, &Frame::celRefPositionChanged, this, &FrameItem::_onCelRefPositionChanged);
+
+        // Watch the Cels for edits, so the cached render can be redone
+        QList<CelRef *> refs = _frame->cels();
+        for (auto iter = refs.begin(); iter != refs.end(); iter++)
+            _connectCel((*iter)->cel());
     }
 
     qDebug() << "[FrameItem created] frame=" << _frame;
@@ -60,13 +72,41 @@ QRectF FrameItem::boundingRect() const {
 
 
 /*!
-    Overloaded function.  Renders the frame onto the painter.
+    Overloaded function.  Renders the frame onto the painter.  The render is
+    cached until the Frame or one of its Cels changes.  When the painter is
+    scaled down, a smaller mip level of the render is drawn.  Only the exposed
+    part of the Frame is drawn.
 */
 void FrameItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
     if (_frame) {
+        // Redo the render if needed
+        if (_render.isNull()) {
+            _render = _frame->render();
+            _mips.clear();
+        }
+
         // Draw the Frame
-        painter->drawImage(0, 0, _frame->render());
+        util::drawImageMipmapped(painter, _render, _mips, option->exposedRect);
+    }
+}
+
+
+/*!
+    Puts the pixel at \a px (in Frame coordinates) of the cached render into \a clr,
+    premultiplied.  Returns false if the render needs to be redone (it hasn't been painted since
+    the Frame changed).  If there is no Frame, \a clr is transparent.
+*/
+bool FrameItem::sample(QPoint px, QRgb *clr) {
+    if (!_frame) {
+        *clr = qRgba(0, 0, 0, 0);
+        return true;
     }
+
+    if (_render.isNull())
+        return false;
+
+    *clr = _render.valid(px) ? _render.pixel(px) : qRgba(0, 0, 0, 0);
+    return true;
 }
 
 
@@ -74,7 +114,8 @@ void FrameItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
     Triggered via Frame::celAdded(), this will schedule a redraw.
 */
 void FrameItem::_onCelAdded(CelRef *cel) {
-    update();
+    _connectCel(cel->cel());
+    _invalidate();
 }
 
 
@@ -82,7 +123,17 @@ void FrameItem::_onCelAdded(CelRef *cel) {
     Triggered via Frame::celRemoved(), this will schedule a redraw.
 */
 void FrameItem::_onCelRemoved(CelRef *cel) {
-    update();
+    Cel *c = cel->cel();
+    if (c) {
+        disconnect(c, 0, this, 0);
+
+        // Another CelRef in the Frame might still be using that Cel
+        QList<CelRef *> refs = _frame->cels();
+        for (auto iter = refs.begin(); iter != refs.end(); iter++)
+            _connectCel((*iter)->cel());
+    }
+
+    _invalidate();
 }
 
 
@@ -90,7 +141,7 @@ void FrameItem::_onCelRemoved(CelRef *cel) {
     Triggered via Frame::celMoved(), this will schedule a redraw.
 */
 void FrameItem::_onCelMoved(CelRef *cel) {
-    update();
+    _invalidate();
 }
 
 
@@ -98,5 +149,35 @@ void FrameItem::_onCelMoved(CelRef *cel) {
     Triggered via Frame::celRefPositionChanged(), this will schedule a redraw.
 */
 void FrameItem::_onCelRefPositionChanged(CelRef *ref) {
+    _invalidate();
+}
+
+
+/*!
+    Triggered via Cel::damaged() or Cel::resized(), this will schedule a redraw.
+*/
+void FrameItem::_onCelDamaged() {
+    _invalidate();
+}
+
+
+/*!
+    Internal function.  Watches \a cel for changes to its image data.
+*/
+void FrameItem::_connectCel(Cel *cel) {
+    if (!cel)
+        return;
+
+    connect(cel, &Cel::damaged, this, &FrameItem::_onCelDamaged, Qt::UniqueConnection);
+    connect(cel, &Cel::resized, this, &FrameItem::_onCelDamaged, Qt::UniqueConnection);
+}
+
+
+/*!
+    Internal function.  Throws away the cached render and schedules a redraw.
+*/
+void FrameItem::_invalidate() {
+    _render = QImage();
+    _mips.clear();
     update();
 }
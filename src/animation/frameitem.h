@@ -9,7 +9,10 @@
 
 #include <QGraphicsObject>
 #include <QPointer>
+#include <QImage>
+#include <QList>
 class CelRef;
+class Cel;
 class Frame;
 
 
@@ -24,6 +27,9 @@ public:
     QRectF boundingRect() const;
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget=NULL);
 
+    // Cached render
+    bool sample(QPoint px, QRgb *clr);
+
 
 private slots:
     // Cel signals
@@ -31,10 +37,16 @@ private slots:
     void _onCelRemoved(CelRef *cel);
     void _onCelMoved(CelRef *cel);
     void _onCelRefPositionChanged(CelRef *ref);
+    void _onCelDamaged();
 
 
 private:
+    void _connectCel(Cel *cel);
+    void _invalidate();
+
     QPointer<Frame> _frame;
+    QImage _render;                // Cached render of _frame, null when it needs to be redone
+    QList<QImage> _mips;        // Lazily generated mip levels of _render
 
 
 };
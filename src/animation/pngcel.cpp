@@ -23,6 +23,7 @@
 #include <QPainter>
 #include <QFile>
 #include <QDebug>
+#include <cstring>
 
 
 
@@ -218,17 +219,22 @@ bool PNGCel::setName(QString name) {
 /*!
     Returns a copy of the QImage that this PNGCel contains.  Overrides base 
     class function.
+
+    If it isn't loaded up, the PNG is only read.  Going through _loadPNG() and _closePNG()
+    would write it back out (unchanged) each time, which is slow for the things that render
+    inactive Cels often (e.g. the other planes on the Canvas), and would change the file's
+    modification time (that the thumbnails on disk are keyed by).
 */
 QImage PNGCel::image() {
     if (_png)
         return *_png;
     else {
-        // Need to temporarly load up the image
-        _loadPNG();
-        QImage img(*_png);        // Copy
-        _closePNG();
+        QString path = _anim->resourceDir() + _name + ".png";
+        QImage img(path);
+        if (img.isNull())
+            qDebug() << "Error, wasn't able to open the PNG for:" << _name;
 
-        return img;                // Give it out
+        return img.convertToFormat(QImage::Format_ARGB32_Premultiplied);
     }
 }
 
@@ -256,6 +262,10 @@ void PNGCel::setImage(QImage &image) {
     else
         delete oldImage;
 
+    // Mip levels are stale now
+    _mips.clear();
+    emit damaged(QRect(QPoint(0, 0), _size));
+
     // Send a signal to repaint if active
     if (_active) {
         for (auto crIter = _celRefs.begin(); crIter != _celRefs.end(); crIter++)
@@ -264,6 +274,43 @@ void PNGCel::setImage(QImage &image) {
 }
 
 
+/*!
+    Gives direct access to the loaded image data of the PNGCel, so it can be
+    painted on in place (no copies).  Returns NULL if the PNGCel isn't loaded
+    (i.e. not active).  After modifying the image, call damage() with the area
+    that was changed.
+
+    \sa damage()
+*/
+QImage *PNGCel::imageData() {
+    return _png;
+}
+
+
+/*!
+    Tells the PNGCel that \a rect (in Cel coordinates) of the image data was
+    modified through imageData().  Emits the damaged() signal and repaints only
+    that area of the CelRefs.
+
+    \sa imageData()
+*/
+void PNGCel::damage(QRect rect) {
+    rect &= QRect(QPoint(0, 0), _size);
+    if (rect.isEmpty())
+        return;
+
+    // Mip levels are stale now
+    _mips.clear();
+    emit damaged(rect);
+
+    // Repaint just that part
+    if (_active) {
+        for (auto crIter = _celRefs.begin(); crIter != _celRefs.end(); crIter++)
+            (*crIter)->update(rect);
+    }
+}
+
+
 /*!
     Not necessarly a deconstructor, but calling this function will mark the PNG
     to be removed upon the delection of the Cel.  By default deletePNG is set to
@@ -291,15 +338,18 @@ bool PNGCel::toBeRemoved() {
 
 
 /*!
-    Will paint the image data to the QGraphicsScene.
+    Will paint the image data to the QGraphicsScene.  Only the part inside of
+    \a exposed is drawn.  If the painter is scaled down (e.g. the Canvas is
+    zoomed out), a smaller mip level of the image is drawn instead of the full
+    sized one.
 */
-void PNGCel::paint(QPainter *painter) {
+void PNGCel::paint(QPainter *painter, const QRectF &exposed) {
     // Don't paint an image unless something is loaded up
     if (_png)
-        painter->drawImage(0, 0, *_png);
+        util::drawImageMipmapped(painter, *_png, _mips, exposed);
 
     // Call parent class's method
-    Cel::paint(painter);
+    Cel::paint(painter, exposed);
 }
 
 
@@ -317,64 +367,62 @@ void PNGCel::paint(QPainter *painter) {
         cel->resize(new_width - width(), new_height - height(), new_width, new_height);
     \endcode
     
-    There is a chance that the Cel's image data might be cutoff if you give the
-    x or y varaibles a postion greater than (new - old).  It's your choice. 
-    The underlying PNG image will also be overwritten.
-    
-    It will return true on success, or false on falure.  If an invalid width or
-    height are given, this funtion will return false and do nothing.
+    Anything of the old image that lands outside of the new size is cropped off, and
+    any new area is transparent.  x and y may be negative (e.g. to crop from the left).
+    The image is reallocated once and only the rows that are kept are copied over.  If
+    the Cel isn't loaded, the underlying PNG image will be overwritten.
+
+    Emits Cel::resized() and then Cel::damaged() for the whole new area.  If an invalid
+    width or height are given, they'll be bumped up to 1.
+
+    \sa resize(QSize, Qt::Alignment)
 */
 void PNGCel::resize(int x, int y, int width, int height) {
-    // TODO it's undefined what will happen if x or y are negative.  figure out what
-    //      will happen.
-
     // Bounds
     if (width < 1)
         width = 1;
     if (height < 1)
         height = 1;
     
-    // don't do anything if still the same size
-    if ((width == _size.width()) && (height == _size.height()))
+    // don't do anything if nothing would change
+    if ((width == _size.width()) && (height == _size.height()) && (x == 0) && (y == 0))
         return;
-    
-    // TODO renable later
-//
-//    // Load up the image
-//    bool imageLoaded = (_png != NULL);        // Refers to if the image has been loaded or not previously
-//    if (!imageLoaded)
-//        _loadPNG();
-//    
-//    // Vars
-//    QSize newSize(width, height);
-//    QImage *tmp = new QImage(util::mkBlankImage(newSize));
-//    QImage *oldImage = NULL;
-//    QString path = _anim->resourceDir() + _name + ".png";
-//
-//    // Copy the older one over and save it
-//    QPainter p(tmp);
-//    p.drawImage(x, y, *_png);
-//    p.end();
-//
-//    // Swap variables
-//    if (!imageLoaded)
-//        oldImage = _png;
-//    _png = tmp;
-//
-//    // cleanup if needed
-//    if (!imageLoaded)
-//        _closePNG();
-//    else
-//        delete oldImage;
-//
-//    // Repaint all of our CelRefs
-//    if (_active) {
-//        for (auto crp : _celRefs)
-//            crp->update();
-//    }
-//
+
+    // Load up the image
+    bool imageLoaded = (_png != NULL);        // Refers to if the image has been loaded or not previously
+    if (!imageLoaded)
+        _loadPNG();
+    if (!_png)
+        return;
+
+    // Only the part of the old image that lands in the new one is moved
+    QImage *tmp = new QImage(util::mkBlankImage(QSize(width, height)));
+    QRect kept = QRect(QPoint(0, 0), _png->size()) & QRect(-x, -y, width, height);
+    int rowBytes = kept.width() * 4;
+    for (int row = kept.top(); row <= kept.bottom(); row++) {
+        const uchar *src = _png->constScanLine(row) + (kept.left() * 4);
+        uchar *dest = tmp->scanLine(row + y) + ((kept.left() + x) * 4);
+        memcpy(dest, src, rowBytes);
+    }
+
+    // Swap
+    delete _png;
+    _png = tmp;
+    _mips.clear();
+
     // Call the parent function to resize
     Cel::resize(width, height);
+
+    // cleanup if needed (saves the new PNG)
+    if (!imageLoaded)
+        _closePNG();
+
+    // Everything has moved
+    emit damaged(QRect(QPoint(0, 0), _size));
+    if (_active) {
+        for (auto crIter = _celRefs.begin(); crIter != _celRefs.end(); crIter++)
+            (*crIter)->update();
+    }
 }
 
 
@@ -383,12 +431,43 @@ void PNGCel::resize(int x, int y, int width, int height) {
     least 1x1.  This is an overloaded function
 */
 void PNGCel::resize(QPoint topLeft, QSize size) {
-    // TODO it's undefined what will happen if x or y are negative.  figure out what
-    //      will happen.
     resize(topLeft.x(), topLeft.y(), size.width(), size.height());
 }
 
 
+/*!
+    Resizes the PNG Cel to \a size, keeping the image lined up with the \a anchor
+    edges.  E.g. with Qt::AlignRight | Qt::AlignBottom, the Cel is cropped/extended
+    on its top and left sides.  This is an overloaded function.
+*/
+void PNGCel::resize(QSize size, Qt::Alignment anchor) {
+    int dw = size.width() - _size.width();
+    int dh = size.height() - _size.height();
+
+    int x = 0, y = 0;
+    if (anchor & Qt::AlignRight)
+        x = dw;
+    else if (anchor & Qt::AlignHCenter)
+        x = dw / 2;
+
+    if (anchor & Qt::AlignBottom)
+        y = dh;
+    else if (anchor & Qt::AlignVCenter)
+        y = dh / 2;
+
+    resize(x, y, size.width(), size.height());
+}
+
+
+/*!
+    Overrides Cel::resize() so the pixels follow along, the image stays in the top
+    left corner.
+*/
+void PNGCel::resize(int width, int height) {
+    resize(0, 0, width, height);
+}
+
+
 /*!
     Small internal utility function to make a PNG image, and report an error if it wasn't successful.
     It will save a new blank PNG image to the _png directory
@@ -437,6 +516,7 @@ void PNGCel::_closePNG() {
 
         delete _png;
         _png = NULL;
+        _mips.clear();
     }
 }
 
@@ -23,7 +23,8 @@
 
 
 #include "animation/cel.h"
-class QImage;
+#include <QList>
+#include <QImage>
 
 
 class PNGCel : public Cel {
@@ -49,18 +50,23 @@ public:
     // A PNG Cel special
     QImage image();
     void setImage(QImage &image);
+    QImage *imageData();
+    void damage(QRect rect);
 
     // Cel Delection functions
     void remove(bool deletePNG=true);
     bool toBeRemoved();
 
     // Overloads
-    void paint(QPainter *painter);
+    void paint(QPainter *painter, const QRectF &exposed=QRectF());
 
     // sizing information
     // TODO add in simple width/height resizing
     void resize(int x, int y, int width, int height);
     void resize(QPoint topLeft, QSize size);
+    void resize(QSize size, Qt::Alignment anchor);
+    void resize(int width, int height);
+    using Cel::resize;
 
 
 private slots:
@@ -74,6 +80,8 @@ protected:
     QImage *_png = NULL;        // In the format of Premultiplied 32 Bit ARGB
     bool _deletePNG = false;    // To delete the PNG file upon PNGCel deletion
 
+    QList<QImage> _mips;        // Lazily generated mip levels of _png, index 0 is half size (see util::mipLevel())
+
     // Functions
     void _mkPNG();
 
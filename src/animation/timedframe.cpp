@@ -64,10 +64,14 @@ TimedFrame::~TimedFrame() {
 
 /*!
     Returns the starting Sequence number (Frame number) for this TimedFrame.
-    Should always be a positive integer.
+    Should always be a positive integer.  If this is in an XSheet, the XSheet
+    figures it out from the holds before this one.
 */
 int TimedFrame::seqNum() {
-    return _seqNum;
+    if (_xsheet && (_index >= 0))
+        return _xsheet->seqNumAt(_index, _plane);
+    else
+        return _seqNum;
 }
 
 
@@ -79,8 +83,9 @@ int TimedFrame::seqNum() {
     Returns true if so, false otherwise.
 */
 bool TimedFrame::hasSeqNum(int num) {
-    int upper = _seqNum + (_hold - 1);
-    return ((_seqNum <= num) && (num <= upper));
+    int first = seqNum();
+    int upper = first + (_hold - 1);
+    return ((first <= num) && (num <= upper));
 }
 
 
@@ -92,8 +97,9 @@ bool TimedFrame::hasSeqNum(int num) {
 QList<int> TimedFrame::seqNums() {
     // Tak on all of the numbers
     QList<int> nums;
-    int upper = _seqNum + (_hold - 1);
-    for (int i = _seqNum; i <= upper; i++)
+    int first = seqNum();
+    int upper = first + (_hold - 1);
+    for (int i = first; i <= upper; i++)
         nums.append(i);
 
     return nums;
@@ -136,7 +142,50 @@ void TimedFrame::setXSheet(XSheet *xsheet) {
 
 
 /*!
-    Tries to get the TimedFrame that is in the XSheet before this one.
+    Sets where this TimedFrame is in its XSheet's list of frames, -1 means it
+    isn't in one.  Normally only called by the XSheet.
+
+    \sa index()
+*/
+void TimedFrame::setIndex(int index) {
+    _index = index;
+}
+
+
+/*!
+    Returns where this TimedFrame is in its XSheet's list of frames, or -1 if
+    it isn't in one.
+
+    \sa setIndex()
+*/
+int TimedFrame::index() {
+    return _index;
+}
+
+
+/*!
+    Sets which plane of the XSheet this TimedFrame is in.  Normally only called
+    by the XSheet.
+
+    \sa plane()
+*/
+void TimedFrame::setPlane(int plane) {
+    _plane = plane;
+}
+
+
+/*!
+    Returns which plane of the XSheet this TimedFrame is in.
+
+    \sa setPlane()
+*/
+int TimedFrame::plane() {
+    return _plane;
+}
+
+
+/*!
+    Tries to get the TimedFrame that is in the XSheet (on the same plane) before this one.
     Will return NULL if no XSheet is set.  If there is no TimeFrame before this
     one then NULL will be returned.
     
@@ -154,8 +203,8 @@ TimedFrame *TimedFrame::before(bool loop) {
         return NULL;
 
     // Seq num before
-    int numBefore = _seqNum - 1;
-    TimedFrame *tf = _xsheet->frameAtSeq(numBefore);
+    int numBefore = seqNum() - 1;
+    TimedFrame *tf = _xsheet->frameAtSeq(numBefore, _plane);
 
     // Could either be NULL or something
     if (!loop || tf)
@@ -163,16 +212,16 @@ TimedFrame *TimedFrame::before(bool loop) {
 
     // Loop around
     // Only frame in the XSheet?  Just return NULL
-    if (_xsheet->numFrames() == 1)
+    if (_xsheet->numFrames(_plane) == 1)
         return NULL;
 
     // Else there must be something there at the end, grab it
-    return _xsheet->frames().last();
+    return _xsheet->frames(_plane).last();
 }
 
 
 /*!
-    Tries to get the TimedFrame that is in the XSheet after this one.
+    Tries to get the TimedFrame that is in the XSheet (on the same plane) after this one.
     Will return NULL if no XSheet is set.  If there is no TimeFrame after this
     one then NULL will be returned.
     
@@ -190,8 +239,8 @@ TimedFrame *TimedFrame::after(bool loop) {
         return NULL;
 
     // Seq num after
-    int numAfter = _seqNum + _hold;
-    TimedFrame *tf = _xsheet->frameAtSeq(numAfter);
+    int numAfter = seqNum() + _hold;
+    TimedFrame *tf = _xsheet->frameAtSeq(numAfter, _plane);
 
     // Could either be NULL or something
     if (!loop || tf)
@@ -199,17 +248,19 @@ TimedFrame *TimedFrame::after(bool loop) {
 
     // Loop around
     // Only frame in the XSheet?  Just return NULL
-    if (_xsheet->numFrames() == 1)
+    if (_xsheet->numFrames(_plane) == 1)
         return NULL;
 
     // Else there must be something there at the end, grab it
-    return _xsheet->frames().first();
+    return _xsheet->frames(_plane).first();
 }
 
 
 /*!
     Set the staring sequence number (or frame number) for this TimedFrame.
     \a num must be a positive integer.  If it is not, then nothing will happen.
+    Once the TimedFrame is in an XSheet this doesn't do anything useful, the
+    XSheet decides the sequence number.
 
     Will emit the 'seqNumChanged()' signal upon success.
 */
@@ -36,6 +36,10 @@ public:
 
     // XSheet
     void setXSheet(XSheet *xsheet);            // Should only be called by XSheet::addFrame()
+    void setIndex(int index);                // Should only be called by the XSheet
+    int index();
+    void setPlane(int plane);                // Should only be called by the XSheet
+    int plane();
     TimedFrame *before(bool loop=false);
     TimedFrame *after(bool loop=false);
 
@@ -54,7 +58,9 @@ private:
     // Member vars
     QPointer<XSheet> _xsheet;    // Pointer to the XSheet object this TimedFrame is a part of
     QPointer<Frame> _frame;        // Pointer to Frame object this TimedFrame uses
-    int _seqNum = 1;            // sequence number; where in the XSheet this frame begins, is a positive integer
+    int _seqNum = 1;            // sequence number; where in the XSheet this frame begins, is a positive integer (only used when not in an XSheet)
+    int _index = -1;            // Index in the XSheet's plane, -1 if not in one
+    int _plane = 0;                // Which plane of the XSheet this is in
     int _hold = 1;                // How many frames to hold this one out for, is a positive integer
 
 };
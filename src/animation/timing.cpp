@@ -0,0 +1,122 @@
+// File:         timing.cpp
+// Author:       Ben Summerton (define-private-public)
+// Description:  Implementation of the Timing functions.
+
+
+// All of these make a new list of TimedFrames (that use the same Frames as the ones they're
+// given), and leave the old ones alone.  That way the old list can be put back for an undo.
+// Each one goes over the list once.
+
+
+#include "animation/timing.h"
+#include "animation/timedframe.h"
+#include "animation/frame.h"
+#include <QtMath>
+
+
+/*!
+    Returns a copy of \a frames where every one is held for \a hold (which is at least 1).
+*/
+QList<TimedFrame *> Timing::setHolds(const QList<TimedFrame *> &frames, int hold) {
+    QList<TimedFrame *> list;
+    list.reserve(frames.size());
+    for (auto iter = frames.begin(); iter != frames.end(); iter++)
+        list.append(new TimedFrame((*iter)->frame(), TIMED_FRAME_DEFAULT_SEQ_NUM, qMax(hold, 1)));
+
+    return list;
+}
+
+
+/*!
+    Returns a copy of \a frames with the holds multiplied by \a factor.  Where each frame
+    starts is rounded (instead of each hold), so the rounding doesn't add up over a long
+    range.  No hold goes below 1 though.
+*/
+QList<TimedFrame *> Timing::scaleHolds(const QList<TimedFrame *> &frames, double factor) {
+    QList<TimedFrame *> list;
+    list.reserve(frames.size());
+
+    int length = 0;            // Unscaled, up to (and including) the current frame
+    int scaled = 0;            // Scaled length of what's been put in the list
+    for (auto iter = frames.begin(); iter != frames.end(); iter++) {
+        length += (*iter)->hold();
+        int hold = qMax(qRound(length * factor) - scaled, 1);
+        scaled += hold;
+        list.append(new TimedFrame((*iter)->frame(), TIMED_FRAME_DEFAULT_SEQ_NUM, hold));
+    }
+
+    return list;
+}
+
+
+/*!
+    Returns a copy of \a frames that's in the reverse order.  Holds stay with their frames.
+*/
+QList<TimedFrame *> Timing::reverse(const QList<TimedFrame *> &frames) {
+    QList<TimedFrame *> list;
+    list.reserve(frames.size());
+    for (int i = frames.size() - 1; i >= 0; i--)
+        list.append(new TimedFrame(frames.at(i)->frame(), TIMED_FRAME_DEFAULT_SEQ_NUM, frames.at(i)->hold()));
+
+    return list;
+}
+
+
+/*!
+    Returns a copy of \a frames that plays forwards, then backwards.  The ends aren't
+    doubled up, so A B C turns into A B C B (when looped it goes back to A).
+*/
+QList<TimedFrame *> Timing::pingPong(const QList<TimedFrame *> &frames) {
+    QList<TimedFrame *> list;
+    list.reserve(qMax(frames.size() * 2 - 2, frames.size()));
+    for (auto iter = frames.begin(); iter != frames.end(); iter++)
+        list.append(new TimedFrame((*iter)->frame(), TIMED_FRAME_DEFAULT_SEQ_NUM, (*iter)->hold()));
+    for (int i = frames.size() - 2; i > 0; i--)
+        list.append(new TimedFrame(frames.at(i)->frame(), TIMED_FRAME_DEFAULT_SEQ_NUM, frames.at(i)->hold()));
+
+    return list;
+}
+
+
+/*!
+    Returns a copy of \a frames that's been rotated by \a by places.  A positive number
+    moves them towards the end (the last ones wrap around to the front), negative towards
+    the beginning.  Shifting a range is rotating it along with its neighbours.
+*/
+QList<TimedFrame *> Timing::rotate(const QList<TimedFrame *> &frames, int by) {
+    QList<TimedFrame *> list;
+    int n = frames.size();
+    if (n == 0)
+        return list;
+
+    list.reserve(n);
+    int start = ((-by % n) + n) % n;
+    for (int i = 0; i < n; i++) {
+        TimedFrame *tf = frames.at((start + i) % n);
+        list.append(new TimedFrame(tf->frame(), TIMED_FRAME_DEFAULT_SEQ_NUM, tf->hold()));
+    }
+
+    return list;
+}
+
+
+/*!
+    Returns a copy of \a frames where a run of TimedFrames that use the same Frame are turned
+    into one, that's held for all of their holds added up.
+*/
+QList<TimedFrame *> Timing::collapse(const QList<TimedFrame *> &frames) {
+    QList<TimedFrame *> list;
+    Frame *last = NULL;
+    for (auto iter = frames.begin(); iter != frames.end(); iter++) {
+        Frame *frame = (*iter)->frame();
+        if (!list.isEmpty() && (frame == last))
+            list.last()->setHold(list.last()->hold() + (*iter)->hold());
+        else
+            list.append(new TimedFrame(frame, TIMED_FRAME_DEFAULT_SEQ_NUM, (*iter)->hold()));
+
+        last = frame;
+    }
+
+    return list;
+}
+
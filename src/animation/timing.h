@@ -0,0 +1,26 @@
+// File:         timing.h
+// Author:       Ben Summerton (define-private-public)
+// Description:  Timing is a set of functions that retime a run of TimedFrames (e.g. scaling the holds,
+//               or reversing them).  They're used with XSheet::replaceFrames() to edit a range at once.
+
+
+#ifndef TIMING_H
+#define TIMING_H
+
+
+class TimedFrame;
+#include <QList>
+
+
+namespace Timing {
+    QList<TimedFrame *> setHolds(const QList<TimedFrame *> &frames, int hold);
+    QList<TimedFrame *> scaleHolds(const QList<TimedFrame *> &frames, double factor);
+    QList<TimedFrame *> reverse(const QList<TimedFrame *> &frames);
+    QList<TimedFrame *> pingPong(const QList<TimedFrame *> &frames);
+    QList<TimedFrame *> rotate(const QList<TimedFrame *> &frames, int by);
+    QList<TimedFrame *> collapse(const QList<TimedFrame *> &frames);
+}
+
+
+#endif // TIMING_H
+
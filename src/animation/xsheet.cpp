@@ -20,6 +20,24 @@
     An XSheet can also be considered Null, this means that it doesn't have any frames in it.  By
     this definition, a newly created XSheet will be Null until some frames are added to it.
     
+    An XSheet has one or more planes (e.g. a background, a character and an FX plane).  Each
+    plane is its own list of TimedFrames with its own timing, and they're drawn in order, the
+    first plane at the bottom.  The sequence length of the XSheet is the length of its longest
+    plane.  All of the Frame operators take a plane number, which is the first plane by default.
+
+    Sequence numbers aren't stored in each TimedFrame, only the holds are.  They're kept in a
+    Fenwick tree (per plane), so the sequence number of a frame is a prefix sum of the holds
+    before it, and finding the frame at a sequence number is a walk down the tree.  Changing a
+    hold is one O(log n) update no matter where the frame is, and the XSheet emits a single
+    seqNumsChanged() for the range of frames that moved instead of a signal from every one.
+
+    Bulk edits (e.g. adding a few hundred frames) should be wrapped in beginChanges() and
+    commitChanges().  In between, the XSheet still changes right away, but the signals about
+    it are held back.  At the commit, one seqNumsChanged() is sent for each plane that was
+    changed, one seqLegnthChanged() (if it's different), and then changesCommitted().  The
+    frameAdded(), frameRemoved() and frameMoved() signals are not sent at all for a batch, so
+    anything that depends on those should also check over things on changesCommitted().
+
     The "_seqMap" variable doesn't exist anymore, but it may be reintroduced on a later date.
     I'm still leaving this documentation in here since it expalins a bit how frame numbers and holds
     work for ordering in the XSheet
@@ -47,11 +65,15 @@
 #include "animation/animation.h"
 #include "animation/frame.h"
 #include "animation/timedframe.h"
+#include "util.h"
+#include <QSet>
+#include <QPainter>
 #include <QDebug>
 
 
 /*!
-    Constrcuts a new Null XSheet.  XSheet will be Null unless you add a Frame to it.
+    Constrcuts a new Null XSheet, with one plane.  XSheet will be Null unless you add a Frame
+    to it.
 
     \sa isNull()
 */
@@ -60,8 +82,8 @@ XSheet::XSheet(Animation *anim, int fps) :
 {
     setFPS(fps);
 
-    // Append the initial layer
-    _frames.append(QList<QPointer<TimedFrame>>());
+    // Append the initial plane
+    addPlane();
 
     // Info
     qDebug() << "[XSheet created]" << this;
@@ -73,27 +95,19 @@ XSheet::XSheet(Animation *anim, int fps) :
 */
 XSheet::~XSheet() {
     // Clear out all of the TimedFrames
-    // TODO call _frames.clear() instead?
-    auto lIter = _frames.begin();
-    while (lIter != _frames.end()) {
-        auto tfIter = lIter->begin();
-
-        while (tfIter != lIter->end()) {
+    for (auto pIter = _planes.begin(); pIter != _planes.end(); pIter++) {
+        for (auto tfIter = pIter->frames.begin(); tfIter != pIter->frames.end(); tfIter++)
             delete *tfIter;
-            tfIter++;
-        }
-        lIter->clear();
-        lIter++;
     }
-    _frames.clear();
+    _planes.clear();
 
     qDebug() << "[XSheet deleted]" << this;
 }
 
 
 /*!
-    The XSheet is considered Empty if there are no frames in the list (which also means the sequence
-    length is zero).
+    The XSheet is considered Empty if there are no frames in any of the planes (which also means
+    the sequence length is zero).
 
     \sa seqLength()
 */
@@ -103,22 +117,94 @@ bool XSheet::isEmpty() {
 
 
 /*!
-    Returns the number of Frame objects contained in the XSheet.
+    Returns the number of planes in the XSheet.  There is always at least one.
+
+    \sa addPlane()
+*/
+int XSheet::numPlanes() {
+    return _planes.size();
+}
+
+
+/*!
+    Adds a new (empty) plane on top of the others.  If \a name is empty, one will be made up.
+    Returns the number of the new plane.
+
+    Emits planeAdded()
 */
-int XSheet::numFrames() {
-    QList<QPointer<TimedFrame>> &firstPlane = _frames[0];
-    return firstPlane.size();
+int XSheet::addPlane(QString name) {
+    _Plane plane;
+    plane.name = name.isEmpty() ? tr("Plane %1").arg(_planes.size() + 1) : name;
+    plane.holdTree.append(0);        // Tree is one-indexed
+    _planes.append(plane);
+
+    int num = _planes.size() - 1;
+    emit planeAdded(num);
+    return num;
 }
 
 
 /*!
-    Returns the sequence length of the XSheet.
+    Returns the name of \a plane, or an empty string if there is no such plane.
+
+    \sa setPlaneName()
+*/
+QString XSheet::planeName(int plane) {
+    if (!_isValidPlane(plane))
+        return QString();
+
+    return _planes[plane].name;
+}
+
+
+/*!
+    Sets the name of \a plane.
+
+    Emits planeNameChanged()
+*/
+void XSheet::setPlaneName(int plane, QString name) {
+    if (!_isValidPlane(plane) || (_planes[plane].name == name))
+        return;
+
+    _planes[plane].name = name;
+    emit planeNameChanged(plane, name);
+}
+
+
+/*!
+    Returns the number of Frame objects contained in \a plane.
+*/
+int XSheet::numFrames(int plane) {
+    if (!_isValidPlane(plane))
+        return 0;
+
+    return _planes[plane].frames.size();
+}
+
+
+/*!
+    Returns the sequence length of the XSheet, which is the length of the longest plane.
+
+    \sa planeLength()
 */
 int XSheet::seqLength() {
     return _seqLength;
 }
 
 
+/*!
+    Returns how long \a plane is (its holds added up).
+
+    \sa seqLength()
+*/
+int XSheet::planeLength(int plane) {
+    if (!_isValidPlane(plane))
+        return 0;
+
+    return _planes[plane].seqLength;
+}
+
+
 /*!
     Returns the framerate of the XSheet.
 
@@ -151,42 +237,116 @@ void XSheet::setFPS(int fps) {
 
 
 /*!
-    Return the pointers to the Frames in a QList.
+    Return the pointers to the Frames of \a plane in a QList.
 
     \sa frameAtSeq()
 */
-QList<QPointer<TimedFrame>> XSheet::frames() {
-    QList<QPointer<TimedFrame>> &firstPlane = _frames[0];
+QList<QPointer<TimedFrame>> XSheet::frames(int plane) {
+    if (!_isValidPlane(plane))
+        return QList<QPointer<TimedFrame>>();
 
-    return firstPlane;
+    return _planes[plane].frames;
 }
 
 
 /*!
-    Returns a pointer to a frame by sequence number.  If the frame isn't found, it will return a
-    NULL QPointer
+    Returns the frame at \a index (not the sequence number) of \a plane, or a NULL QPointer if
+    there isn't one.  Unlike frames(), this doesn't make a copy of the list, so holding onto
+    one won't make the XSheet copy it the next time it's changed.
+
+    \sa numFrames()
+*/
+QPointer<TimedFrame> XSheet::frameAt(int index, int plane) {
+    if (!_isValidPlane(plane))
+        return NULL;
+
+    const _Plane &p = _planes.at(plane);
+    if ((index < 0) || (index >= p.frames.size()))
+        return NULL;
+
+    return p.frames.at(index);
+}
+
+
+/*!
+    Returns a pointer to a frame in \a plane by sequence number.  If the frame isn't found, it
+    will return a NULL QPointer.  This is a O(log n) search, so it's fine to call on every
+    playback tick.
     
     \sa frames()
+    \sa framesAtSeq()
 */
-QPointer<TimedFrame> XSheet::frameAtSeq(int num) {
-    QList<QPointer<TimedFrame>> &firstPlane = _frames[0];
+QPointer<TimedFrame> XSheet::frameAtSeq(int num, int plane) {
+    if (!_isValidPlane(plane))
+        return NULL;
+
+    const _Plane &p = _planes.at(plane);
+    int index = _indexAtSeq(p, num);
+    if (index == -1)
+        return NULL;
+    else
+        return p.frames.at(index);
+}
+
+
+/*!
+    Returns what's showing in each plane at sequence number \a num, the first plane first.
+    A plane that's shorter than \a num has a NULL QPointer in its spot.
+
+    \sa frameAtSeq()
+*/
+QList<QPointer<TimedFrame>> XSheet::framesAtSeq(int num) {
+    QList<QPointer<TimedFrame>> found;
+    for (int i = 0; i < _planes.size(); i++)
+        found.append(frameAtSeq(num, i));
+
+    return found;
+}
+
 
-    // Iterator throught the _frames list till we find that one special Frame
-    auto flIter = firstPlane.begin();
-    while (flIter != firstPlane.end()) {
-        if ((*flIter)->hasSeqNum(num))
-            return *flIter;
+/*!
+    Renders what's showing at sequence number \a num, with all of the planes composited
+    together (the first plane at the bottom).  The image is the Animation's frame size.  Planes
+    that are shorter than \a num are left out.  If there is no Animation, a Null QImage is
+    returned.
 
-        flIter++;
+    \sa framesAtSeq(), Frame::render()
+*/
+QImage XSheet::render(int num) {
+    if (!_anim)
+        return QImage();
+
+    QImage img = util::mkBlankImage(_anim->frameSize());
+    if (img.isNull())
+        return img;
+
+    QPainter p(&img);
+    QList<QPointer<TimedFrame>> showing = framesAtSeq(num);
+    for (auto iter = showing.begin(); iter != showing.end(); iter++) {
+        TimedFrame *tf = *iter;
+        if (tf && tf->frame())
+            p.drawImage(0, 0, tf->frame()->render());
     }
 
-    // didn't find it, return an empty QPointer
-    return NULL;
+    return img;
 }
 
 
 /*!
-    Adds a frame to the XSheet by Seqence number
+    Returns the sequence number that the frame at \a index in \a plane starts at.  This is the
+    sum of the holds before it, plus one.  If \a index is the number of frames, it's where the
+    next appended frame would start.  Used by TimedFrame::seqNum().
+*/
+int XSheet::seqNumAt(int index, int plane) {
+    if (!_isValidPlane(plane))
+        return 1;
+
+    return _seqNumAt(_planes[plane], index);
+}
+
+
+/*!
+    Adds a frame to \a plane of the XSheet by Seqence number
     We assume that the hold is set, but the it's sequence number will be modified.
     
     If `at` is not set to End, it will try to insert it at the frame, but it doesn't always
@@ -204,7 +364,7 @@ QPointer<TimedFrame> XSheet::frameAtSeq(int num) {
     
     Think that it will add/insert it at the nearest frame to the left
 
-    Emits the frameAdded() and seqLegnthChanged() signals
+    Emits the frameAdded(), seqNumsChanged() and seqLegnthChanged() signals
 
     \sa frames()
     \sa frameAtSeq()
@@ -212,57 +372,46 @@ QPointer<TimedFrame> XSheet::frameAtSeq(int num) {
     \sa moveFrame()
     \sa frameAdded()
 */
-void XSheet::addFrame(TimedFrame *frame, int at) {
-    QList<QPointer<TimedFrame>> &firstPlane = _frames[0];
+void XSheet::addFrame(TimedFrame *frame, int at, int plane) {
+    if (!_isValidPlane(plane))
+        return;
+
+    _Plane &p = _planes[plane];
     int frameIndex = -1;
 
-    if ((at == XSHEET_END) || (at > _seqLength)) {
-        // Append, there'll be no collisions
-        frame->setSeqNum(_seqLength + 1);
+    if ((at == XSHEET_END) || (at > p.seqLength)) {
+        // Append, there'll be no collisions (and nothing else needs to be renumbered)
         frame->setXSheet(this);
-        firstPlane.append(frame);
-        frameIndex = firstPlane.size() - 1;
+        p.frames.append(frame);
+        frameIndex = p.frames.size() - 1;
+        _appendHold(p, plane);
     } else if (at < 1) {
         // Not a good value for at supplied, print a debug message and don't change a thing
         qDebug() << "[XSheet addFrame " << this << "] at=" << at << ", must be a postitive integer or XSHEET_END";
         return;
     } else {
-        // Insert the TimedFrame into the middle or the beginning
-        auto flIter = firstPlane.begin();
-        TimedFrame *cursor = NULL;
-        frameIndex = 0;
-
-        while (flIter != firstPlane.end()) {
-            cursor = *flIter;
-
-            // Check for a location
-            if (cursor->hasSeqNum(at)) {
-                // Found where to insert
-                frame->setSeqNum(cursor->seqNum());            // Take ownership of cursor's number
-                frame->setXSheet(this);
-                firstPlane.insert(frameIndex, frame);
-                break;
-            }
-
-            frameIndex++;
-            flIter++;
-        }
-
+        // Insert the TimedFrame into the middle or the beginning, takes the spot of what's there
+        frameIndex = _indexAtSeq(p, at);
+        frame->setXSheet(this);
+        p.frames.insert(frameIndex, frame);
+        _rebuildHolds(p, plane, frameIndex);
     }
 
-    // last minute things: adjust seq length, add a slot, and emit a signal
+    // last minute things: add a slot, and emit some signals
     connect(frame, &TimedFrame::holdChanged, this, &XSheet::_onHoldChanged);
-    _updateSeqNums(frameIndex);
-    emit frameAdded(frame);
-    emit seqLegnthChanged(seqLength());
+    _updateSeqLength();
+    if (!changing())
+        emit frameAdded(frame);
+    _seqNumsChanged(plane, frameIndex, p.frames.size() - 1);
+    _seqLengthChanged();
 }
 
 
 /*!
-    Removes a frame from the XSheet by sequence number, will return a pointer to a Frame.  It
-    might be a Null frame, or a Frame that was in the XSheet.
+    Removes a frame from \a plane of the XSheet by sequence number, will return a pointer to a
+    Frame.  It might be a Null frame, or a Frame that was in the XSheet.
     
-    Emits the frameRemoved() and seqLegnthChanged() signals
+    Emits the frameRemoved(), seqNumsChanged() and seqLegnthChanged() signals
 
     \sa frames()
     \sa frameAtSeq()
@@ -270,73 +419,54 @@ void XSheet::addFrame(TimedFrame *frame, int at) {
     \sa moveFrame()
     \sa frameRemoved()
 */
-QPointer<TimedFrame> XSheet::removeFrame(int at) {
-    QList<QPointer<TimedFrame>> &firstPlane = _frames[0];
+QPointer<TimedFrame> XSheet::removeFrame(int at, int plane) {
     QPointer<TimedFrame> frame;
+    if (!_isValidPlane(plane))
+        return frame;
+
+    _Plane &p = _planes[plane];
     int frameIndex = -1;
 
-    // Remove it from the correct spot
-    if (firstPlane.size() == 0) {
-        qDebug() << "[XSheet removeFrame " << this << "] There are no fraems in the XSheet right now.";
+    // Find the spot
+    if (p.frames.size() == 0) {
+        qDebug() << "[XSheet removeFrame " << this << "] There are no fraems in the plane right now.";
         return frame;
-    } else if ((at > _seqLength) || (at == 0) || (at <= -2)) {
+    } else if ((at > p.seqLength) || (at == 0) || (at <= -2)) {
         // out of bounds
-        qDebug() << "[XSheet removeFrame " << this << "] at=" << at << ", must be between 1 or " << _seqLength << " (inclusive)";
+        qDebug() << "[XSheet removeFrame " << this << "] at=" << at << ", must be between 1 or " << p.seqLength << " (inclusive)";
         return frame;
-    } else if ((at == XSHEET_END) || firstPlane.last()->hasSeqNum(at)) {
-        // Pop it off of the end, don't need to update any frame numbers
-        frame = firstPlane.takeLast();
-        frameIndex = firstPlane.size() - 1;
-    } else {
-        // Removing the frame from the middle or the beginning
-        auto flIter = firstPlane.begin();
-        TimedFrame *cursor = NULL;
-        frameIndex = 0;
-
-        while (flIter != firstPlane.end()) {
-            cursor = *flIter;
-
-            // Check for a locaiton
-            if (cursor->hasSeqNum(at)) {
-                // Found where to insert
-                frame = firstPlane.takeAt(frameIndex);            // Take the frame out
-                firstPlane[frameIndex]->setSeqNum(frame->seqNum());    // Take ownership of frame number
-                break;
-            }
-
-            frameIndex++;
-            flIter++;
-        }
-
-//        while (iter.hasNext()) {
-//            cursor = iter.next();
-//
-//            // Check for a locaiton
-//            if (cursor->hasSeqNum(at)) {
-//                // Found where to insert
-//                delete frame;                                // Delete the temporary Null Frame
-//                frame = firstPlane.takeAt(frameIndex);            // Take the frame out
-//                firstPlane[frameIndex]->setSeqNum(frame->seqNum());    // Take ownership of frame number
-//                break;
-//            }
-//
-//            frameIndex++;
-//        }
-    }
+    } else if (at == XSHEET_END)
+        frameIndex = p.frames.size() - 1;
+    else
+        frameIndex = _indexAtSeq(p, at);
+
+    // Take it out, it keeps the sequence number it had (nothing will find it by index anymore)
+    int seqNum = _seqNumAt(p, frameIndex);
+    frame = p.frames.takeAt(frameIndex);
+    frame->setIndex(-1);
+    frame->setSeqNum(seqNum);
+
+    // Popping off the end doesn't renumber anything
+    if (frameIndex == p.frames.size())
+        _removeLastHold(p);
+    else
+        _rebuildHolds(p, plane, frameIndex);
 
     // do a disconnect
     disconnect(frame, 0, this, 0);
 
     // Update other properties
-    _updateSeqNums(frameIndex);
-    emit frameRemoved(frame);
-    emit seqLegnthChanged(seqLength());
+    _updateSeqLength();
+    if (!changing())
+        emit frameRemoved(frame);
+    _seqNumsChanged(plane, frameIndex, p.frames.size() - 1);
+    _seqLengthChanged();
     return frame;
 }
 
 
 /*!
-    Moves a frme from one location to another by sequence number.
+    Moves a frme from one location to another (in the same plane) by sequence number.
     It will grab the frame that has the sequence number of at then place it infront of (or at) to.
 
     \sa frames()
@@ -345,104 +475,349 @@ QPointer<TimedFrame> XSheet::removeFrame(int at) {
     \sa removeFrame()
     \sa frameMoved()
 */
-void XSheet::moveFrame(int at, int to) {
-    QList<QPointer<TimedFrame>> &firstPlane = _frames[0];
+void XSheet::moveFrame(int at, int to, int plane) {
+    if (!_isValidPlane(plane))
+        return;
+
+    _Plane &p = _planes[plane];
 
     // Fist check bounds
-    if ((at < 1) or (at > _seqLength)) {
-        qDebug() << "[XSheet moveFrame " << this << "] at=" << at << ", must be between 1 or the sequence's length (" << _seqLength << ")";
+    if ((at < 1) or (at > p.seqLength)) {
+        qDebug() << "[XSheet moveFrame " << this << "] at=" << at << ", must be between 1 or the plane's length (" << p.seqLength << ")";
         return;
-    } else if ((to < 1) or (to > _seqLength)) {
-        qDebug() << "[XSheet moveFrame " << this << "] to=" << to << ", must be between 1 or the sequence's length (" << _seqLength << ")";
+    } else if ((to < 1) or (to > p.seqLength)) {
+        qDebug() << "[XSheet moveFrame " << this << "] to=" << to << ", must be between 1 or the plane's length (" << p.seqLength << ")";
         return;
     }
     
-    // Bounds are okay, do the swap
-    int indexAt = -1, indexTo = -1;
-
-    // Loop throught all of the frames until we get both indices
-    TimedFrame *frame = NULL;
-    for (int i = 0; i < firstPlane.size(); i++) {
-        frame = firstPlane[i];
-
-        // Check for sequence numbers
-        if (frame->hasSeqNum(at))
-            indexAt = i;
-        if (frame->hasSeqNum(to))
-            indexTo = i;
-        
-        // Break if both found
-        if ((indexAt != -1) && (indexTo != -1))
-            break;
-    }
+    // Bounds are okay, look up both indices
+    int indexAt = _indexAtSeq(p, at);
+    int indexTo = _indexAtSeq(p, to);
 
     // Samies?  Just return
     if (indexAt == indexTo)
         return;
     
     // Make the move
-    TimedFrame *a = firstPlane[indexAt];
-    TimedFrame *b = firstPlane[indexTo];
-    firstPlane.move(indexAt, indexTo);
+    TimedFrame *a = p.frames[indexAt];
+    p.frames.move(indexAt, indexTo);
+
+    // Only what's between the two spots gets renumbered
+    int first = qMin(indexAt, indexTo);
+    int last = qMax(indexAt, indexTo);
+    _rebuildHolds(p, plane, first);
+
+    // And lastly emit the signals
+    if (!changing())
+        emit frameMoved(a);
+    _seqNumsChanged(plane, first, last);
+}
 
-    // update the sequence numbers (look at the one in the lower position)
-    int pivot = qMin(indexAt, indexTo);
-    TimedFrame *dispFrame = (pivot == indexAt) ? a : b;
-    firstPlane[pivot]->setSeqNum(dispFrame->seqNum());
-    _updateSeqNums(pivot);
 
-    // And lastly emit a signal
-    emit frameMoved(a);
-} 
+/*!
+    Takes out the \a count frames of \a plane starting at \a index, and puts \a frames in
+    their place.  It's for bulk edits of a range (e.g. reversing it): the list is put together
+    and the holds are rebuilt just once, so it's O(n) no matter how many frames change.  The
+    frames that were taken out (and aren't in \a frames) are returned, it's up to the caller
+    to delete them.
+
+    It's done as a batch (see beginChanges()), so there's no frameAdded() or frameRemoved()
+    for each frame.
+
+    \sa addFrame()
+    \sa removeFrame()
+*/
+QList<TimedFrame *> XSheet::replaceFrames(int index, int count, QList<TimedFrame *> frames, int plane) {
+    QList<TimedFrame *> removed;
+    if (!_isValidPlane(plane))
+        return removed;
+
+    _Plane &p = _planes[plane];
+    if ((index < 0) || (count < 0) || ((index + count) > p.frames.size())) {
+        qDebug() << "[XSheet replaceFrames " << this << "] index=" << index << ", count=" << count << " isn't in the plane";
+        return removed;
+    }
+
+    beginChanges();
+
+    // Take the old ones out, they keep the sequence numbers they had
+    QSet<TimedFrame *> kept = QSet<TimedFrame *>::fromList(frames);
+    int seqNum = _seqNumAt(p, index);
+    for (int i = index; i < (index + count); i++) {
+        TimedFrame *frame = p.frames.at(i);
+        int hold = p.holds[i];
+        if (!kept.contains(frame)) {
+            disconnect(frame, 0, this, 0);
+            frame->setIndex(-1);
+            frame->setSeqNum(seqNum);
+            removed.append(frame);
+        }
+        seqNum += hold;
+    }
+
+    // And the new ones in
+    QList<QPointer<TimedFrame>> list = p.frames.mid(0, index);
+    list.reserve(p.frames.size() - count + frames.size());
+    for (auto iter = frames.begin(); iter != frames.end(); iter++) {
+        TimedFrame *frame = *iter;
+        frame->setXSheet(this);
+        connect(frame, &TimedFrame::holdChanged, this, &XSheet::_onHoldChanged, Qt::UniqueConnection);
+        list.append(frame);
+    }
+    list.append(p.frames.mid(index + count));
+    p.frames = list;
+
+    _rebuildHolds(p, plane, index);
+    _updateSeqLength();
+    _seqNumsChanged(plane, index, p.frames.size() - 1);
+    _seqLengthChanged();
+
+    commitChanges();
+    return removed;
+}
 
 
 /*!
-    When a frame's hold value is changed, this slot will be called to update all of the sequence
-    nums of all subsequent frames in the _frames list.  frame is guarenteed to be in _frames.
+    Starts a batch of changes.  Until commitChanges() is called, the XSheet is still changed
+    right away (and can be looked at), but the signals about it are held back.  Batches can be
+    nested, only the outermost commitChanges() sends the signals.
+
+    \sa commitChanges()
+    \sa changesCommitted()
+*/
+void XSheet::beginChanges() {
+    if (_changeDepth == 0)
+        _seqLengthBefore = _seqLength;
+
+    _changeDepth++;
+}
 
-    Emits the seqLegnthChanged() signal.
 
-    \sa seqNumsChanged()
+/*!
+    Ends a batch of changes started by beginChanges().  If it's the outermost one, a single
+    seqNumsChanged() is emitted for each plane that changed (from the first frame that moved
+    to the end of the plane, which may be an empty range if frames were only taken off of the
+    end), then seqLegnthChanged() if the length is different, and lastly changesCommitted()
+    (that one is always sent).
+
+    \sa beginChanges()
 */
-void XSheet::_onHoldChanged(int hold) {
-    QList<QPointer<TimedFrame>> &firstPlane = _frames[0];
+void XSheet::commitChanges() {
+    if (_changeDepth == 0) {
+        qDebug() << "[XSheet commitChanges " << this << "] No batch was started";
+        return;
+    }
+
+    _changeDepth--;
+    if (_changeDepth > 0)
+        return;
+
+    // Take them first, a slot might start another batch
+    QMap<int, int> planes = _changedPlanes;
+    _changedPlanes.clear();
 
+    for (auto iter = planes.begin(); iter != planes.end(); iter++) {
+        int last = _planes[iter.key()].frames.size() - 1;
+        emit seqNumsChanged(iter.key(), qMin(iter.value(), last + 1), last);
+    }
+
+    if (_seqLength != _seqLengthBefore)
+        emit seqLegnthChanged(_seqLength);
+
+    emit changesCommitted();
+}
+
+
+/*!
+    Returns true if a batch of changes has been started, and not committed yet.
+
+    \sa beginChanges()
+*/
+bool XSheet::changing() {
+    return _changeDepth > 0;
+}
+
+
+/*!
+    When a frame's hold value is changed, this slot will be called to adjust the hold in its
+    plane's tree.  The sequence numbers of all subsequent frames will have changed, but since
+    they're figured out on demand, this is just one update (O(log n)) and one seqNumsChanged()
+    signal.  frame is guarenteed to be in the XSheet.
+
+    Emits the seqNumsChanged() and seqLegnthChanged() signals.
+*/
+void XSheet::_onHoldChanged(int hold) {
     TimedFrame *frame = (TimedFrame *)sender();
-    _updateSeqNums(firstPlane.indexOf(frame));
+    int plane = frame->plane();
+    int index = frame->index();
+    _Plane &p = _planes[plane];
+
+    int delta = hold - p.holds[index];
+    _addToHold(p, index, delta);
+    p.holds[index] = hold;
+    p.seqLength += delta;
+    _updateSeqLength();
+
+    _seqNumsChanged(plane, index, p.frames.size() - 1);
+    _seqLengthChanged();
+}
 
-    emit seqLegnthChanged(seqLength());
+
+/*!
+    Internal function.  Returns true if \a plane is a plane of the XSheet, prints a debug message
+    if not.
+*/
+bool XSheet::_isValidPlane(int plane) {
+    if ((plane >= 0) && (plane < _planes.size()))
+        return true;
+
+    qDebug() << "[XSheet " << this << "] plane=" << plane << ", there are only " << _planes.size() << " planes";
+    return false;
 }
 
 
 /*!
-    Will go through each frame in the list and adjust its sequence number
-    If you don't supply a value for at, by default, it will go through the whole list
-    else.  at in this case is an index [0, numFrames], not a sequence number.
-    
-    The frame at Index at should also have it's number correctly set.  So for instance,
-    if we have at=0, then the first frame's seq number should be 1, else, it can cause
-    some problems.
-    
-    This function will not alter the sequence length, just the Frame object's sequence nums
+    Internal function.  Emits seqNumsChanged() for [\a first, \a last] of \a plane (if that
+    isn't empty).  During a batch, it's only noted down for commitChanges().
+*/
+void XSheet::_seqNumsChanged(int plane, int first, int last) {
+    if (changing()) {
+        auto iter = _changedPlanes.find(plane);
+        if (iter == _changedPlanes.end())
+            _changedPlanes.insert(plane, first);
+        else
+            iter.value() = qMin(iter.value(), first);
+    } else if (first <= last)
+        emit seqNumsChanged(plane, first, last);
+}
+
+
+/*!
+    Internal function.  Emits seqLegnthChanged(), unless it's during a batch.
+*/
+void XSheet::_seqLengthChanged() {
+    if (!changing())
+        emit seqLegnthChanged(seqLength());
+}
+
+
+/*!
+    Internal function.  Sets the sequence length to that of the longest plane.
+*/
+void XSheet::_updateSeqLength() {
+    _seqLength = 0;
+    for (auto iter = _planes.begin(); iter != _planes.end(); iter++)
+        _seqLength = qMax(_seqLength, iter->seqLength);
+}
+
 
-    \sa seqNumsChanged()
+/*!
+    Internal function.  Fenwick prefix sum of the holds of \a p in [0, \a index), plus one.
 */
-void XSheet::_updateSeqNums(int at) {
-    QList<QPointer<TimedFrame>> &firstPlane = _frames[0];
+int XSheet::_seqNumAt(const _Plane &p, int index) {
+    int sum = 0;
+    for (int i = index; i > 0; i -= (i & -i))
+        sum += p.holdTree[i];
+
+    return sum + 1;
+}
 
-    // Get the first
-    TimedFrame *frame = firstPlane[at];
-    int nextNum = frame->seqNum() + frame->hold();
 
-    // Start assigning to the rest
-    for (int i = (at + 1); i < firstPlane.size(); i++) {
-        frame = firstPlane[i];
-        frame->setSeqNum(nextNum);
-        nextNum += frame->hold();
+/*!
+    Internal function.  Returns the index in \a p of the frame that's showing at sequence number
+    \a num, or -1 if \a num is outside of the plane.  This walks down the hold tree, looking for
+    the last frame that starts at or before \a num.
+*/
+int XSheet::_indexAtSeq(const _Plane &p, int num) {
+    if ((num < 1) || (num > p.seqLength))
+        return -1;
+
+    // Find the most frames whose holds add up to less than num
+    int n = p.holds.size();
+    int step = 1;
+    while ((step << 1) <= n)
+        step <<= 1;
+
+    int index = 0, remaining = num - 1;
+    for (; step > 0; step >>= 1) {
+        int next = index + step;
+        if ((next <= n) && (p.holdTree[next] <= remaining)) {
+            index = next;
+            remaining -= p.holdTree[next];
+        }
     }
 
-    // Update the sequence length
-    _seqLength = nextNum - 1;
-    emit seqNumsChanged();
+    return index;
+}
+
+
+/*!
+    Internal function.  Adds \a delta onto the hold of the frame at \a index in the tree of \a p.
+    Doesn't touch the plane's holds list.
+*/
+void XSheet::_addToHold(_Plane &p, int index, int delta) {
+    for (int i = index + 1; i < p.holdTree.size(); i += (i & -i))
+        p.holdTree[i] += delta;
+}
+
+
+/*!
+    Internal function.  Puts the hold of the last frame of \a p (number \a plane) onto the end of
+    its tree, for a frame that was just appended.  O(log n), nothing else changes.
+*/
+void XSheet::_appendHold(_Plane &p, int plane) {
+    int i = p.holds.size() + 1;
+    TimedFrame *frame = p.frames[i - 1];
+    frame->setPlane(plane);
+    frame->setIndex(i - 1);
+
+    // Node i covers (i - lowbit(i), i]
+    int hold = frame->hold();
+    p.holds.append(hold);
+    p.holdTree.append(hold + (_seqNumAt(p, i - 1) - _seqNumAt(p, i - (i & -i))));
+    p.seqLength += hold;
+}
+
+
+/*!
+    Internal function.  Takes the last frame's hold out of the tree of \a p, for a frame that was
+    just taken off of the end.
+*/
+void XSheet::_removeLastHold(_Plane &p) {
+    p.seqLength -= p.holds.takeLast();
+    p.holdTree.removeLast();
 }
 
+
+/*!
+    Will go through each frame in \a p (number \a plane) from index \a at onwards, and fix its
+    placement and hold.  Then the hold tree is rebuilt (in linear time).  This is for when frames
+    are inserted, removed or moved around in the middle of the list.  Sequence numbers aren't
+    stored, so none of the frames get a signal, it's up to the caller to emit seqNumsChanged().
+
+    Also updates the length of the plane.
+*/
+void XSheet::_rebuildHolds(_Plane &p, int plane, int at) {
+    int n = p.frames.size();
+
+    // Everything before at stays the same
+    p.holds.resize(n);
+    for (int i = at; i < n; i++) {
+        TimedFrame *frame = p.frames[i];
+        frame->setPlane(plane);
+        frame->setIndex(i);
+        p.holds[i] = frame->hold();
+    }
+
+    // Each node gives its sum to its parent
+    p.holdTree.fill(0, n + 1);
+    p.seqLength = 0;
+    for (int i = 1; i <= n; i++) {
+        p.holdTree[i] += p.holds[i - 1];
+        p.seqLength += p.holds[i - 1];
+
+        int parent = i + (i & -i);
+        if (parent <= n)
+            p.holdTree[parent] += p.holdTree[i];
+    }
+}
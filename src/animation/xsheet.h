@@ -3,7 +3,6 @@
 // Description:  Header file for the XSheet class.
 
 // TODO List:
-//  - Framework is there to support layers, but now it's just using one
 //  - Make the code cleaner for the sequence length thing
 //  - bring back _seqMap?
 
@@ -22,6 +21,10 @@
 #include <QObject>
 #include <QPointer>
 #include <QList>
+#include <QVector>
+#include <QMap>
+#include <QString>
+#include <QImage>
 class TimedFrame;
 class Animation;
 
@@ -35,17 +38,34 @@ public:
 
     // Meta-data
     bool isEmpty();
-    int numFrames();
+    int numFrames(int plane=0);
     int seqLength();
+    int planeLength(int plane);
     int FPS();
     void setFPS(int fps);
 
+    // Planes
+    int numPlanes();
+    int addPlane(QString name=QString());
+    QString planeName(int plane);
+    void setPlaneName(int plane, QString name);
+
     // Frame operators
-    QList<QPointer<TimedFrame>> frames();
-    QPointer<TimedFrame> frameAtSeq(int num);
-    void addFrame(TimedFrame *frame, int at=XSHEET_END);
-    QPointer<TimedFrame> removeFrame(int at=XSHEET_END);
-    void moveFrame(int at, int to);
+    QList<QPointer<TimedFrame>> frames(int plane=0);
+    QPointer<TimedFrame> frameAt(int index, int plane=0);
+    QPointer<TimedFrame> frameAtSeq(int num, int plane=0);
+    QList<QPointer<TimedFrame>> framesAtSeq(int num);
+    QImage render(int num);
+    int seqNumAt(int index, int plane=0);
+    void addFrame(TimedFrame *frame, int at=XSHEET_END, int plane=0);
+    QPointer<TimedFrame> removeFrame(int at=XSHEET_END, int plane=0);
+    void moveFrame(int at, int to, int plane=0);
+    QList<TimedFrame *> replaceFrames(int index, int count, QList<TimedFrame *> frames, int plane=0);
+
+    // Batches of changes
+    void beginChanges();
+    void commitChanges();
+    bool changing();
 
 
 private slots:
@@ -55,22 +75,48 @@ private slots:
 signals:
     void FPSChanged(int fps);
     void seqLegnthChanged(int seqLength);
-    void seqNumsChanged();
+    void seqNumsChanged(int plane, int first, int last);        // Frames at index [first, last] of plane may now start at a different sequence number
+    void planeAdded(int plane);
+    void planeNameChanged(int plane, QString name);
     void frameAdded(QPointer<TimedFrame> frame);
     void frameRemoved(QPointer<TimedFrame> frame);
     void frameMoved(QPointer<TimedFrame> frame);
+    void changesCommitted();                                    // A batch is done, see beginChanges()
 
 
 private:
+    // One timing plane
+    struct _Plane {
+        QString name;
+        QList<QPointer<TimedFrame>> frames;        // TimedFrames, in order by their sequence number
+        QVector<int> holds;                        // Hold of each frame, by index
+        QVector<int> holdTree;                    // Fenwick tree over holds (one-indexed), for prefix sums of the holds
+        int seqLength = 0;                        // How long this plane is (includes holds)
+    };
+
     // Member functions
-    void _updateSeqNums(int at=0);
+    bool _isValidPlane(int plane);
+    void _updateSeqLength();
+    int _seqNumAt(const _Plane &p, int index);
+    int _indexAtSeq(const _Plane &p, int num);
+    void _addToHold(_Plane &p, int index, int delta);
+    void _appendHold(_Plane &p, int plane);
+    void _removeLastHold(_Plane &p);
+    void _rebuildHolds(_Plane &p, int plane, int at=0);
+    void _seqNumsChanged(int plane, int first, int last);
+    void _seqLengthChanged();
 
     // Members vars
     QPointer<Animation> _anim;                        // Animathion that this XSheet is a part of
-    QList<QList<QPointer<TimedFrame>>> _frames;        // List of layers, of lists of TimedFrames, in order by their sequence number
-    int _seqLength = 0;                                // Total count of how many frames long the sequence is (inclues holds)
+    QList<_Plane> _planes;                            // The planes, first is drawn at the bottom
+    int _seqLength = 0;                                // Length of the longest plane
     int _fps = 1;                                    // Framerate of the animation sequence, should a positive integer
 
+    // Batches
+    int _changeDepth = 0;                            // How many beginChanges() haven't been committed yet
+    QMap<int, int> _changedPlanes;                    // Planes changed in the batch, and the first index that moved
+    int _seqLengthBefore = 0;                        // Sequence length when the batch started
+
 
 };
  
@@ -1,5 +1,5 @@
 TEMPLATE = app
-QT += widgets 
+QT += widgets concurrent
 RESOURCES = blit.qrc
 TARGET = blit
 CONFIG += c++14 plugin warn_off debug
@@ -19,6 +19,15 @@ SOURCES += util.cpp
 HEADERS += blitapp.h
 SOURCES += blitapp.cpp
 
+HEADERS += undohistory.h
+SOURCES += undohistory.cpp
+
+HEADERS += playbackengine.h
+SOURCES += playbackengine.cpp
+
+HEADERS += selection.h
+SOURCES += selection.cpp
+
 
 
 # Animation Module
@@ -52,6 +61,9 @@ SOURCES += animation/framelibrary.cpp
 HEADERS += animation/xsheet.h
 SOURCES += animation/xsheet.cpp
 
+HEADERS += animation/timing.h
+SOURCES += animation/timing.cpp
+
 HEADERS += animation/animation.h
 SOURCES += animation/animation.cpp 
 
@@ -117,6 +129,20 @@ SOURCES += widgets/drawing/canvas.cpp
 HEADERS += widgets/drawing/backdrop.h
 SOURCES += widgets/drawing/backdrop.cpp
 
+HEADERS += widgets/drawing/compositeitem.h
+SOURCES += widgets/drawing/compositeitem.cpp
+HEADERS += widgets/drawing/planeitem.h
+SOURCES += widgets/drawing/planeitem.cpp
+
+HEADERS += widgets/drawing/playbackitem.h
+SOURCES += widgets/drawing/playbackitem.cpp
+
+HEADERS += widgets/drawing/selectionitem.h
+SOURCES += widgets/drawing/selectionitem.cpp
+
+HEADERS += widgets/drawing/overlayitem.h
+SOURCES += widgets/drawing/overlayitem.cpp
+
 
 
 # Tools
@@ -126,6 +152,15 @@ SOURCES += tools/toolparameters.cpp
 HEADERS += tools/tool.h
 SOURCES += tools/tool.cpp
 
+HEADERS += tools/strokeengine.h
+SOURCES += tools/strokeengine.cpp
+
+HEADERS += tools/dabengine.h
+SOURCES += tools/dabengine.cpp
+
+HEADERS += tools/rasterizer.h
+SOURCES += tools/rasterizer.cpp
+
 HEADERS += tools/pentool.h
 SOURCES += tools/pentool.cpp
 
@@ -147,6 +182,9 @@ SOURCES += tools/filltool.cpp
 HEADERS += tools/movetool.h
 SOURCES += tools/movetool.cpp
 
+HEADERS += tools/selecttool.h
+SOURCES += tools/selecttool.cpp
+
 HEADERS += tools/resizetool.h
 SOURCES += tools/resizetool.cpp
 
@@ -156,8 +194,11 @@ SOURCES += tools/colorpickertool.cpp
 
 
 # Timeline Widgets
-HEADERS += widgets/timeline/tick.h
-SOURCES += widgets/timeline/tick.cpp
+HEADERS += widgets/timeline/tickstrip.h
+SOURCES += widgets/timeline/tickstrip.cpp
+
+HEADERS += widgets/timeline/thumbnailcache.h
+SOURCES += widgets/timeline/thumbnailcache.cpp
 
 HEADERS    += widgets/timeline/ruler.h
 SOURCES += widgets/timeline/ruler.cpp
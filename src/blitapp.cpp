@@ -27,6 +27,9 @@
 #include "util.h"
 #include "fileops.h"
 #include "spritesheet.h"
+#include "undohistory.h"
+#include "playbackengine.h"
+#include "selection.h"
 #include "widgets/timelinewindow.h"
 #include "widgets/toolswindow.h"
 #include "widgets/celswindow.h"
@@ -87,6 +90,11 @@ BlitApp::BlitApp() :
     _lastStillFilter = FileOps::validFilters()[0];
     _zoom = 1.0;
 
+    // Undo/Redo (before the Menu bar, it makes actions for it)
+    _history = new UndoHistory(this);
+    _selection = new Selection(this);
+    _playback = new PlaybackEngine(this);
+
     // For the Menu bar to add actions
     QList<QDockWidget *> docks;
 
@@ -141,9 +149,18 @@ BlitApp::BlitApp() :
     connect(this, &BlitApp::frameSizeChanged, _canvas, &Canvas::onFrameSizeChanged);
     connect(this, &BlitApp::curTimedFrameChanged, _canvas, &Canvas::setFrame);
     connect(this, &BlitApp::curCelRefChanged, _canvas, &Canvas::onCurCelRefChanged);
+    connect(this, &BlitApp::curSeqNumChanged, _canvas, &Canvas::setSeqNum);
+    connect(this, &BlitApp::animationPlaybackStateChanged, _canvas, &Canvas::setPlayingBack);
+    connect(this, &BlitApp::curSeqNumChanged, _playback, &PlaybackEngine::setSeqNum);
+    connect(_playback, &PlaybackEngine::frameReady, _canvas, &Canvas::setPlaybackImage);
     connect(this, &BlitApp::animLoaded, _timelineWnd, &TimelineWindow::setAnimation);
     connect(this, &BlitApp::curTimedFrameChanged, _celsWnd, &CelsWindow::setFrame);
     connect(_canvas, &Canvas::mousePressed, this, &BlitApp::_onCanvasPressed);
+    connect(_canvas, &Canvas::mouseReleased, this, &BlitApp::_onCanvasReleased);
+    connect(this, &BlitApp::curCelRefChanged, _selection, &Selection::clear);
+    connect(this, &BlitApp::animLoaded, _selection, &Selection::clear);
+    connect(this, &BlitApp::animLoaded, _history, &UndoHistory::clear);
+    _canvas->setSelection(_selection);
     connect(_canvas, &Canvas::mouseMoved, this, &BlitApp::_onCanvasMouseMoved);
     connect(_toolsWnd->toolbox(), &Toolbox::curToolChanged, this, &BlitApp::onCurToolChanged);
     connect(_timelineWnd, &TimelineWindow::animationPlaybackStateChanged, this, &BlitApp::_onAnimationPlaybackStateChanged);
@@ -261,11 +278,13 @@ bool BlitApp::load(QString path) {
         // Slots n' signals
         connect(tmp, &Animation::nameChanged, this, &BlitApp::onAnimationNameChanged);
         connect(tmp, &Animation::frameSizeChanged, this, &BlitApp::onFrameSizeChanged);
+        connect(tmp->xsheet(), &XSheet::changesCommitted, this, &BlitApp::_onXSheetChangesCommitted);
 
         // Last things
         Animation *oldAnim = _anim;                        // Out with the old
         _anim = tmp;                                    // In with the new
         emit animLoaded(tmp);                            // Emit
+        _canvas->setXSheet(xsheet());                    // Other planes
         setCurTimedFrame(xsheet()->frameAtSeq(1));            // Switch
         delete oldAnim;                                    // Delete
 
@@ -280,7 +299,8 @@ bool BlitApp::load(QString path) {
 
 /*!
     Call this function to Save the Animation file.  Will do nothing unless the Animation is
-    Set and isn't Null.
+    Set and isn't Null.  If the XSheet is in the middle of a batch of changes (see
+    XSheet::beginChanges()), it's saved once the batch is committed instead.
 
     \sa animLoaded()
     \sa load()
@@ -294,6 +314,12 @@ bool BlitApp::saveAnim(QString path) {
         if (_anim->isEmpty())
             return false;
 
+        // In the middle of a batch of changes, wait until it's done (only save once)
+        if (path.isEmpty() && _anim->xsheet()->changing()) {
+            _saveAfterChanges = true;
+            return true;
+        }
+
         // Update
         _anim->update();
 
@@ -696,7 +722,7 @@ void BlitApp::showExportStillImage() {
             filename.append(FileOps::extensionMap()[_lastStillFilter]);
 
         // Make the save
-        bool success = FileOps::saveStillFrame(_curTimedFrame->frame(), filename);
+        bool success = FileOps::saveStillFrame(xsheet(), _curSeqNum, filename);
         
         // Set a variable
         _lastStillFilename = filename;
@@ -714,6 +740,25 @@ void BlitApp::onSetBackdrop() {
 }
 
 
+/*!
+    Activated by Menu -> Canvas -> Set Backdrop Image, this will ask for an image
+    file to tile behind the Frame.
+*/
+void BlitApp::onSetBackdropImage() {
+    QString filename = QFileDialog::getOpenFileName(this, tr("Set Backdrop Image"), _lastImportStillDir, FileOps::validFilters().join(";;"), NULL);
+    if (filename.isEmpty())
+        return;
+
+    QImage img(filename);
+    if (img.isNull()) {
+        qDebug() << "[BlitApp onSetBackdropImage] couldn't load" << filename;
+        return;
+    }
+
+    _canvas->setBackdropImage(img);
+}
+
+
 /*!
     Brings up a dailog when the "Help > About Blit" action is triggered.
 */
@@ -774,10 +819,33 @@ bool BlitApp::isAnimationPlaying() {
 
 /*!
     Called when the Canvas widget is just been pressed.  the primary funciton of this slot
-    is to stop any Animaitons that might be currently playing
+    is to stop any Animaitons that might be currently playing.  It also starts recording an
+    edit to the current Cel for the UndoHistory.
+
+    \sa _onCanvasReleased()
 */
 void BlitApp::_onCanvasPressed(QGraphicsSceneMouseEvent *event) {
     playAnimation(false);
+
+    // Anything drawn until the mouse is released is one undo step
+    Cel *cel = curCel();
+    if (cel && (cel->type() == PNG_CEL_TYPE))
+        _history->beginCelEdit((PNGCel *)cel);
+
+    // Keep what's drawn inside of the selection
+    _selection->beginEdit();
+}
+
+
+/*!
+    Called when the mouse has been released on the Canvas.  Finishes the edit that was started
+    in _onCanvasPressed().  This is queued so the Tool gets to finish drawing first.
+
+    \sa _onCanvasPressed()
+*/
+void BlitApp::_onCanvasReleased(QGraphicsSceneMouseEvent *event) {
+    QMetaObject::invokeMethod(_selection, "endEdit", Qt::QueuedConnection);
+    QMetaObject::invokeMethod(_history, "endCelEdit", Qt::QueuedConnection);
 }
 
 
@@ -792,14 +860,32 @@ void BlitApp::_onCanvasMouseMoved(QGraphicsSceneMouseEvent *event) {
 
 /*!
     Called by the TimelineWindow::animationPlaybackStateChanged() signal, this will
-    pass around the signal to other modules that want/need it.  Emits the
+    pass around the signal to other modules that want/need it.  Starts or stops the
+    PlaybackEngine first, so it has something to show.  Emits the
     animationPlaybackStateChanged() signal.
 */
 void BlitApp::_onAnimationPlaybackStateChanged(bool isPlaying) {
+    if (isPlaying && _anim)
+        _playback->start(xsheet(), frameSize());
+    else
+        _playback->stop();
+
     emit animationPlaybackStateChanged(isPlaying);
 }
 
 
+/*!
+    Called by the XSheet::changesCommitted() signal.  If saveAnim() was called during the batch
+    of changes, it's done now (once).
+*/
+void BlitApp::_onXSheetChangesCommitted() {
+    if (_saveAfterChanges) {
+        _saveAfterChanges = false;
+        saveAnim();
+    }
+}
+
+
 /*!
     When the Animation's framesize is changed, it will trip this slot, which will then pass it
     around to the rest of the application that needs to know about the frame size (e.g. the
@@ -849,6 +935,9 @@ void BlitApp::keyPressEvent(QKeyEvent *event) {
         case Qt::Key_Period:
         case Qt::Key_Minus:
         case Qt::Key_Equal:
+        case Qt::Key_BracketLeft:
+        case Qt::Key_BracketRight:
+        case Qt::Key_Backslash:
             // Dispatch a copy event to the timeline window
             QCoreApplication::postEvent(_timelineWnd, copy);
             event->accept();
@@ -918,6 +1007,9 @@ Cel *BlitApp::curCel() {
 */
 void BlitApp::setCurTimedFrame(TimedFrame *tf) {
     if (_curTimedFrame != tf) {
+        // Floating pixels go back into their Cel while it's still loaded up
+        _selection->commit();
+
         // Activate/Deactivate (and do some NULL checks)
         if (_curTimedFrame) {
             if (_curTimedFrame->frame())
@@ -1005,6 +1097,30 @@ void BlitApp::setCanvas(Canvas *canvas) {
 }
 
 
+/*!
+    Returns the UndoHistory for the application.  Will never be NULL.
+*/
+UndoHistory *BlitApp::history() {
+    return _history;
+}
+
+
+/*!
+    Returns the PlaybackEngine for the application.  Will never be NULL.
+*/
+PlaybackEngine *BlitApp::playback() {
+    return _playback;
+}
+
+
+/*!
+    Returns the Selection on the current Cel.  Will never be NULL, but it might be empty.
+*/
+Selection *BlitApp::selection() {
+    return _selection;
+}
+
+
 /*!
     Will return a blank Image of the same size of the currently selected Cel.  If there is
     no currently selected Cel, then the currently set frame size will be used instead.
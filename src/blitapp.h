@@ -25,6 +25,9 @@ class TimelineWindow;
 class ToolsWindow;
 class CelsWindow;
 class LightTableWindow;
+class UndoHistory;
+class PlaybackEngine;
+class Selection;
 class QSize;
 class QColor;
 class QImage;
@@ -65,6 +68,15 @@ public:
     Canvas *canvas();
     void setCanvas(Canvas *canvas);
 
+    // Undo/Redo
+    UndoHistory *history();
+
+    // Playback
+    PlaybackEngine *playback();
+
+    // Selection
+    Selection *selection();
+
     // For drawing
     QImage getPaintableImage();
     void drawOntoCel(QImage &buffer);
@@ -120,6 +132,7 @@ public slots:
     void showExportSpritesheet();
     void showExportStillImage();
     void onSetBackdrop();
+    void onSetBackdropImage();
     void showAboutBlit();
 
     void playAnimation(bool play=true);
@@ -134,8 +147,10 @@ public slots:
 
 private slots:
     void _onAnimationPlaybackStateChanged(bool isPlaying);
+    void _onXSheetChangesCommitted();
 
     void _onCanvasPressed(QGraphicsSceneMouseEvent *event);
+    void _onCanvasReleased(QGraphicsSceneMouseEvent *event);
     void _onCanvasMouseMoved(QGraphicsSceneMouseEvent *event);
 
 
@@ -162,12 +177,22 @@ private:
     // Drawing widgets
     Canvas *_canvas;
 
+    // Undo/Redo
+    UndoHistory *_history;
+
+    // Renders ahead during playback
+    PlaybackEngine *_playback;
+
+    // Selection on the current Cel
+    Selection *_selection;
+
     // Current animation varibles
     Animation *_anim = NULL;                // Pointer to current Animation
     CelRef *_curCelRef = NULL;                // Current CelRef
     Frame *_frame = NULL;                    // Current Frame
     TimedFrame *_curTimedFrame = NULL;        // Current TimedFrame
     quint32 _curSeqNum = 0;                    // Current sequence number (alwasy  a positive number)
+    bool _saveAfterChanges = false;            // saveAnim() was called during a batch of XSheet changes
 
     // State variables
     QString _lastImportStillDir;    // Directory of the last imported still image (to Cel)
@@ -315,11 +315,12 @@ namespace FileOps {
     /*!
         Writes a Plane to the XML stream.  Adds a <plane></plane> block.
     */
-    void planeToXML(QXmlStreamWriter &xml, QList<QPointer<TimedFrame>> &plane, int num) {
+    void planeToXML(QXmlStreamWriter &xml, QList<QPointer<TimedFrame>> &plane, int num, QString name) {
 
         // <plane>
         xml.writeStartElement("plane");
         xml.writeAttribute("number", QString::number(num));
+        xml.writeAttribute("name", name);
         xml.writeAttribute("count", QString::number(plane.size()));
 
         // Write out the TimedFrames
@@ -340,10 +341,11 @@ namespace FileOps {
         xml.writeAttribute("fps", QString::number(xsheet->FPS()));
         xml.writeAttribute("seq_length", QString::number(xsheet->seqLength()));
         
-        // Write the plane(s)
-        // TODO there is currently only one plane, need to add support for multiple in the future
-        QList<QPointer<TimedFrame>> firstPlane = xsheet->frames();
-        planeToXML(xml, firstPlane, 1);
+        // Write the planes, numbered from 1
+        for (int i = 0; i < xsheet->numPlanes(); i++) {
+            QList<QPointer<TimedFrame>> plane = xsheet->frames(i);
+            planeToXML(xml, plane, i + 1, xsheet->planeName(i));
+        }
 
         xml.writeEndElement();
         // </xsheet>
@@ -636,9 +638,17 @@ namespace FileOps {
             if (token == QXmlStreamReader::StartElement) {
                 // Strip elements
                 if (tag == "plane") {
+                    // Planes are numbered from 1, make sure there are enough of them
+                    int num = qMax(xml.attributes().value("number").toInt(), 1) - 1;
+                    QString name = xml.attributes().value("name").toString();
+                    while (xsheet->numPlanes() <= num)
+                        xsheet->addPlane();
+                    if (!name.isEmpty())
+                        xsheet->setPlaneName(num, name);
+
                     QList<TimedFrame *> timedFrames = xmlToPlane(xml, anim);
                     for (auto iter = timedFrames.begin(); iter != timedFrames.end(); iter++)
-                        xsheet->addFrame(*iter);
+                        xsheet->addFrame(*iter, XSHEET_END, num);
                 }
             } else if (token == QXmlStreamReader::EndElement) {
                 // Break out if </xsheet> reached
@@ -828,17 +838,19 @@ namespace FileOps {
         // Save all of the Cels from the old directory to the new one
         if (saveCels) {
             // Doing this is kind of ineffcient, but works
-            QListIterator<QPointer<TimedFrame>> frames(anim->xsheet()->frames());
-
-            // go through each frame
-            while (frames.hasNext()) {
-                Frame *frame = frames.next()->frame();
-                QListIterator<CelRef *> refs(frame->cels());
-
-                // Go through each Cel
-                while (refs.hasNext()) {
-                    CelRef *ref = refs.next();
-                    ref->cel()->image().save(path + "/" + ref->cel()->name() + ".png");
+            for (int plane = 0; plane < anim->xsheet()->numPlanes(); plane++) {
+                QListIterator<QPointer<TimedFrame>> frames(anim->xsheet()->frames(plane));
+
+                // go through each frame
+                while (frames.hasNext()) {
+                    Frame *frame = frames.next()->frame();
+                    QListIterator<CelRef *> refs(frame->cels());
+
+                    // Go through each Cel
+                    while (refs.hasNext()) {
+                        CelRef *ref = refs.next();
+                        ref->cel()->image().save(path + "/" + ref->cel()->name() + ".png");
+                    }
                 }
             }
 
@@ -1060,13 +1072,14 @@ namespace FileOps {
     /*== Export functions ==*/
 
     /*!
-        Looks at a frame object, and will save it as an image to dest.  Please make sure to supply a
-        valid image extension (like .png).  Will return true on success, false otherwise.  Will always
-        overwrite the existing image (if there is one).  Please note that this function did more in
-        the python version of Blit, but it seems that stuff may be a bit redundant.
+        Saves what's showing at seqNum in the XSheet (all of its planes composited together) as an
+        image to dest.  Please make sure to supply a valid image extension (like .png).  Will return
+        true on success, false otherwise.  Will always overwrite the existing image (if there is
+        one).  Please note that this function did more in the python version of Blit, but it seems
+        that stuff may be a bit redundant.
     */
-    bool saveStillFrame(Frame *frame, QString dest) {
-        return frame->render().save(dest);
+    bool saveStillFrame(XSheet *xsheet, int seqNum, QString dest) {
+        return xsheet->render(seqNum).save(dest);
     } 
 
 
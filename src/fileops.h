@@ -54,7 +54,7 @@ namespace FileOps {
     void frameToXML(QXmlStreamWriter &xml, Frame *frame);
     void framesToXML(QXmlStreamWriter &xml, FrameLibrary *fl);
     void timedFrameToXML(QXmlStreamWriter &xml, TimedFrame *tf);
-    void planeToXML(QXmlStreamWriter &xml, QList<QPointer<TimedFrame>> &plane, int num);
+    void planeToXML(QXmlStreamWriter &xml, QList<QPointer<TimedFrame>> &plane, int num, QString name);
     void xsheetToXML(QXmlStreamWriter &xml, XSheet *xsheet);
     void animationToXML(QXmlStreamWriter &xml, Animation *anim);
 
@@ -87,7 +87,7 @@ namespace FileOps {
     PNGCel *loadStillImage(QString filename, Animation *anim);
 
     // Exports
-    bool saveStillFrame(Frame *frame, QString dest);
+    bool saveStillFrame(XSheet *xsheet, int seqNum, QString dest);
     bool saveSpritesheet(QImage spritesheet, QString dest);
 };
 
@@ -0,0 +1,411 @@
+// File:         playbackengine.cpp
+// Author:       Ben Summerton (define-private-public)
+// Description:  Source implementation of the PlaybackEngine class
+
+
+/*!
+    \class PlaybackEngine
+    \brief PlaybackEngine has the frames rendered before they're needed during playback.
+
+    When playback is started, the XSheet is walked forward from the playhead (wrapping around
+    to the start of the range when looping).  Every span of sequence numbers where no plane
+    changes Frame gets one render, of all of the planes composited together.  Each one is
+    made on another thread and put into a ring buffer, which is bounded by both
+    PLAYBACK_BUFFER_FRAMES and PLAYBACK_BUFFER_LIMIT.  As the playhead moves past a span its
+    Slot is freed up, and the next span further ahead takes it.
+
+    The playhead is moved with setSeqNum() (BlitApp connects that to the current sequence
+    number), and frameReady() is emitted whenever something different should be shown.  If a
+    render isn't ready in time, what was shown stays up until it is, and it's counted as a
+    dropped frame.  The first render is done right away when playback starts, so there's
+    always something to show.
+
+    Like the ThumbnailCache, only copies go to the other threads.  A loaded up Cel's image is
+    shared implicitly, and the rest are read from their files there.  The files that have been
+    read are kept (bounded by PLAYBACK_DECODE_LIMIT) for the renders after, so a Cel that's
+    held across many frames (e.g. a background) is only read once.
+
+    Nothing can be edited while playing, so the only changes to the XSheet that are watched
+    for are frames being moved around.  Those throw out the whole buffer.
+*/
+
+
+#include "playbackengine.h"
+#include "blitapp.h"
+#include "animation/animation.h"
+#include "animation/xsheet.h"
+#include "animation/timedframe.h"
+#include "animation/frame.h"
+#include "animation/celref.h"
+#include "animation/cel.h"
+#include "util.h"
+#include <QtConcurrent/QtConcurrentRun>
+#include <QFutureWatcher>
+#include <QStringList>
+#include <QPainter>
+#include <QDebug>
+
+
+/*!
+    Creates a PlaybackEngine that isn't running.  Use setRange() and start() to start it up.
+*/
+PlaybackEngine::PlaybackEngine(QObject *parent) :
+    QObject(parent),
+    _decoded(PLAYBACK_DECODE_LIMIT)
+{
+    qDebug() << "[PlaybackEngine created]";
+}
+
+
+/*!
+    Deconstructor.  Jobs that are still running only have copies of what they need, so
+    they're left to finish on their own.
+*/
+PlaybackEngine::~PlaybackEngine() {
+    qDebug() << "[PlaybackEngine destroyed]";
+}
+
+
+/*!
+    Returns true if playback has been started.
+*/
+bool PlaybackEngine::running() {
+    return _running;
+}
+
+
+/*!
+    Returns how many renders (from the playhead on) are ready.
+*/
+int PlaybackEngine::buffered() {
+    int num = 0;
+    for (int i = 0; (i < _count) && _slots[(_head + i) % _slots.size()].ready; i++)
+        num++;
+
+    return num;
+}
+
+
+/*!
+    Returns how many renders weren't ready when they should have been shown, since playback
+    was last started.
+*/
+int PlaybackEngine::droppedFrames() {
+    return _dropped;
+}
+
+
+/*!
+    Sets the sequence numbers that are played, [\a first, \a last].  If \a loop is true,
+    playback goes back to \a first after \a last, so those are rendered ahead too.  If it
+    changes while running, the buffer is redone.
+*/
+void PlaybackEngine::setRange(int first, int last, bool loop) {
+    first = qMax(first, 1);
+    last = qMax(last, first);
+    if ((_first == first) && (_last == last) && (_loop == loop))
+        return;
+
+    _first = first;
+    _last = last;
+    _loop = loop;
+
+    if (_running) {
+        _reset(_seqNum);
+        _fill();
+    }
+}
+
+
+/*!
+    Starts rendering the frames of \a xsheet (that are \a frameSize), from the playhead.
+    The first one is done before this returns.  If it was already running, it's started over.
+*/
+void PlaybackEngine::start(XSheet *xsheet, QSize frameSize) {
+    stop();
+    if (!xsheet || frameSize.isEmpty())
+        return;
+
+    _xsheet = xsheet;
+    _size = frameSize;
+    connect(_xsheet, &XSheet::seqNumsChanged, this, &PlaybackEngine::_onXSheetChanged);
+    connect(_xsheet, &XSheet::planeAdded, this, &PlaybackEngine::_onXSheetChanged);
+
+    // As many as fit
+    int frameKiB = qMax((frameSize.width() * frameSize.height() * 4) / 1024, 1);
+    _slots.resize(qBound(2, PLAYBACK_BUFFER_LIMIT / frameKiB, PLAYBACK_BUFFER_FRAMES));
+
+    _running = true;
+    _dropped = 0;
+    _reset(qBound(_first, _seqNum, _last));
+
+    // Have the first one right away
+    Job job = _assign();
+    Slot &slot = _slots[_head];
+    slot.image = _run(job).image;
+    slot.ready = true;
+
+    _fill();
+    _present();
+
+    qDebug() << "[PlaybackEngine start] range=" << _first << "to" << _last << ", buffer=" << _slots.size();
+}
+
+
+/*!
+    Stops rendering, and throws out the buffer.  Jobs that are still running are ignored
+    when they're done.
+*/
+void PlaybackEngine::stop() {
+    if (!_running)
+        return;
+
+    _running = false;
+    if (_xsheet)
+        disconnect(_xsheet, 0, this, 0);
+    _xsheet = NULL;
+
+    _reset(-1);
+    _slots.clear();
+    _decoded.clear();
+
+    qDebug() << "[PlaybackEngine stop] dropped=" << _dropped;
+}
+
+
+/*!
+    Moves the playhead to \a seqNum.  If its render is ready (and isn't what's shown already)
+    frameReady() is emitted.  The Slots that were passed are given to the frames further ahead.
+    Jumping to somewhere that wasn't rendered ahead (e.g. the cursor was moved) starts the
+    buffer over from there.
+*/
+void PlaybackEngine::setSeqNum(quint32 seqNum) {
+    _seqNum = seqNum;
+    if (!_running || (_seqNum < _first) || (_seqNum > _last))
+        return;
+
+    // Nearly always the head, or the one after it
+    int i = 0;
+    while (i < _count) {
+        Slot &slot = _slots[(_head + i) % _slots.size()];
+        if ((_seqNum >= slot.first) && (_seqNum <= slot.last))
+            break;
+        i++;
+    }
+
+    if (i == _count)
+        _reset(_seqNum);
+    else {
+        // Free up the ones that were passed
+        for (; i > 0; i--) {
+            _slots[_head] = Slot();
+            _head = (_head + 1) % _slots.size();
+            _count--;
+        }
+    }
+
+    _fill();
+    _present();
+}
+
+
+/*!
+    Triggered when a Job is done.  Puts the render into its Slot (unless the Slot has been
+    given to something else since), and shows it if it's for the playhead.
+*/
+void PlaybackEngine::_onJobFinished() {
+    QFutureWatcher<Result> *watcher = static_cast<QFutureWatcher<Result> *>(sender());
+    QPair<int, quint32> job = _jobs.take(watcher);
+    Result result = watcher->result();
+    watcher->deleteLater();
+
+    if (!_running)
+        return;
+
+    // Later renders can use what was read in
+    for (auto iter = result.decoded.begin(); iter != result.decoded.end(); iter++) {
+        if (!_decoded.contains(iter.key()))
+            _decoded.insert(iter.key(), new QImage(iter.value()), qMax(iter.value().byteCount() / 1024, 1));
+    }
+
+    if (job.first >= _slots.size())
+        return;
+
+    Slot &slot = _slots[job.first];
+    if (slot.ticket != job.second)
+        return;
+
+    slot.image = result.image;
+    slot.ready = true;
+    if (job.first == _head)
+        _present();
+}
+
+
+/*!
+    Triggered when frames are moved around in the XSheet (or a plane is added).  Everything
+    that was rendered ahead could be wrong now, so it's started over.
+*/
+void PlaybackEngine::_onXSheetChanged() {
+    if (!_running)
+        return;
+
+    _reset(_seqNum);
+    _fill();
+    _present();
+}
+
+
+/*!
+    Internal function.  Empties the ring buffer, the next Slot will start at \a seqNum.
+*/
+void PlaybackEngine::_reset(int seqNum) {
+    for (int i = 0; i < _slots.size(); i++)
+        _slots[i] = Slot();
+
+    _head = 0;
+    _count = 0;
+    _nextSeq = seqNum;
+}
+
+
+/*!
+    Internal function.  Gives the next free Slot to the span that starts at the next sequence
+    number, and returns the Job to render it.  The span goes until a Frame changes in one of
+    the planes (or the end of the range).  There must be a free Slot, and somewhere to go.
+*/
+PlaybackEngine::Job PlaybackEngine::_assign() {
+    Job job;
+    job.size = _size;
+
+    int first = _nextSeq;
+    int last = _last;
+    Animation *anim = BlitApp::app()->anim();
+    int numPlanes = _xsheet ? _xsheet->numPlanes() : 0;
+    for (int plane = 0; plane < numPlanes; plane++) {
+        if (first > _xsheet->planeLength(plane))
+            continue;        // Ran out, stays empty
+
+        TimedFrame *tf = _xsheet->frameAtSeq(first, plane);
+        if (!tf)
+            continue;
+
+        last = qMin(last, tf->seqNum() + tf->hold() - 1);
+        Frame *frame = tf->frame();
+        if (!frame)
+            continue;
+
+        // Need to go in the reverse order of how they appear in the list (bottom first)
+        QList<CelRef *> refs = frame->cels();
+        for (int i = refs.size() - 1; i >= 0; i--) {
+            Cel *cel = refs.at(i)->cel();
+            if (!cel)
+                continue;
+
+            Layer layer;
+            layer.pos = refs.at(i)->pos().toPoint();
+
+            QStringList files = cel->fileResources();
+            if (anim && !cel->active() && (files.size() == 1)) {
+                QString path = anim->resourceDir() + files.first();
+                QImage *decoded = _decoded.object(path);
+                if (decoded)
+                    layer.image = *decoded;
+                else
+                    layer.path = path;
+            } else
+                layer.image = cel->image();
+
+            job.layers.append(layer);
+        }
+    }
+
+    // Take the Slot
+    Slot &slot = _slots[(_head + _count) % _slots.size()];
+    slot = Slot();
+    slot.first = first;
+    slot.last = last;
+    slot.ticket = ++_ticket;
+    _count++;
+
+    // Where the one after goes
+    if (last < _last)
+        _nextSeq = last + 1;
+    else
+        _nextSeq = _loop ? _first : -1;
+
+    return job;
+}
+
+
+/*!
+    Internal function.  Starts renders for the free Slots, until the buffer is full (or the
+    end of the range is reached, when not looping, or all of it is in the buffer when it is).
+*/
+void PlaybackEngine::_fill() {
+    while ((_count < _slots.size()) && (_nextSeq > 0)) {
+        // A short loop might all be in the buffer already
+        if ((_count > 0) && (_nextSeq == _slots[_head].first))
+            break;
+
+        int index = (_head + _count) % _slots.size();
+        Job job = _assign();
+
+        QFutureWatcher<Result> *watcher = new QFutureWatcher<Result>(this);
+        connect(watcher, &QFutureWatcher<Result>::finished, this, &PlaybackEngine::_onJobFinished);
+        _jobs.insert(watcher, qMakePair(index, _slots[index].ticket));
+        watcher->setFuture(QtConcurrent::run(&PlaybackEngine::_run, job));
+    }
+}
+
+
+/*!
+    Internal function.  Emits frameReady() with the playhead's render, if it's ready and it
+    isn't what was last sent out.  If it's not ready, it's counted as dropped (once).
+*/
+void PlaybackEngine::_present() {
+    if (_count == 0)
+        return;
+
+    Slot &slot = _slots[_head];
+    if ((_seqNum < slot.first) || (_seqNum > slot.last) || (slot.ticket == _shown))
+        return;
+
+    if (slot.ready) {
+        _shown = slot.ticket;
+        emit frameReady(slot.image);
+    } else if (_late != slot.ticket) {
+        _late = slot.ticket;
+        _dropped++;
+    }
+}
+
+
+/*!
+    Internal function, runs on another thread.  Draws the layers of \a job on top of each
+    other, reading in the ones that are files.
+*/
+PlaybackEngine::Result PlaybackEngine::_run(Job job) {
+    Result result;
+    result.image = util::mkBlankImage(job.size);
+
+    QPainter p(&result.image);
+    for (auto iter = job.layers.begin(); iter != job.layers.end(); iter++) {
+        QImage image = iter->image;
+        if (!iter->path.isEmpty()) {
+            // Might be used more than once in a frame
+            image = result.decoded.value(iter->path);
+            if (image.isNull()) {
+                image = QImage(iter->path).convertToFormat(QImage::Format_ARGB32_Premultiplied);
+                result.decoded.insert(iter->path, image);
+            }
+        }
+
+        if (!image.isNull())
+            p.drawImage(iter->pos, image);
+    }
+    p.end();
+
+    return result;
+}
+
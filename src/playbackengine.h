@@ -0,0 +1,122 @@
+// File:         playbackengine.h
+// Author:       Ben Summerton (define-private-public)
+// Description:  PlaybackEngine renders the frames that are coming up during playback on other threads,
+//               and keeps them in a ring buffer so they're ready when it's time to show them.
+
+
+#ifndef PLAYBACK_ENGINE_H
+#define PLAYBACK_ENGINE_H
+
+
+#define PLAYBACK_BUFFER_FRAMES 24                    // Most renders to have ready ahead of the playhead
+#define PLAYBACK_BUFFER_LIMIT (128 * 1024)            // Most memory (in KiB) the renders can take up
+#define PLAYBACK_DECODE_LIMIT (64 * 1024)            // Most memory (in KiB) for Cel images read from disk
+
+
+#include <QObject>
+#include <QPointer>
+#include <QVector>
+#include <QList>
+#include <QHash>
+#include <QPair>
+#include <QCache>
+#include <QImage>
+#include <QString>
+#include <QPoint>
+#include <QSize>
+template <typename T> class QFutureWatcher;
+class XSheet;
+
+
+class PlaybackEngine : public QObject {
+    Q_OBJECT;
+
+public:
+    PlaybackEngine(QObject *parent=NULL);
+    ~PlaybackEngine();
+
+    // Info
+    bool running();
+    int buffered();
+    int droppedFrames();
+
+
+public slots:
+    void setRange(int first, int last, bool loop);
+    void start(XSheet *xsheet, QSize frameSize);
+    void stop();
+    void setSeqNum(quint32 seqNum);
+
+
+signals:
+    void frameReady(QImage image);            // What to show for the current sequence number
+
+
+private slots:
+    void _onJobFinished();
+    void _onXSheetChanged();
+
+
+private:
+    // Copy of what's needed to draw a Cel, so it can be done on another thread
+    struct Layer {
+        QImage image;                // When the Cel is loaded up (or was already read from disk)
+        QString path;                // Otherwise, the file it's saved in
+        QPoint pos;
+    };
+
+    // One render to make, every plane at a sequence number
+    struct Job {
+        QSize size;
+        QList<Layer> layers;        // Bottom to top
+    };
+
+    // What comes back from a Job
+    struct Result {
+        QImage image;
+        QHash<QString, QImage> decoded;        // Files that were read in
+    };
+
+    // Spot in the ring buffer, one render that's shown for [first, last]
+    struct Slot {
+        int first = 0;
+        int last = -1;
+        QImage image;
+        bool ready = false;
+        quint32 ticket = 0;            // Which request this is, 0 if it's empty
+    };
+
+    void _reset(int seqNum);
+    Job _assign();
+    void _fill();
+    void _present();
+    static Result _run(Job job);
+
+    QPointer<XSheet> _xsheet;                    // Where the frames come from
+    QSize _size;                                // Frame size
+    bool _running = false;
+
+    // Where playback goes
+    int _first = 1;                                // Range being played, inclusive
+    int _last = 1;
+    bool _loop = false;                            // Goes back to _first after _last
+    int _seqNum = 1;                            // Playhead
+
+    // Ring buffer
+    QVector<Slot> _slots;
+    int _head = 0;                                // Slot of the playhead
+    int _count = 0;                                // Slots in use, from _head
+    int _nextSeq = -1;                            // Where the next Slot starts, -1 if playback won't get there
+    quint32 _ticket = 0;                        // Last ticket given out
+    quint32 _shown = 0;                            // Ticket of what was last sent out
+    quint32 _late = 0;                            // Ticket of the last Slot that wasn't ready in time
+    int _dropped = 0;                            // How many renders weren't ready in time
+
+    QHash<QFutureWatcher<Result> *, QPair<int, quint32>> _jobs;        // Slot and ticket each running Job is for
+    QCache<QString, QImage> _decoded;                                // Cel files that have been read, cost is in KiB
+
+};
+
+
+#endif // PLAYBACK_ENGINE_H
+
@@ -0,0 +1,468 @@
+// File:         selection.cpp
+// Author:       Ben Summerton (define-private-public)
+// Description:  Source implementation of the Selection class
+
+
+/*!
+    \class Selection
+    \brief Selection is a masked area of a single PNGCel.
+
+    The selection is kept as an 8 bit mask (0 is not selected, 255 is fully selected) that is
+    only as big as its bounding box.  It can be made from a rectangle, a polygon (lasso) or
+    any mask (magic wand); see the SelectTool.
+
+    While there is a selection, the edits that the tools make are kept inside of it.  Instead
+    of every tool checking the mask for every pixel, BlitApp calls beginEdit() when the mouse
+    is pressed on the Canvas.  After that, whenever the Cel reports some damage, the damaged
+    area is blended back with the Cel's image from before the edit using the mask as weights
+    (see util::blendRow()).  Rows outside of the mask's bounds are just copied back.
+
+    The selected pixels can also be lifted up (lift()) into a floating image.  While floating,
+    they're drawn by the Canvas' SelectionItem with the offset and scale that were set with
+    setFloatTransform(), so moving them around doesn't touch the Cel at all.  commit() draws
+    them back into the Cel in one pass.
+*/
+
+
+#include "selection.h"
+#include "blitapp.h"
+#include "util.h"
+#include "undohistory.h"
+#include "animation/cel.h"
+#include "animation/pngcel.h"
+#include <QPainter>
+#include <QBitmap>
+#include <QRegion>
+#include <QTransform>
+#include <cstring>
+
+
+Selection::Selection(QObject *parent) :
+    QObject(parent)
+{
+    // Do nothing
+}
+
+
+Selection::~Selection() {
+    // Do nothing
+}
+
+
+/*!
+    Returns true if nothing is selected.
+*/
+bool Selection::isEmpty() {
+    return _cel.isNull() || _bounds.isEmpty();
+}
+
+
+/*!
+    Returns the Cel that the selection is on, or NULL if nothing is selected.
+*/
+PNGCel *Selection::cel() {
+    return _cel;
+}
+
+
+/*!
+    Returns the bounding box of the selection, in Cel coordinates.
+*/
+QRect Selection::bounds() {
+    return _bounds;
+}
+
+
+/*!
+    Returns the 8 bit mask of the selection.  It's the same size as bounds().
+*/
+QImage Selection::mask() {
+    return _mask;
+}
+
+
+/*!
+    Returns the outline of the selection (in Cel coordinates), for drawing.
+*/
+QPainterPath Selection::outline() {
+    return _outline;
+}
+
+
+/*!
+    Returns true if \a pt (in Cel coordinates) is selected.  If the selection is floating,
+    this checks where it's been moved to.
+*/
+bool Selection::contains(QPoint pt) {
+    if (isEmpty())
+        return false;
+
+    // Map back onto the mask if it's been moved
+    QPoint mp = pt;
+    if (isFloating()) {
+        QRectF fr = floatRect();
+        if (!fr.contains(pt))
+            return false;
+
+        mp = _bounds.topLeft() + ((QPointF(pt) - fr.topLeft()) / _floatScale).toPoint();
+    }
+
+    if (!_bounds.contains(mp))
+        return false;
+
+    return _mask.constScanLine(mp.y() - _bounds.top())[mp.x() - _bounds.left()] != 0;
+}
+
+
+/*!
+    Selects \a rect of \a cel.
+*/
+void Selection::selectRect(PNGCel *cel, QRect rect) {
+    if (!cel)
+        return;
+
+    rect = rect.normalized() & QRect(QPoint(0, 0), cel->size());
+    QImage m(rect.size(), QImage::Format_Alpha8);
+    m.fill(0xFF);
+    _set(cel, m, rect);
+}
+
+
+/*!
+    Selects the area inside of \a poly on \a cel.
+*/
+void Selection::selectPolygon(PNGCel *cel, QPolygonF poly) {
+    if (!cel || (poly.size() < 3))
+        return;
+
+    QRect rect = poly.boundingRect().toAlignedRect() & QRect(QPoint(0, 0), cel->size());
+    if (rect.isEmpty())
+        return;
+
+    QImage m(rect.size(), QImage::Format_Alpha8);
+    m.fill(0x00);
+
+    QPainter p(&m);
+    p.setPen(Qt::NoPen);
+    p.setBrush(Qt::black);
+    p.translate(-rect.topLeft());
+    p.drawPolygon(poly);
+    p.end();
+
+    _set(cel, m, rect);
+}
+
+
+/*!
+    Selects the area of \a cel given by \a mask, which covers \a bounds.  \a mask should be the
+    same size as \a bounds and will be converted to an 8 bit mask if it isn't one already.
+*/
+void Selection::selectMask(PNGCel *cel, QImage mask, QRect bounds) {
+    if (!cel || (mask.size() != bounds.size()))
+        return;
+
+    _set(cel, mask.convertToFormat(QImage::Format_Alpha8), bounds);
+}
+
+
+/*!
+    Returns the outline of a selection that is still being made (e.g. a lasso as it's drawn),
+    in Cel coordinates.
+*/
+QPolygonF Selection::preview() {
+    return _preview;
+}
+
+
+/*!
+    Sets the outline of a selection that is still being made to \a poly.  Cheap to call on
+    every mouse move since nothing is rasterized.
+*/
+void Selection::setPreview(QPolygonF poly) {
+    _preview = poly;
+    emit changed();
+}
+
+
+/*!
+    Returns true if the selected pixels have been lifted up off of the Cel.
+*/
+bool Selection::isFloating() {
+    return !_floating.isNull();
+}
+
+
+/*!
+    Lifts the selected pixels up off of the Cel, so they can be moved and scaled.  They're cut
+    out of the Cel and held in floatingImage() until commit() is called.
+*/
+void Selection::lift() {
+    if (isEmpty() || isFloating())
+        return;
+
+    QImage *img = _cel->imageData();
+    if (!img)
+        return;
+
+    // Copy out what's under the mask
+    _floating = img->copy(_bounds).convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    QPainter fp(&_floating);
+    fp.setCompositionMode(QPainter::CompositionMode_DestinationIn);
+    fp.drawImage(0, 0, _mask);
+    fp.end();
+
+    _floatOffset = QPointF();
+    _floatScale = 1;
+
+    // And cut it out of the Cel (as its own undo step if it's not already part of one)
+    UndoHistory *history = BlitApp::app()->history();
+    bool ownEdit = !history->editing();
+    if (ownEdit)
+        history->beginCelEdit(_cel);
+
+    _busy = true;
+    QPainter cp(img);
+    cp.setCompositionMode(QPainter::CompositionMode_DestinationOut);
+    cp.drawImage(_bounds.topLeft(), _mask);
+    cp.end();
+    _cel->damage(_bounds);
+    _busy = false;
+
+    if (ownEdit)
+        history->endCelEdit();
+
+    emit changed();
+}
+
+
+/*!
+    Returns the lifted pixels, null if the selection isn't floating.
+*/
+QImage Selection::floatingImage() {
+    return _floating;
+}
+
+
+/*!
+    Returns where the floating pixels are on the Cel (after being moved and scaled).
+*/
+QRectF Selection::floatRect() {
+    return QRectF(QPointF(_bounds.topLeft()) + _floatOffset, QSizeF(_bounds.size()) * _floatScale);
+}
+
+
+/*!
+    Returns how far the floating pixels have been moved.
+*/
+QPointF Selection::floatOffset() {
+    return _floatOffset;
+}
+
+
+/*!
+    Returns how much the floating pixels have been scaled.
+*/
+qreal Selection::floatScale() {
+    return _floatScale;
+}
+
+
+/*!
+    Moves the floating pixels by \a offset from where they were lifted, and scales them by
+    \a scale (from their top left corner).  Only the preview is changed, not the Cel.
+*/
+void Selection::setFloatTransform(QPointF offset, qreal scale) {
+    if (!isFloating())
+        return;
+
+    _floatOffset = offset;
+    _floatScale = qMax((qreal)0.01, scale);
+    emit changed();
+}
+
+
+/*!
+    Draws the floating pixels back into the Cel where they've been moved to, in one pass.  The
+    selection is moved along with them.  Does nothing if the selection isn't floating.
+
+    If the Cel isn't loaded up anymore (e.g. its Frame was just deactivated), the pixels are
+    drawn into a copy of its image that's saved back.  That can't be undone, but the pixels
+    aren't lost.
+*/
+void Selection::commit() {
+    if (!isFloating())
+        return;
+
+    if (!_cel) {
+        _floating = QImage();
+        emit changed();
+        return;
+    }
+
+    // Make it one undo step if it's not already part of one (only when loaded)
+    UndoHistory *history = BlitApp::app()->history();
+    bool ownEdit = _cel->imageData() && !history->editing();
+    if (ownEdit)
+        history->beginCelEdit(_cel);
+
+    QImage copy;
+    QImage *img = _cel->imageData();
+    if (!img) {
+        copy = _cel->image().convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        img = &copy;
+    }
+
+    QRectF target = floatRect();
+    QRect dest = target.toAlignedRect();
+
+    _busy = true;
+    QPainter p(img);
+    p.drawImage(target, _floating);
+    p.end();
+    if (copy.isNull())
+        _cel->damage(dest & img->rect());
+    else
+        _cel->setImage(copy);
+    _busy = false;
+
+    if (ownEdit)
+        history->endCelEdit();
+
+    // Selection goes to where the pixels went
+    QImage m = _mask.scaled(dest.size(), Qt::IgnoreAspectRatio, Qt::FastTransformation);
+    _floating = QImage();
+    _set(_cel, m, dest);
+}
+
+
+/*!
+    Deselects everything.  Floating pixels are committed first.
+*/
+void Selection::clear() {
+    commit();
+    endEdit();
+
+    _cel = NULL;
+    _mask = QImage();
+    _bounds = QRect();
+    _outline = QPainterPath();
+    _preview = QPolygonF();
+    _floating = QImage();
+
+    emit changed();
+}
+
+
+/*!
+    Starts keeping edits to the current Cel inside of the selection.  Does nothing if there
+    isn't a selection on the current Cel, or if the selection is floating.
+
+    \sa endEdit()
+*/
+void Selection::beginEdit() {
+    if (_editing)
+        endEdit();
+
+    if (isEmpty() || isFloating() || (BlitApp::app()->curCel() != _cel) || !_cel->imageData())
+        return;
+
+    // Shallow copy, the Cel detaches from it on its first change
+    _editBefore = *_cel->imageData();
+    _editing = true;
+    connect(_cel, &Cel::damaged, this, &Selection::_onCelDamaged);
+}
+
+
+/*!
+    Stops keeping edits inside of the selection.
+
+    \sa beginEdit()
+*/
+void Selection::endEdit() {
+    if (!_editing)
+        return;
+
+    if (_cel)
+        disconnect(_cel, &Cel::damaged, this, &Selection::_onCelDamaged);
+
+    _editBefore = QImage();
+    _editing = false;
+}
+
+
+/*!
+    Called via Cel::damaged() while an edit is going on.  Puts back whatever was changed outside
+    of the selection.
+*/
+void Selection::_onCelDamaged(QRect rect) {
+    if (!_busy)
+        _clip(rect);
+}
+
+
+/*!
+    Internal function.  Sets the selection to \a mask at \a bounds on \a cel.  Anything that's
+    totally outside of the Cel is trimmed off.
+*/
+void Selection::_set(PNGCel *cel, QImage mask, QRect bounds) {
+    // Don't leave something floating on another Cel
+    if (isFloating() && (cel != _cel))
+        commit();
+
+    QRect clipped = bounds & QRect(QPoint(0, 0), cel->size());
+    _cel = cel;
+    _bounds = clipped;
+    _mask = mask.copy(clipped.translated(-bounds.topLeft()));
+    _preview = QPolygonF();
+
+    // Outline is made once, not every paint
+    _outline = QPainterPath();
+    if (!_bounds.isEmpty()) {
+        QRegion region(QBitmap::fromImage(_mask.createAlphaMask()));
+        _outline.addRegion(region.translated(_bounds.topLeft()));
+        _outline = _outline.simplified();
+    }
+
+    emit changed();
+}
+
+
+/*!
+    Internal function.  Restores everything inside of \a rect (in Cel coordinates) that isn't
+    selected from the image before the edit.  Partly selected pixels are mixed.
+*/
+void Selection::_clip(QRect rect) {
+    if (!_cel)
+        return;
+
+    QImage *img = _cel->imageData();
+    if (!img || (img->size() != _editBefore.size()) || (img->format() != _editBefore.format()) || (img->depth() != 32))
+        return;
+
+    rect &= img->rect();
+    if (rect.isEmpty())
+        return;
+
+    // Split each row into what's left of the mask, on the mask, and right of it
+    int midL = qBound(rect.left(), _bounds.left(), rect.right() + 1);
+    int midR = qBound(rect.left(), _bounds.right() + 1, rect.right() + 1);
+    int leftN = midL - rect.left();
+    int midN = midR - midL;
+    int rightN = rect.right() + 1 - midR;
+
+    for (int y = rect.top(); y <= rect.bottom(); y++) {
+        QRgb *dest = (QRgb *)img->scanLine(y);
+        const QRgb *src = (const QRgb *)_editBefore.constScanLine(y);
+
+        if ((y < _bounds.top()) || (y > _bounds.bottom())) {
+            // Whole row is outside
+            std::memcpy(dest + rect.left(), src + rect.left(), rect.width() * sizeof(QRgb));
+            continue;
+        }
+
+        const uchar *m = _mask.constScanLine(y - _bounds.top()) + (midL - _bounds.left());
+        std::memcpy(dest + rect.left(), src + rect.left(), leftN * sizeof(QRgb));
+        util::blendRow(dest + midL, src + midL, m, midN);
+        std::memcpy(dest + midR, src + midR, rightN * sizeof(QRgb));
+    }
+}
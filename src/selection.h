@@ -0,0 +1,97 @@
+// File:         selection.h
+// Author:       Ben Summerton (define-private-public)
+// Description:  Selection is a masked area of a Cel.  While there is one, drawing only changes the
+//               pixels inside of it.  The selected pixels can also be lifted up and moved/scaled.
+
+
+#ifndef SELECTION_H
+#define SELECTION_H
+
+
+#include <QObject>
+#include <QPointer>
+#include <QImage>
+#include <QRect>
+#include <QRectF>
+#include <QPointF>
+#include <QPolygonF>
+#include <QPainterPath>
+class PNGCel;
+
+
+class Selection : public QObject {
+    Q_OBJECT;
+
+public:
+    Selection(QObject *parent=NULL);
+    ~Selection();
+
+    // Info
+    bool isEmpty();
+    PNGCel *cel();
+    QRect bounds();
+    QImage mask();
+    QPainterPath outline();
+    bool contains(QPoint pt);
+
+    // Making a selection (all in Cel coordinates)
+    void selectRect(PNGCel *cel, QRect rect);
+    void selectPolygon(PNGCel *cel, QPolygonF poly);
+    void selectMask(PNGCel *cel, QImage mask, QRect bounds);
+
+    // Outline of a selection that's still being made
+    QPolygonF preview();
+    void setPreview(QPolygonF poly);
+
+    // Floating
+    bool isFloating();
+    void lift();
+    QImage floatingImage();
+    QRectF floatRect();
+    QPointF floatOffset();
+    qreal floatScale();
+    void setFloatTransform(QPointF offset, qreal scale);
+
+    // Keeping edits inside of the mask
+    void beginEdit();
+
+
+public slots:
+    void commit();
+    void clear();
+    void endEdit();
+
+
+signals:
+    void changed();
+
+
+private slots:
+    void _onCelDamaged(QRect rect);
+
+
+private:
+    void _set(PNGCel *cel, QImage mask, QRect bounds);
+    void _clip(QRect rect);
+
+    // The selection
+    QPointer<PNGCel> _cel;            // Cel that the selection is on, NULL if nothing is selected
+    QImage _mask;                    // 8 bit coverage of the selection, only as big as _bounds
+    QRect _bounds;                    // Where _mask is on the Cel
+    QPainterPath _outline;            // Cached outline of _mask (in Cel coordinates)
+    QPolygonF _preview;                // Used by the SelectTool while dragging out a selection
+
+    // Floating
+    QImage _floating;                // Lifted pixels (premultiplied, already masked), null if not floating
+    QPointF _floatOffset;            // How far it's been moved from _bounds
+    qreal _floatScale = 1;            // How much it's been scaled up/down
+
+    // Edit state
+    QImage _editBefore;                // Cel's image before the edit started (shallow copy)
+    bool _editing = false;
+    bool _busy = false;                // Set when the Selection is changing the Cel itself
+
+};
+
+
+#endif // SELECTION_H
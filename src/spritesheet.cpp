@@ -37,7 +37,9 @@
 
 namespace Spritesheet {
     /*!
-        Converts the Frames in an Animation to a spritesheet (in a QImage).  This function assumes
+        Converts the Frames in an Animation to a spritesheet (in a QImage).  There's one sprite
+        for each stretch of the sequence where none of the XSheet's planes change, and it has all
+        of the planes composited together.  This function assumes
         that anim is not Null, order is either set to SPRITESHEET_ROW_MAJOR or SPRITESHEET_COLUMN_MAJOR,
         numPerOrder is a positive integer, and scale is a positive integer as well.  If any of these
         variables do not pass the sniff test, animationToSpritesheet() will return a Null QImage.
@@ -54,8 +56,9 @@ namespace Spritesheet {
 
         // Passed smell test, More vars
         QSize frameSize(anim->frameSize() * scale);
-        QList<QPointer<TimedFrame>> frames = anim->xsheet()->frames();
-        int numFrames = frames.size();
+        XSheet *xsheet = anim->xsheet();
+        QList<int> seqNums = changeSeqNums(xsheet);
+        int numFrames = seqNums.size();
         numPerOrder = (numPerOrder < numFrames) ? numPerOrder : numFrames;    // Trim to a good size
 
         // set rows and columns
@@ -91,12 +94,38 @@ namespace Spritesheet {
 
             // Draw the inage
             rect.setSize(frameSize);
-            qp.drawImage(rect, frames[i]->frame()->render());
+            qp.drawImage(rect, xsheet->render(seqNums[i]));
         }
 
         // All done!
         return spritesheet;
     }
+
+
+    /*!
+        Returns the sequence numbers in the XSheet where what's showing changes, in any of the
+        planes.  The first one is always 1 (if the XSheet isn't empty).  With one plane, these
+        are just where each TimedFrame starts.
+    */
+    QList<int> changeSeqNums(XSheet *xsheet) {
+        QList<int> seqNums;
+        int seqNum = 1;
+        while (seqNum <= xsheet->seqLength()) {
+            seqNums.append(seqNum);
+
+            // Goes until the first plane to switch frames (or run out)
+            int last = xsheet->seqLength();
+            for (int plane = 0; plane < xsheet->numPlanes(); plane++) {
+                TimedFrame *tf = xsheet->frameAtSeq(seqNum, plane);
+                if (tf)
+                    last = qMin(last, tf->seqNum() + tf->hold() - 1);
+            }
+
+            seqNum = last + 1;
+        }
+
+        return seqNums;
+    }
 };
 
 
@@ -186,7 +215,7 @@ void SpritesheetDialog::setAnim(Animation *anim) {
     _anim = anim;
     if (_anim) {
         _ui->frameSizeLabel->setText(util::sizeToStr(_anim->frameSize() * _scale));
-        _ui->fpoSpinner->setMaximum(_anim->xsheet()->numFrames());
+        _ui->fpoSpinner->setMaximum(Spritesheet::changeSeqNums(_anim->xsheet()).size());
     }
     _generatePreview();
 }
@@ -210,7 +239,7 @@ void SpritesheetDialog::_generatePreview() {
 
         if (_anim) {
             frameSize = _anim->frameSize() * _scale;
-            numFrames = _anim->xsheet()->numFrames();
+            numFrames = Spritesheet::changeSeqNums(_anim->xsheet()).size();
         }
 
         QPainter painter(&sheet);
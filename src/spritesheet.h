@@ -25,6 +25,7 @@
 
 #include <QDialog>
 class Animation;
+class XSheet;
 class ColorFrame;
 class QColor;
 class QImage;
@@ -39,6 +40,7 @@ class QScrollArea;
 // Utility functions
 namespace Spritesheet {
     QImage animationToSpritesheet(Animation *anim, int order=SPRITESHEET_ROW_MAJOR, int numPerOrder=SPRITESHEET_DEFAULT_NUM_PER_ORDER, QColor background=SPRITESHEET_TRANSPARENT, int scale=1);
+    QList<int> changeSeqNums(XSheet *xsheet);
 };
 
 
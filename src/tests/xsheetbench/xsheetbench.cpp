@@ -0,0 +1,114 @@
+// File:         xsheetbench.cpp
+// Author:       Ben Summerton (define-private-public)
+// Description:  Benchmarks for the XSheet on a 100k exposure sheet.  Times looking up frames by
+//               sequence number, adding frames in the middle, and changing holds.
+
+
+#include "animation/xsheet.h"
+#include "animation/timedframe.h"
+#include <QtTest>
+#include <cstdio>
+
+
+#define XSHEET_BENCH_EXPOSURES 100000        // Sequence length of the sheet
+#define XSHEET_BENCH_STRIDE 97                // Step between the lookups (so they're spread out)
+
+
+// The XSheet & TimedFrames print a line for everything, that would be all that's timed
+static void quietMessageHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg) {
+    Q_UNUSED(context);
+
+    if (type != QtDebugMsg)
+        fprintf(stderr, "%s\n", qPrintable(msg));
+}
+
+
+class XSheetBench : public QObject {
+    Q_OBJECT;
+
+private slots:
+    void initTestCase();
+    void init();
+    void cleanup();
+
+    void frameAtSeq();
+    void addFrameInMiddle();
+    void setHoldInMiddle();
+
+
+private:
+    XSheet *_xsheet = NULL;
+
+};
+
+
+void XSheetBench::initTestCase() {
+    qInstallMessageHandler(quietMessageHandler);
+}
+
+
+void XSheetBench::init() {
+    // Holds of 1 and 3, two frames for every four exposures
+    _xsheet = new XSheet(NULL);
+    for (int i = 0; i < (XSHEET_BENCH_EXPOSURES / 2); i++)
+        _xsheet->addFrame(new TimedFrame(NULL, TIMED_FRAME_DEFAULT_SEQ_NUM, (i % 2) ? 3 : 1));
+
+    QCOMPARE(_xsheet->seqLength(), XSHEET_BENCH_EXPOSURES);
+}
+
+
+void XSheetBench::cleanup() {
+    delete _xsheet;
+    _xsheet = NULL;
+}
+
+
+void XSheetBench::frameAtSeq() {
+    int found = 0;
+    QBENCHMARK {
+        found = 0;
+        for (int seq = 1; seq <= XSHEET_BENCH_EXPOSURES; seq += XSHEET_BENCH_STRIDE) {
+            if (_xsheet->frameAtSeq(seq))
+                found++;
+        }
+    }
+
+    QCOMPARE(found, ((XSHEET_BENCH_EXPOSURES - 1) / XSHEET_BENCH_STRIDE) + 1);
+
+    // And that they're the right ones
+    for (int seq = 1; seq <= XSHEET_BENCH_EXPOSURES; seq += XSHEET_BENCH_STRIDE)
+        QVERIFY(_xsheet->frameAtSeq(seq)->hasSeqNum(seq));
+}
+
+
+void XSheetBench::addFrameInMiddle() {
+    int added = 0;
+    QBENCHMARK {
+        _xsheet->addFrame(new TimedFrame(NULL), _xsheet->seqLength() / 2);
+        added++;
+    }
+
+    QCOMPARE(_xsheet->seqLength(), XSHEET_BENCH_EXPOSURES + added);
+    QCOMPARE(_xsheet->numFrames(), (XSHEET_BENCH_EXPOSURES / 2) + added);
+}
+
+
+void XSheetBench::setHoldInMiddle() {
+    QList<QPointer<TimedFrame>> frames = _xsheet->frames();
+    TimedFrame *tf = frames.at(frames.size() / 2);
+    TimedFrame *last = frames.last();
+    QVERIFY(tf && last);
+
+    QBENCHMARK {
+        tf->setHold(tf->hold() + 1);
+    }
+
+    // Everything after it has to have moved along
+    QVERIFY(_xsheet->frameAtSeq(tf->seqNum()) == tf);
+    QCOMPARE(last->seqNum() + last->hold() - 1, _xsheet->seqLength());
+    QVERIFY(_xsheet->frameAtSeq(_xsheet->seqLength()) == last);
+}
+
+
+QTEST_GUILESS_MAIN(XSheetBench)
+#include "xsheetbench.moc"
@@ -0,0 +1,29 @@
+# Benchmark for the XSheet's lookups and edits on a long (100k exposure) sheet.
+#
+#   qmake && make && ./xsheetbench
+#
+# It's built against all of Blit's sources, but doesn't start up a BlitApp.  The file lists are
+# read out of ../../blit.pro, so there's nothing to keep in sync here.
+
+TEMPLATE = app
+TARGET = xsheetbench
+CONFIG += c++14 testcase
+
+
+BLIT_DIR = $$PWD/../..
+BLIT_QT = $$fromfile($$BLIT_DIR/blit.pro, QT)
+BLIT_HEADERS = $$fromfile($$BLIT_DIR/blit.pro, HEADERS)
+BLIT_SOURCES = $$fromfile($$BLIT_DIR/blit.pro, SOURCES)
+BLIT_FORMS = $$fromfile($$BLIT_DIR/blit.pro, FORMS)
+
+QT += $$BLIT_QT testlib
+INCLUDEPATH += $$BLIT_DIR
+
+for(file, BLIT_HEADERS): HEADERS += $$BLIT_DIR/$$file
+for(file, BLIT_FORMS): FORMS += $$BLIT_DIR/$$file
+for(file, BLIT_SOURCES) {
+    # Blit's main() would clash with the one QTest makes
+    !equals(file, main.cpp): SOURCES += $$BLIT_DIR/$$file
+}
+
+SOURCES += xsheetbench.cpp
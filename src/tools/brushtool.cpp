@@ -20,10 +20,8 @@
 #include <QColor>
 #include <QIcon>
 #include <QPixmap>
-#include <QPainter>
-#include <QBrush>
-#include <QRadialGradient>
-#include <QLinearGradient>
+#include <QSpinBox>
+#include <QFormLayout>
 #include <QGraphicsSceneMouseEvent>
 
 
@@ -37,14 +35,7 @@
 BrushTool::BrushTool(QObject *parent) :
     Tool(parent)
 {
-    // Some pen defaults
-    _pen.setCapStyle(Qt::RoundCap);
-    _pen.setJoinStyle(Qt::RoundJoin);
-
-    // TODO remove
-    _pen.setWidth(_size);
-//    _brush.setStyle(Qt::RadialGradientPattern);
-//    _brush.setColor(_pen.color());
+    // Do nothing
 }
 
 
@@ -82,6 +73,42 @@ QIcon BrushTool::icon() {
 }
 
 
+/*!
+    Returns a panel to change the size and hardness of the Brush.
+*/
+QWidget *BrushTool::options() {
+    void (QSpinBox::*spinnerValueChanged)(int) = &QSpinBox::valueChanged;
+
+    // Make the options panel
+    QWidget *optionsPanel = new QWidget();
+    optionsPanel->setMaximumWidth(TOOL_OPTIONS_PANEL_MAX_WIDTH);
+
+    // Size
+    QSpinBox *sizeSpinner = new QSpinBox(optionsPanel);
+    sizeSpinner->setMinimum(1);
+    sizeSpinner->setMaximum(256);
+    sizeSpinner->setValue(_size);
+
+    // Hardness
+    QSpinBox *hardnessSpinner = new QSpinBox(optionsPanel);
+    hardnessSpinner->setMinimum(0);
+    hardnessSpinner->setMaximum(100);
+    hardnessSpinner->setSuffix("%");
+    hardnessSpinner->setValue(_hardness);
+
+    // Layout
+    QFormLayout *layout = new QFormLayout(optionsPanel);
+    layout->addRow(tr("Size:"), sizeSpinner);
+    layout->addRow(tr("Hardness:"), hardnessSpinner);
+
+    // Signals & slots
+    connect(sizeSpinner, spinnerValueChanged, this, &BrushTool::_onSizeSpinnerValueChanged);
+    connect(hardnessSpinner, spinnerValueChanged, this, &BrushTool::_onHardnessSpinnerValueChanged);
+
+    return optionsPanel;
+}
+
+
 /*!
     Doesn't do anything right now.
 */
@@ -98,11 +125,8 @@ void BrushTool::onMouseMoved(QGraphicsSceneMouseEvent *event) {
     if (!_brushDown)
         return;
 
-    // First move to the point
-    _path->lineTo(event->scenePos() - _celPos);
-
-    // Transfer the drawing
-    _transferDrawing();
+    // Stamp along the new segment only
+    _dabs.strokeTo(event->scenePos() - _celPos);
 }
 
 
@@ -119,22 +143,16 @@ void BrushTool::onMousePressed(QGraphicsSceneMouseEvent *event) {
     if (!ref)
         return;
 
+    // Setup the stroke
+    if (!_dabs.begin(_size, _hardness / 100.0, BlitApp::app()->curColor()))
+        return;
+
     // Put the Brush down
     _brushDown = true;
-
-    // Setup the painter and buffer objects
-    // Make the path
-    // TODO, isn't drawing a starting point
-    _path = new QPainterPath();
-    _path->moveTo(event->scenePos() - _celPos);
-//    _path->lineTo(event->scenePos() - _celPos);
-
-    // Setup buffer/state vars and start drawing
     _celPos = ref->pos();
-    _celImage = new QImage(BlitApp::app()->celImage());
 
     // Draw the first point
-    _transferDrawing();
+    _dabs.stamp(event->scenePos() - _celPos);
 }
 
 
@@ -148,43 +166,25 @@ void BrushTool::onMouseReleased(QGraphicsSceneMouseEvent *event) {
 
     // release brush & stop painting
     _brushDown = false;
-    
-    // reset path
-    delete _path;
-    _path = NULL;
+    _dabs.end();
 
     // Cleanup state vars
     _celPos = QPointF();
-    delete _celImage;
-    _celImage = NULL;
 }
 
 
 /*!
-    Internal function to transfer the drawing to the Current Cel
+    Changes the size (diameter) of the Brush.
 */
-void BrushTool::_transferDrawing() {
-    // Check that the brush is down
-    if (!_brushDown)
-        return;
+void BrushTool::_onSizeSpinnerValueChanged(int value) {
+    _size = value;
+}
 
-    // Make a gradient
-    QRadialGradient radGrad = QRadialGradient(_path->currentPosition() - _celPos, _size);
-    radGrad.setColorAt(0, BlitApp::app()->curColor());
-    radGrad.setColorAt(1, Qt::transparent);
-    QBrush radBrush(radGrad);
-    _pen.setBrush(radBrush);
-    //    _brush.setColor(_pen.color());
-
-
-    // Then put it onto the Cel
-    QImage celBuff = _celImage->copy();
-    QPainter celBuffPainter(&celBuff);
-    celBuffPainter.setPen(_pen);
-    celBuffPainter.drawPath(*_path);
-//    celBuffPainter.fillPath(*_path, _brush);
-
-    // Apply the update
-    BlitApp::app()->copyOntoCel(celBuff);
-    celBuff.save("/tmp/celBuff.png");
+
+/*!
+    Changes how much of the Brush's tip is solid before it fades out.
+*/
+void BrushTool::_onHardnessSpinnerValueChanged(int value) {
+    _hardness = value;
 }
+
@@ -9,10 +9,8 @@
 
 
 #include "tools/tool.h"
-#include <QPen>
-#include <QBrush>
-class QImage;
-class QPainterPath;
+#include "tools/dabengine.h"
+#include <QPointF>
 
 
 class BrushTool : public Tool {
@@ -29,6 +27,8 @@ public:
     QString desc();
     QIcon icon();
 
+    QWidget *options();
+
 
 public slots:
     // For drawing
@@ -38,23 +38,22 @@ public slots:
     void onMouseReleased(QGraphicsSceneMouseEvent *event);
 
 
-private:
-    // Internal functions
-    void _transferDrawing();
+private slots:
+    void _onSizeSpinnerValueChanged(int value);
+    void _onHardnessSpinnerValueChanged(int value);
+
 
+private:
     // Member vars
     int _size = 5;
-    QPen _pen;
-    QBrush _brush;
+    int _hardness = 50;            // Percent of the tip that is solid
+    DabEngine _dabs;
 
     // State variables for when painting
     bool _brushDown = false;
-    QPainterPath *_path = NULL;
     QPointF _celPos;
-    QImage *_celImage = NULL;
 
 };
 
 
 #endif // BRUSH_TOOL_H
-
@@ -6,12 +6,16 @@
 #include "tools/colorpickertool.h"
 #include "blitapp.h"
 #include "animation/celref.h"
+#include "animation/cel.h"
+#include "animation/pngcel.h"
+#include "widgets/drawing/canvas.h"
 #include <QtMath>
 #include <QPixmap>
 #include <QIcon>
+#include <QImage>
+#include <QComboBox>
+#include <QFormLayout>
 #include <QGraphicsSceneMouseEvent>
-#include <QGuiApplication>
-#include <QScreen>
 
 
 
@@ -61,6 +65,34 @@ QIcon ColorPickerTool::icon() {
 }
 
 
+/*!
+    Returns a panel to choose where colors are picked from.
+*/
+QWidget *ColorPickerTool::options() {
+    void (QComboBox::*currentIndexChanged)(int) = &QComboBox::currentIndexChanged;
+
+    // Make the options panel
+    QWidget *optionsPanel = new QWidget();
+    optionsPanel->setMaximumWidth(TOOL_OPTIONS_PANEL_MAX_WIDTH);
+
+    // Sample source
+    QComboBox *sampleBox = new QComboBox(optionsPanel);
+    sampleBox->insertItem(SampleCel, tr("Current Cel"));
+    sampleBox->insertItem(SampleFrame, tr("Frame"));
+    sampleBox->insertItem(SampleLightTable, tr("Frame & Light Table"));
+    sampleBox->setCurrentIndex((int)_sample);
+
+    // Layout
+    QFormLayout *layout = new QFormLayout(optionsPanel);
+    layout->addRow(tr("Sample:"), sampleBox);
+
+    // Signals & slots
+    connect(sampleBox, currentIndexChanged, this, &ColorPickerTool::_onSampleBoxChanged);
+
+    return optionsPanel;
+}
+
+
 /*!
     If the color picking process is started, this will change the color that is
     being chosen.
@@ -68,8 +100,7 @@ QIcon ColorPickerTool::icon() {
 void ColorPickerTool::onMouseMoved(QGraphicsSceneMouseEvent *event){
     if (_picking) {
         // Set the current color
-        QPoint pos = event->screenPos();
-        QColor clr = _getColorAt(pos.x(), pos.y());
+        QColor clr = _getColorAt(event->scenePos());
         if (clr.isValid())
             BlitApp::app()->setCurColor(clr);
     }
@@ -78,22 +109,14 @@ void ColorPickerTool::onMouseMoved(QGraphicsSceneMouseEvent *event){
 
 /*!
     When the mouse is pressed, the color picking process will start.
-    
-    It will take a screenshot of the current screen.
 */
 void ColorPickerTool::onMousePressed(QGraphicsSceneMouseEvent *event){
     if (!_picking) {
         // Onyly start picking if we aren't already
         _picking = true;
 
-        // Take a screenshot
-        QScreen *screen = QGuiApplication::primaryScreen();
-        if (screen)
-            _screenshot = screen->grabWindow(0).toImage();
-
         // Set the current color
-        QPoint pos = event->screenPos();
-        QColor clr = _getColorAt(pos.x(), pos.y());
+        QColor clr = _getColorAt(event->scenePos());
         if (clr.isValid())
             BlitApp::app()->setCurColor(clr);
     }
@@ -112,18 +135,46 @@ void ColorPickerTool::onMouseReleased(QGraphicsSceneMouseEvent *event){
 
 
 /*!
-    Returns the color at pixel location (\a x, \a y).  Returns an invalid
-    QColor of the location doesn't exist.
+    Changes where the colors are picked from.
 */
-QColor ColorPickerTool::_getColorAt(int x, int y) {
-    QColor clr;
-
-    // Check location first
-    if ((x >= _screenshot.width()) || (y >= _screenshot.height()))
-        return clr;            // Returns as invalid
-    
-    // good location
-    clr.setRgb(_screenshot.pixel(x, y));
-    return clr;
+void ColorPickerTool::_onSampleBoxChanged(int index) {
+    _sample = (Sample)index;
 }
 
+
+/*!
+    Returns the color at \a scenePos, from either the current Cel or the composited Frame
+    (see Sample).  Returns an invalid QColor if there isn't anything there.
+*/
+QColor ColorPickerTool::_getColorAt(QPointF scenePos) {
+    if (_sample != SampleCel)
+        return BlitApp::app()->canvas()->sampleColor(scenePos, _sample == SampleLightTable);
+
+    // Current Cel only
+    CelRef *ref = BlitApp::app()->curCelRef();
+    Cel *cel = BlitApp::app()->curCel();
+    if (!ref || !cel || (cel->type() != PNG_CEL_TYPE))
+        return QColor();
+
+    QPointF pt = scenePos - ref->pos();
+    QPoint px(qFloor(pt.x()), qFloor(pt.y()));
+    PNGCel *pc = (PNGCel *)cel;
+    QImage *img = pc->imageData();
+    QImage tmp;
+    if (!img) {
+        tmp = pc->image();
+        img = &tmp;
+    }
+
+    if (!img->rect().contains(px))
+        return QColor();
+
+    // pixel() gives back premultiplied values for premultiplied images
+    QRgb clr = img->pixel(px);
+    if (qAlpha(clr) == 0)
+        return QColor();
+    else if (img->format() == QImage::Format_ARGB32_Premultiplied)
+        return QColor::fromRgba(qUnpremultiply(clr));
+    else
+        return QColor::fromRgba(clr);
+}
@@ -12,7 +12,7 @@
 
 #include "tools/tool.h"
 #include <QPointF>
-#include <QImage>
+#include <QColor>
 
 
 class ColorPickerTool : public Tool {
@@ -21,6 +21,9 @@ class ColorPickerTool : public Tool {
 
 
 public:
+    // Where the colors are picked from
+    enum Sample {SampleCel, SampleFrame, SampleLightTable};
+
     ColorPickerTool(QObject *parent=NULL);
     ~ColorPickerTool();
 
@@ -29,6 +32,8 @@ public:
     QString desc();
     QIcon icon();
 
+    QWidget *options();
+
 
 public slots:
     // For drawing
@@ -37,13 +42,17 @@ public slots:
     void onMouseReleased(QGraphicsSceneMouseEvent *event);
 
 
+private slots:
+    void _onSampleBoxChanged(int index);
+
+
 private:
     // Member functions
-    QColor _getColorAt(int x, int y);
+    QColor _getColorAt(QPointF scenePos);
 
     // Member vars
     bool _picking = false;
-    QImage _screenshot;
+    Sample _sample = SampleFrame;
 };
 
 
@@ -0,0 +1,184 @@
+// File:         dabengine.cpp
+// Author:       Ben Summerton (define-private-public)
+// Description:  Source implementation of the DabEngine class
+
+
+/*!
+    \class DabEngine
+    \brief DabEngine draws brush strokes out of stamps of a pre-rendered tip.
+
+    A tip (a soft round dab of color) is rendered once for each size, hardness, and color, and
+    kept in a small cache.  As the stroke moves, the tip is stamped at a fixed spacing along
+    only the newest segment; where the last dab fell is carried over to the next segment so
+    the spacing stays even no matter how the mouse events come in.
+
+    Dabs are blended right into the Cel's image (see PNGCel::imageData()) and only the area
+    that was stamped on is reported with PNGCel::damage().  So the cost of each segment only
+    depends on how long it is, not on how long the whole stroke is or the size of the Cel.
+*/
+
+
+#include "tools/dabengine.h"
+#include "blitapp.h"
+#include "animation/cel.h"
+#include "animation/pngcel.h"
+#include <QPainter>
+#include <QRadialGradient>
+#include <QLineF>
+#include <QRect>
+#include <QtMath>
+
+
+DabEngine::DabEngine() :
+    _tips(DAB_TIP_CACHE_SIZE)
+{
+    // Do nothing
+}
+
+
+DabEngine::~DabEngine() {
+    // Do nothing
+}
+
+
+/*!
+    Starts a new stroke on the current Cel.  \a size is the diameter of the tip, \a hardness
+    (0.0 to 1.0) is how much of the tip is solid before it fades out, and \a clr is the color.
+    \a spacing is the distance between dabs as a fraction of \a size.
+
+    Returns false if there isn't a current Cel that can be drawn on.
+*/
+bool DabEngine::begin(qreal size, qreal hardness, QColor clr, qreal spacing) {
+    end();
+
+    // Only PNGCels that are loaded can be painted in place
+    Cel *cel = BlitApp::app()->curCel();
+    if (!cel || (cel->type() != PNG_CEL_TYPE))
+        return false;
+
+    PNGCel *pc = (PNGCel *)cel;
+    if (!pc->imageData())
+        return false;
+
+    // Setup state
+    _cel = pc;
+    _curTip = _tip(size, hardness, clr);
+    _spacing = qMax((qreal)1, size * spacing);
+    _carry = 0;
+
+    return true;
+}
+
+
+/*!
+    Finishes up the current stroke.
+*/
+void DabEngine::end() {
+    _cel = NULL;
+    _curTip = QImage();
+}
+
+
+/*!
+    Returns true if a stroke is currently being drawn.
+*/
+bool DabEngine::active() {
+    return !_cel.isNull();
+}
+
+
+/*!
+    Stamps a single dab centered at \a pt and makes it the start of the next segment.  Should
+    be used for the first point of a stroke.
+*/
+void DabEngine::stamp(QPointF pt) {
+    if (!active())
+        return;
+
+    // Center the tip on the pixel
+    QPoint topLeft(qRound(pt.x() - (_curTip.width() / 2.0)), qRound(pt.y() - (_curTip.height() / 2.0)));
+
+    QPainter p(_cel->imageData());
+    p.drawImage(topLeft, _curTip);
+    p.end();
+
+    _cel->damage(QRect(topLeft, _curTip.size()));
+
+    _lastPoint = pt;
+    _carry = _spacing;
+}
+
+
+/*!
+    Stamps dabs along the segment from the end of the stroke to \a pt.
+*/
+void DabEngine::strokeTo(QPointF pt) {
+    if (!active())
+        return;
+
+    QLineF seg(_lastPoint, pt);
+    qreal len = seg.length();
+    if (_carry > len) {
+        // Not far enough for another dab yet
+        _carry -= len;
+        _lastPoint = pt;
+        return;
+    }
+
+    // Stamp them all with one painter, and keep track of what's been touched
+    QImage *img = _cel->imageData();
+    QPainter p(img);
+    QRect dirty;
+    qreal halfW = _curTip.width() / 2.0;
+    qreal halfH = _curTip.height() / 2.0;
+
+    qreal dist = _carry;
+    for (; dist <= len; dist += _spacing) {
+        QPointF at = seg.pointAt(dist / len);
+        QPoint topLeft(qRound(at.x() - halfW), qRound(at.y() - halfH));
+        p.drawImage(topLeft, _curTip);
+        dirty |= QRect(topLeft, _curTip.size());
+    }
+    p.end();
+
+    // Next dab goes this far into the next segment
+    _carry = dist - len;
+    _lastPoint = pt;
+
+    _cel->damage(dirty & img->rect());
+}
+
+
+/*!
+    Internal function.  Returns a rendered tip for \a size, \a hardness, and \a clr.  They're
+    only rendered the first time they're asked for.
+*/
+QImage DabEngine::_tip(qreal size, qreal hardness, QColor clr) {
+    QString key = QString("%1:%2:%3").arg(size).arg(hardness).arg(clr.rgba());
+    QImage *cached = _tips.object(key);
+    if (cached)
+        return *cached;
+
+    // Render it, fully solid out to the hardness then fade
+    int d = qMax(1, qCeil(size));
+    QImage *tip = new QImage(d, d, QImage::Format_ARGB32_Premultiplied);
+    tip->fill(Qt::transparent);
+
+    QColor clear(clr);
+    clear.setAlpha(0);
+
+    QRadialGradient grad(QPointF(d / 2.0, d / 2.0), size / 2.0);
+    grad.setColorAt(0, clr);
+    grad.setColorAt(qBound((qreal)0, hardness, (qreal)0.999), clr);
+    grad.setColorAt(1, clear);
+
+    QPainter p(tip);
+    p.setRenderHint(QPainter::Antialiasing);
+    p.setPen(Qt::NoPen);
+    p.setBrush(grad);
+    p.drawEllipse(QRectF(0, 0, d, d));
+    p.end();
+
+    _tips.insert(key, tip);
+    return *tip;
+}
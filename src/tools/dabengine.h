@@ -0,0 +1,53 @@
+// File:         dabengine.h
+// Author:       Ben Summerton (define-private-public)
+// Description:  DabEngine draws brush strokes by stamping a pre-rendered tip (a "dab") at a fixed
+//               spacing along the stroke.  Used by the BrushTool.
+
+
+#ifndef DAB_ENGINE_H
+#define DAB_ENGINE_H
+
+
+#define DAB_DEFAULT_SPACING 0.15        // Distance between dabs, as a fraction of the tip's diameter
+#define DAB_TIP_CACHE_SIZE 16            // How many rendered tips to keep around
+
+
+#include <QPointF>
+#include <QColor>
+#include <QImage>
+#include <QPointer>
+#include <QCache>
+#include <QString>
+class PNGCel;
+
+
+class DabEngine {
+
+public:
+    DabEngine();
+    ~DabEngine();
+
+    // Stroke lifetime
+    bool begin(qreal size, qreal hardness, QColor clr, qreal spacing=DAB_DEFAULT_SPACING);
+    void end();
+    bool active();
+
+    // Drawing (in Cel coordinates)
+    void stamp(QPointF pt);
+    void strokeTo(QPointF pt);
+
+
+private:
+    QImage _tip(qreal size, qreal hardness, QColor clr);
+
+    QPointer<PNGCel> _cel;            // Cel being drawn on, NULL when not in a stroke
+    QImage _curTip;                    // Tip for the current stroke
+    qreal _spacing = 1;                // Distance between dabs, in pixels
+    QPointF _lastPoint;                // End of the stroke so far
+    qreal _carry = 0;                // How far along the next dab is from _lastPoint
+    QCache<QString, QImage> _tips;    // Tips that have been rendered, by size/hardness/color
+
+};
+
+
+#endif // DAB_ENGINE_H
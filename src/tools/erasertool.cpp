@@ -29,8 +29,7 @@
 
 
 EraserTool::EraserTool(QObject *parent) :
-    Tool(parent),
-    _pen(Qt::black, Tools::commonParams["pen-size"].toDouble(), Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin)
+    Tool(parent)
 {
     // Do nothing
 }
@@ -102,10 +101,9 @@ void EraserTool::onMouseDoubleClicked(QGraphicsSceneMouseEvent *event) {
 void EraserTool::onMouseMoved(QGraphicsSceneMouseEvent *event) {
     // If the eraser is down, then well, erase (actually draw)
     if (_eraserDown) {
-        // Get Add a new line to the list of strokes
+        // Add on to the stroke, it's drawn at the next display frame along with any other moves
         QPointF curPoint = event->scenePos();
-        _painter.drawLine(curPoint - _celPos, _lastPoint - _celPos);
-        _transferDrawing();
+        _stroke.lineTo(curPoint - _celPos);
 
         // Save the point
         _lastPoint = curPoint;
@@ -119,23 +117,19 @@ void EraserTool::onMousePressed(QGraphicsSceneMouseEvent *event) {
     if (!ref)
         return;
 
+    // Setup the stroke, the hardness is how much gets erased
+    QColor amount(0x00, 0x00, 0x00, _hardness);
+    if (!_stroke.begin(StrokeEngine::Erase, Tools::commonParams["pen-size"].toDouble(), amount))
+        return;
+
     // Put the eraser in the down state
     _eraserDown = true;
-
-    // Setup the Painter and state
-    BlitApp *bApp = BlitApp::app();
     _celPos = ref->pos();
     _lastPoint = event->scenePos();
-    _drawBuffer = new QImage(bApp->getPaintableImage());
-    _celImage = new QImage(bApp->celImage());
 
     // Erase the first point
-    _painter.begin(_drawBuffer);
-    _pen.setWidth(Tools::commonParams["pen-size"].toDouble());
-    _painter.setPen(_pen);
     QPointF tmp(qFloor(_lastPoint.x()), qFloor(_lastPoint.y()));
-    _painter.drawPoint(tmp - _celPos);
-    _transferDrawing();
+    _stroke.drawPoint(tmp - _celPos);
 }
 
 
@@ -143,15 +137,11 @@ void EraserTool::onMouseReleased(QGraphicsSceneMouseEvent *event) {
     if (_eraserDown) {
         //  Needs to be in an if here becuase of Double-Clicking
         // Stop erasing
-        _painter.end();
+        _stroke.end();
 
-        // Cleanup state and Painter
+        // Cleanup state
         _lastPoint = QPointF();        // Null out
         _celPos = QPointF();
-        delete _drawBuffer;
-        _drawBuffer = NULL;
-        delete _celImage;
-        _celImage = NULL;
     
         // Bring the pen back up
         _eraserDown = false;
@@ -175,71 +165,3 @@ void EraserTool::_onHardnessSpinnerValueChanged(int value) {
     hardnessLabel->setText(QString::number((_hardness / 255.0) * 100.0, 'f', 2) + "%");
 }
 
-
-void EraserTool::_transferDrawing() {
-    // TODO along with the PenTool Too, investigate the drawing speeds
-    //
-    // Internal function.  Used to transfer the current drawing to the Cel.  Requires that the 
-    // EraserTool is down.
-    if (!_eraserDown)
-        return;
-
-    // convert the drawing buffer to the desired intensity of the hardness
-    QImage drawBuff = _drawBuffer->copy();
-    QPainter drawBuffPainter(&drawBuff);
-    drawBuffPainter.setCompositionMode(QPainter::CompositionMode_SourceIn);
-    drawBuffPainter.fillRect(0, 0, drawBuff.width(), drawBuff.height(), QColor(0x00, 0x00, 0x00, _hardness));
-
-    // Then Erase that much from the Cel
-    QImage celBuff = _celImage->copy();
-    QPainter celBuffPainter(&celBuff);
-    celBuffPainter.setCompositionMode(QPainter::CompositionMode_DestinationOut);
-    celBuffPainter.drawImage(0, 0, drawBuff);
-
-//    // Go through the alpha adjusted drawing bufer.  If a pixel's alpha value is someing, then
-//    // subtract that alpha value from the second buffer
-//    for (int y = 0; y < drawBufferCopy.width(); y++) {
-//        for (int x = 0; x < drawBufferCopy.height(); x++) {
-//            int alpha = qAlpha(drawBufferCopy.pixel(x, y));
-//
-//            // Subtract pixel alpha by value if there is some erasure
-//            if (alpha != 0) {
-//                QRgb pixel = celCopy.pixel(x, y);
-//                int destAlpha = qAlpha(pixel);
-//
-//                // Before
-////                qDebug() << "before";
-////                qDebug() << "  r:" << qRed(pixel);
-////                qDebug() << "  g:" << qGreen(pixel);
-////                qDebug() << "  b:" << qBlue(pixel);
-////                qDebug() << "  a:" << qAlpha(pixel);
-//
-//                // Do the subtaction
-//                destAlpha -= _hardness;
-//                if (destAlpha < 0)
-//                    destAlpha = 0;
-//
-//                // Before
-////                qDebug() << "Dest";
-////                qDebug() << "  a:" << destAlpha;
-//
-//                // And set the pixel
-//                celCopy.setPixel(x, y, qRgba(qRed(pixel), qGreen(pixel), qBlue(pixel), destAlpha));
-//
-//                // After
-//                pixel = celCopy.pixel(x, y);
-////                qDebug() << "after";
-////                qDebug() << "  r:" << qRed(pixel);
-////                qDebug() << "  g:" << qGreen(pixel);
-////                qDebug() << "  b:" << qBlue(pixel);
-////                qDebug() << "  a:" << qAlpha(pixel);
-////                qDebug();
-//            }
-//        }
-//    }
-//    celCopy.save("/tmp/celCopy.png");
-
-    // Apply the update
-    BlitApp::app()->copyOntoCel(celBuff);
-}
-
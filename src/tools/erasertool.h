@@ -15,9 +15,8 @@
 
 
 #include "tools/tool.h"
+#include "tools/strokeengine.h"
 #include <QPointF>
-#include <QPen>
-#include <QPainter>
 #include <QPointer>
 class QLineF;
 class QLabel;
@@ -52,22 +51,16 @@ public slots:
     void onMouseReleased(QGraphicsSceneMouseEvent *event);
 
 private:
-    // Internal functions
-    void _transferDrawing();
-
     // Member vars
 //    int _size = 1;
     int _hardness = 0xFF;
-    QPainter _painter;
-    QPen _pen;
+    StrokeEngine _stroke;
     QPointer<QLabel> hardnessLabel;
 
     // State variables for when painting
     bool _eraserDown = false;
     QPointF _celPos;
     QPointF _lastPoint;
-    QImage *_celImage = NULL;
-    QImage *_drawBuffer = NULL;
 };
 
 
@@ -9,15 +9,19 @@
 #include "blitapp.h"
 #include "util.h"
 #include "animation/celref.h"
+#include "animation/cel.h"
+#include "animation/pngcel.h"
+#include "animation/frame.h"
 #include <QtMath>
 #include <QStack>
 #include <QPointF>
-#include <QPixmap>
-#include <QPen>
-#include <QPainter>
+#include <QVector>
 #include <QIcon>
+#include <QSpinBox>
+#include <QCheckBox>
+#include <QComboBox>
+#include <QFormLayout>
 #include <QGraphicsSceneMouseEvent>
-#include <ctime>
 
 
 // Export the Tool
@@ -52,6 +56,55 @@ QIcon FillTool::icon() {
 }
 
 
+QWidget *FillTool::options() {
+    // Return apanel to change tool options
+    void (QSpinBox::*spinnerValueChanged)(int) = &QSpinBox::valueChanged;
+    void (QComboBox::*currentIndexChanged)(int) = &QComboBox::currentIndexChanged;
+
+    // Make the options panel
+    QWidget *optionsPanel = new QWidget();
+    optionsPanel->setMaximumWidth(TOOL_OPTIONS_PANEL_MAX_WIDTH);
+
+    // Tolerance
+    QSpinBox *toleranceSpinner = new QSpinBox(optionsPanel);
+    toleranceSpinner->setMinimum(0x00);
+    toleranceSpinner->setMaximum(0xFF);
+    toleranceSpinner->setValue(_tolerance);
+
+    // Contiguous (or global replace)
+    QCheckBox *contiguousBox = new QCheckBox(optionsPanel);
+    contiguousBox->setChecked(_contiguous);
+
+    // Gap closing
+    QSpinBox *gapSpinner = new QSpinBox(optionsPanel);
+    gapSpinner->setMinimum(0);
+    gapSpinner->setMaximum(16);
+    gapSpinner->setSuffix(tr(" px"));
+    gapSpinner->setValue(_gapSize);
+
+    // Sampling
+    QComboBox *sampleBox = new QComboBox(optionsPanel);
+    sampleBox->insertItem(SampleCel, tr("Cel"));
+    sampleBox->insertItem(SampleFrame, tr("Frame"));
+    sampleBox->setCurrentIndex((int)_sample);
+
+    // Layout
+    QFormLayout *layout = new QFormLayout(optionsPanel);
+    layout->addRow(tr("Tolerance:"), toleranceSpinner);
+    layout->addRow(tr("Contiguous:"), contiguousBox);
+    layout->addRow(tr("Close Gaps:"), gapSpinner);
+    layout->addRow(tr("Sample:"), sampleBox);
+
+    // Signals & slots
+    connect(toleranceSpinner, spinnerValueChanged, this, &FillTool::_onToleranceSpinnerValueChanged);
+    connect(contiguousBox, &QCheckBox::clicked, this, &FillTool::_onContiguousBoxClicked);
+    connect(gapSpinner, spinnerValueChanged, this, &FillTool::_onGapSpinnerValueChanged);
+    connect(sampleBox, currentIndexChanged, this, &FillTool::_onSampleBoxChanged);
+
+    return optionsPanel;
+}
+
+
 void FillTool::onMouseDoubleClicked(QGraphicsSceneMouseEvent *event) {
     // Do nothing
 }
@@ -71,9 +124,8 @@ void FillTool::onMousePressed(QGraphicsSceneMouseEvent *event) {
     // Put the pen in the down state
     _penDown = true;
 
-    // Setup the Painter and state
+    // Setup the state
     _celPos = ref->pos();
-    _celImage = new QImage(BlitApp::app()->celImage());
 }
 
 
@@ -88,11 +140,9 @@ void FillTool::onMouseReleased(QGraphicsSceneMouseEvent *event) {
     // Do the fill
     _transferDrawing();
 
-    // Cleanup state and Painter
+    // Cleanup state
     _celPos = QPointF();
     _fillSource = QPoint();
-    delete _celImage;
-    _celImage = NULL;
     
     // Bring the pen back up
     _penDown = false;
@@ -100,81 +150,288 @@ void FillTool::onMouseReleased(QGraphicsSceneMouseEvent *event) {
 }
 
 
+void FillTool::_onToleranceSpinnerValueChanged(int value) {
+    // How much each color channel can be off from the clicked color and still get filled
+    _tolerance = value;
+}
+
+
+void FillTool::_onContiguousBoxClicked(bool checked) {
+    // If not contiguous, every matching pixel in the Cel gets replaced
+    _contiguous = checked;
+}
+
+
+void FillTool::_onGapSpinnerValueChanged(int value) {
+    // Size of the gaps in line art to close up
+    _gapSize = value;
+}
+
+
+void FillTool::_onSampleBoxChanged(int index) {
+    // Where the fill boundaries are looked up from
+    _sample = (Sample)index;
+}
+
+
+/*!
+    Checks if \a a is within \a tol of \a b on every channel (alpha included).
+*/
+static inline bool matches(QRgb a, QRgb b, int tol) {
+    if (a == b)
+        return true;
+
+    return (qAbs(qRed(a) - qRed(b)) <= tol) &&
+           (qAbs(qGreen(a) - qGreen(b)) <= tol) &&
+           (qAbs(qBlue(a) - qBlue(b)) <= tol) &&
+           (qAbs(qAlpha(a) - qAlpha(b)) <= tol);
+}
+
+
+/*!
+    Grows the set parts of \a mask (\a w x \a h) by \a r pixels in every direction
+    (a square).  Done as a horizontal then a vertical pass with a sliding count, so
+    the cost doesn't depend on \a r.
+*/
+static void dilate(QVector<uchar> &mask, int w, int h, int r) {
+    if (r <= 0)
+        return;
+
+    QVector<uchar> tmp(w * h, 0);
+
+    // Rows
+    for (int y = 0; y < h; y++) {
+        const uchar *src = mask.constData() + (y * w);
+        uchar *dest = tmp.data() + (y * w);
+        int count = 0;
+        for (int x = 0; (x < r) && (x < w); x++)
+            count += src[x];
+
+        for (int x = 0; x < w; x++) {
+            if ((x + r) < w)
+                count += src[x + r];
+            dest[x] = (count > 0);
+            if ((x - r) >= 0)
+                count -= src[x - r];
+        }
+    }
+
+    // Columns
+    for (int x = 0; x < w; x++) {
+        const uchar *src = tmp.constData() + x;
+        uchar *dest = mask.data() + x;
+        int count = 0;
+        for (int y = 0; (y < r) && (y < h); y++)
+            count += src[y * w];
+
+        for (int y = 0; y < h; y++) {
+            if ((y + r) < h)
+                count += src[(y + r) * w];
+            dest[y * w] = (count > 0);
+            if ((y - r) >= 0)
+                count -= src[(y - r) * w];
+        }
+    }
+}
+
+
 void FillTool::_transferDrawing() {
     // Internal function.  Used to transfer the current drawing to the Cel.  Requires that the 
-    // FillTool is down.  Code is based off of the one from lodev.org
+    // FillTool is down.
+    //
+    // The pixels to fill are found first (see _floodMask()), then they are all painted right on
+    // the Cel's image data.  When not contiguous, it's a single pass over the Cel that tests and
+    // replaces each pixel.
     if (!_penDown)
         return;
 
+    // Only PNGCels that are loaded up can be filled in place
+    Cel *cel = BlitApp::app()->curCel();
+    if (!cel || (cel->type() != PNG_CEL_TYPE))
+        return;
+    PNGCel *pc = (PNGCel *)cel;
+    QImage *img = pc->imageData();
+    if (!img)
+        return;
+    if (img->format() != QImage::Format_ARGB32_Premultiplied)
+        *img = img->convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
     // Points & bounds checking
+    int w = img->width(), h = img->height();
     int x = _fillSource.x() - _celPos.x(), y = _fillSource.y() - _celPos.y();
-    if ((x < 0) || (y < 0) || (x > (_celImage->width() - 1)) || (y > (_celImage->height() - 1)))
+    if ((x < 0) || (y < 0) || (x > (w - 1)) || (y > (h - 1)))
         return;
-    
-    
-    // Get colors and check
-//    clock_t start = clock();
-    QRgb fillClr = BlitApp::app()->curColor().rgba();
-    QRgb oldClr = _celImage->pixel(x, y);
-    if (oldClr == fillClr)
+
+    // What the boundaries are looked up in (lined up with the Cel)
+    QImage composite;
+    Frame *frame = BlitApp::app()->curFrame();
+    if ((_sample == SampleFrame) && frame)
+        composite = frame->render(QRect(_celPos.toPoint(), img->size())).convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    const QImage &ref = composite.isNull() ? *img : composite;
+
+    // Get colors (all raw premultiplied values)
+    QRgb target = ((const QRgb *)ref.constScanLine(y))[x];
+    QRgb fillClr = qPremultiply(BlitApp::app()->curColor().rgba());
+    bool opaque = (qAlpha(fillClr) == 0xFF);
+    QRect dirty;
+
+    // Nothing would change
+    if (composite.isNull() && (_tolerance == 0) && (util::blendOver(fillClr, target) == target))
         return;
 
-    // Then put it onto the Cel
-    QImage celBuff = _celImage->copy();
+    if (!_contiguous) {
+        // Global replace, test and write in one go
+        int minX = w, maxX = -1, minY = h, maxY = -1;
+        for (int ry = 0; ry < h; ry++) {
+            QRgb *row = (QRgb *)img->scanLine(ry);        // Before the reference row, in case this detaches
+            const QRgb *refRow = (const QRgb *)ref.constScanLine(ry);
+            int rowMin = w, rowMax = -1;
+
+            for (int rx = 0; rx < w; rx++) {
+                if (matches(refRow[rx], target, _tolerance)) {
+                    row[rx] = opaque ? fillClr : util::blendOver(fillClr, row[rx]);
+                    rowMin = qMin(rowMin, rx);
+                    rowMax = rx;
+                }
+            }
 
-    // Vars for flood fill
-    QStack<QPoint> stack;
-    QVector<QPoint> toDraw;
-    bool spanLeft, spanRight;
-    int w = celBuff.width(), h = celBuff.height();
-    int y1;
+            if (rowMax >= 0) {
+                minX = qMin(minX, rowMin);
+                maxX = qMax(maxX, rowMax);
+                minY = qMin(minY, ry);
+                maxY = ry;
+            }
+        }
 
-    // TODO cache pixel data (see if there is a speed improvement)
+        if (maxX >= 0)
+            dirty = QRect(QPoint(minX, minY), QPoint(maxX, maxY));
+    } else {
+        QVector<uchar> filled(w * h, 0);
+        QVector<uchar> blocked;
+        int r = (_gapSize + 1) / 2;        // Each side of a gap grows by half of it
+
+        // Grow the boundaries so that small gaps are shut
+        if (r > 0) {
+            blocked.fill(0, w * h);
+            for (int ry = 0; ry < h; ry++) {
+                const QRgb *refRow = (const QRgb *)ref.constScanLine(ry);
+                uchar *b = blocked.data() + (ry * w);
+                for (int rx = 0; rx < w; rx++)
+                    b[rx] = !matches(refRow[rx], target, _tolerance);
+            }
+            dilate(blocked, w, h, r);
 
-    // First push
-    stack.push(QPoint(x, y));
+            // Clicked right next to a line, can't close gaps here
+            if (blocked[(y * w) + x])
+                blocked.clear();
+        }
 
-    while (stack.size() != 0) {
-        QPoint p = stack.pop();
-        x = p.x();
-        y = p.y();
-
-        y1 = y;
-        while ((y1 >= 0) && (celBuff.pixel(x, y1) == oldClr))
-            y1--;
-        y1++;
-
-        spanLeft = spanRight = false;
-        while ((y1 < h) && (celBuff.pixel(x, y1) == oldClr)) {
-            QPoint draw(x, y1);
-            celBuff.setPixel(draw, fillClr);        // Put the pixel
-            toDraw << draw;
-
-
-            if (!spanLeft && (x > 0) && (celBuff.pixel(x - 1, y1) == oldClr)) {
-                stack.push(QPoint(x - 1, y1));
-                spanLeft = true;
-            } else if (spanLeft && (x > 0) && (celBuff.pixel(x - 1, y1) != oldClr)) {
-                spanLeft = false;
+        dirty = _floodMask(ref, QPoint(x, y), target, blocked, filled);
+
+        // Gap closing pulled the fill back from the lines, push it back out to them
+        if (!blocked.isEmpty() && !dirty.isNull()) {
+            QVector<uchar> grown(filled);
+            dilate(grown, w, h, r);
+
+            QRect area = dirty.adjusted(-r, -r, r, r) & img->rect();
+            for (int ry = area.top(); ry <= area.bottom(); ry++) {
+                const QRgb *refRow = (const QRgb *)ref.constScanLine(ry);
+                uchar *f = filled.data() + (ry * w);
+                const uchar *g = grown.constData() + (ry * w);
+                for (int rx = area.left(); rx <= area.right(); rx++) {
+                    if (g[rx] && !f[rx] && matches(refRow[rx], target, _tolerance)) {
+                        f[rx] = 1;
+                        dirty |= QRect(rx, ry, 1, 1);
+                    }
+                }
             }
+        }
 
-            if (!spanRight && (x < (w - 1)) && (celBuff.pixel(x + 1, y1) == oldClr)) {
-                stack.push(QPoint(x + 1, y1));
-                spanRight = true;
-            } else if (spanRight && (x < (w - 1)) && (celBuff.pixel(x + 1, y1) != oldClr)) {
-                spanRight = false;
+        // Paint everything that was marked
+        for (int ry = dirty.top(); ry <= dirty.bottom(); ry++) {
+            QRgb *row = (QRgb *)img->scanLine(ry);
+            const uchar *f = filled.constData() + (ry * w);
+            for (int rx = dirty.left(); rx <= dirty.right(); rx++) {
+                if (f[rx])
+                    row[rx] = opaque ? fillClr : util::blendOver(fillClr, row[rx]);
             }
-
-            y1++;
         }
     }
 
     // Apply the update
-    QPen pen(BlitApp::app()->curColor());
-    celBuff = _celImage->copy();
-    QPainter celBuffPainter(&celBuff);
-    celBuffPainter.setPen(pen);
-    celBuffPainter.drawPoints(toDraw.data(), toDraw.size());
-    BlitApp::app()->copyOntoCel(celBuff);
+    if (!dirty.isNull())
+        pc->damage(dirty);
 }
 
+
+/*!
+    Internal function.  Scanline flood fill that marks pixels in \a filled (which
+    is the size of \a ref, and also works as the visited map) instead of painting
+    them.  Starts at \a seed, and spreads to pixels in \a ref that are within the
+    tolerance of \a target.  If \a blocked isn't empty, pixels set in it are not
+    filled.
+
+    Whole horizontal spans are marked at once, and the rows above and below each
+    span are scanned for where to start the next spans.
+
+    Returns the bounding rect of the marked pixels.
+*/
+QRect FillTool::_floodMask(const QImage &ref, QPoint seed, QRgb target, const QVector<uchar> &blocked, QVector<uchar> &filled) {
+    int w = ref.width(), h = ref.height();
+    const uchar *block = blocked.isEmpty() ? NULL : blocked.constData();
+    int minX = seed.x(), maxX = seed.x(), minY = seed.y(), maxY = seed.y();
+    bool any = false;
+
+    QStack<QPoint> stack;
+    stack.push(seed);
+
+    while (!stack.isEmpty()) {
+        QPoint p = stack.pop();
+        int x = p.x(), y = p.y();
+
+        const QRgb *row = (const QRgb *)ref.constScanLine(y);
+        uchar *f = filled.data() + (y * w);
+        const uchar *b = block ? (block + (y * w)) : NULL;
+        if (f[x] || (b && b[x]) || !matches(row[x], target, _tolerance))
+            continue;
+
+        // Find the ends of the span
+        int left = x, right = x;
+        while ((left > 0) && !f[left - 1] && !(b && b[left - 1]) && matches(row[left - 1], target, _tolerance))
+            left--;
+        while ((right < (w - 1)) && !f[right + 1] && !(b && b[right + 1]) && matches(row[right + 1], target, _tolerance))
+            right++;
+
+        // Mark it
+        for (int i = left; i <= right; i++)
+            f[i] = 1;
+
+        any = true;
+        minX = qMin(minX, left);
+        maxX = qMax(maxX, right);
+        minY = qMin(minY, y);
+        maxY = qMax(maxY, y);
+
+        // Look for spans to start in the rows above & below
+        for (int ny = y - 1; ny <= y + 1; ny += 2) {
+            if ((ny < 0) || (ny > (h - 1)))
+                continue;
+
+            const QRgb *nRow = (const QRgb *)ref.constScanLine(ny);
+            const uchar *nf = filled.constData() + (ny * w);
+            const uchar *nb = block ? (block + (ny * w)) : NULL;
+            bool inSpan = false;
+            for (int i = left; i <= right; i++) {
+                bool fillable = !nf[i] && !(nb && nb[i]) && matches(nRow[i], target, _tolerance);
+                if (fillable && !inSpan)
+                    stack.push(QPoint(i, ny));
+                inSpan = fillable;
+            }
+        }
+    }
+
+    if (any)
+        return QRect(QPoint(minX, minY), QPoint(maxX, maxY));
+    else
+        return QRect();
+}
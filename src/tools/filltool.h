@@ -10,6 +10,9 @@
 
 #include "tools/tool.h"
 #include <QPointF>
+#include <QVector>
+#include <QRect>
+#include <QImage>
 class QLineF;
 
 
@@ -27,6 +30,20 @@ public:
     QString desc();
     QIcon icon();
 
+    QWidget *options();
+
+    // Where to look for the boundaries of the fill
+    enum Sample {
+        SampleCel,        // Just the current Cel
+        SampleFrame        // The whole Frame (all Cels composited)
+    };
+
+private slots:
+    void _onToleranceSpinnerValueChanged(int value);
+    void _onContiguousBoxClicked(bool checked);
+    void _onGapSpinnerValueChanged(int value);
+    void _onSampleBoxChanged(int index);
+
 public slots:
     // For drawing
     void onMouseDoubleClicked(QGraphicsSceneMouseEvent *event);
@@ -37,12 +54,18 @@ public slots:
 private:
     // Internal functions
     void _transferDrawing();
+    QRect _floodMask(const QImage &ref, QPoint seed, QRgb target, const QVector<uchar> &blocked, QVector<uchar> &filled);
+
+    // Fill options
+    int _tolerance = 0;                // How far off each channel can be and still match (0 = exact)
+    bool _contiguous = true;        // Flood fill, or replace every matching pixel in the Cel
+    int _gapSize = 0;                // Gaps in the boundary up to this many pixels won't leak
+    Sample _sample = SampleCel;        // What the boundaries come from
 
     // State variables for when painting
     bool _penDown = false;
     QPointF _celPos;
     QPoint _fillSource;
-    QImage *_celImage = NULL;
 };
 
 
@@ -15,10 +15,12 @@
 #include "blitapp.h"
 #include "util.h"
 #include "animation/celref.h"
+#include "tools/rasterizer.h"
+#include "widgets/drawing/canvas.h"
+#include "widgets/drawing/overlayitem.h"
 #include <QtMath>
 #include <QPointF>
 #include <QPixmap>
-#include <QPainter>
 #include <QIcon>
 #include <QLabel>
 #include <QSpinBox>
@@ -117,7 +119,7 @@ void LineTool::onMousePressed(QGraphicsSceneMouseEvent *event) {
     _startPoint.setX(qFloor(_startPoint.x()));
     _startPoint.setY(qFloor(_startPoint.y()));
     _curPoint = _startPoint;
-    _celImage = new QImage(BlitApp::app()->celImage());
+    BlitApp::app()->canvas()->overlay()->setPos(_celPos);
 
     // Draw the first point
     _transferDrawing();
@@ -127,14 +129,13 @@ void LineTool::onMousePressed(QGraphicsSceneMouseEvent *event) {
 void LineTool::onMouseReleased(QGraphicsSceneMouseEvent *event) {
     if (_penDown) {
         //  Needs to be in an if here becuase of Double-Clicking
-        // Stop painting
+        // Stop painting, only now does the line go onto the Cel
+        BlitApp::app()->canvas()->overlay()->commit();
 
-        // Cleanup state and Painter
+        // Cleanup state
         _startPoint = QPointF();        // Null out
         _curPoint = QPointF();
         _celPos = QPointF();
-        delete _celImage;
-        _celImage = NULL;
     
         // Bring the pen back up
         _penDown = false;
@@ -151,26 +152,18 @@ void LineTool::_onSizeSpinnerValueChanged(int value) {
 
 
 void LineTool::_transferDrawing() {
-    // Internal function.  Used to transfer the current drawing to the Cel.  Requires that the 
-    // LineTool is down.
+    // Internal function.  Used to show the current line in the Canvas' overlay (it's put onto
+    // the Cel when the mouse is released).  Requires that the LineTool is down.
     if (!_penDown)
         return;
 
-    // Then put it onto the Cel
-    QImage celBuff = _celImage->copy();
-    QPainter celBuffPainter(&celBuff);
-    celBuffPainter.setPen(_pen);
-//    celBuffPainter.translate(-0.5, -0.5);
-//    celBuffPainter.drawLine(_startPoint, _curPoint);
-    QList<QPoint> points = math::bresenhamLinePoints(_startPoint - _celPos, _curPoint - _celPos);
-    QList<QPoint>::const_iterator iter;
-    for (iter = points.begin(); iter != points.end(); iter++) {
-        celBuffPainter.drawPoint(*iter);
-    }
-    celBuffPainter.drawPoint(_startPoint - _celPos);
-    celBuffPainter.drawPoint(_curPoint - _celPos);
+    // Rasterize the line as spans (in Cel coordinates)
+    QPointF a = _startPoint - _celPos;
+    QPointF b = _curPoint - _celPos;
+    raster::Spans spans;
+    raster::line(spans, QPoint(qFloor(a.x()), qFloor(a.y())), QPoint(qFloor(b.x()), qFloor(b.y())), _pen.width());
 
-    // Apply the update
-    BlitApp::app()->copyOntoCel(celBuff);
+    // Preview it
+    BlitApp::app()->canvas()->overlay()->setSpans(spans, _pen.color());
 }
 
@@ -53,7 +53,6 @@ private:
     QPointF _startPoint;
     QPointF _curPoint;
     QPointF _celPos;
-    QImage *_celImage = NULL;
 };
 
 
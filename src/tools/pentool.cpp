@@ -24,8 +24,7 @@
 
 
 PenTool::PenTool(QObject *parent) :
-    Tool(parent),
-    _pen(BlitApp::app()->curColor(), Tools::commonParams["pen-size"].toDouble(), Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin)
+    Tool(parent)
 {
     // Do nothing
 }
@@ -83,10 +82,9 @@ void PenTool::onMouseDoubleClicked(QGraphicsSceneMouseEvent *event) {
 void PenTool::onMouseMoved(QGraphicsSceneMouseEvent *event) {
     // If the pen is down, then well, draw
     if (_penDown) {
-        // Get Add a new line to the list of strokes
+        // Add on to the stroke, it's drawn at the next display frame along with any other moves
         QPointF curPoint = event->scenePos();
-        _painter.drawLine(curPoint - _celPos, _lastPoint - _celPos);
-        _transferDrawing();
+        _stroke.lineTo(curPoint - _celPos);
 
         // Save the point
         _lastPoint = curPoint;
@@ -100,23 +98,18 @@ void PenTool::onMousePressed(QGraphicsSceneMouseEvent *event) {
     if (!ref)
         return;
 
+    // Setup the stroke, the Cel might not be paintable
+    if (!_stroke.begin(StrokeEngine::Paint, Tools::commonParams["pen-size"].toDouble(), BlitApp::app()->curColor()))
+        return;
+
     // Put the pen in the down state
     _penDown = true;
-
-    // Setup the Painter and state
-    BlitApp *bApp = BlitApp::app();
     _celPos = ref->pos();
     _lastPoint = event->scenePos();
-    _drawBuffer = new QImage(bApp->getPaintableImage());
-    _celImage = new QImage(bApp->celImage());
 
     // Draw the first point
-    _painter.begin(_drawBuffer);
-    _pen.setWidth(Tools::commonParams["pen-size"].toDouble());
-    _painter.setPen(_pen);
     QPointF tmp(qFloor(_lastPoint.x()), qFloor(_lastPoint.y()));
-    _painter.drawPoint(tmp - _celPos);
-    _transferDrawing();
+    _stroke.drawPoint(tmp - _celPos);
 }
 
 
@@ -124,15 +117,11 @@ void PenTool::onMouseReleased(QGraphicsSceneMouseEvent *event) {
     if (_penDown) {
         //  Needs to be in an if here becuase of Double-Clicking
         // Stop painting
-        _painter.end();
+        _stroke.end();
 
-        // Cleanup state and Painter
+        // Cleanup state
         _lastPoint = QPointF();        // Null out
         _celPos = QPointF();
-        delete _drawBuffer;
-        _drawBuffer = NULL;
-        delete _celImage;
-        _celImage = NULL;
     
         // Bring the pen back up
         _penDown = false;
@@ -148,27 +137,3 @@ void PenTool::_onSizeSpinnerValueChanged(int value) {
 //    _pen.setWidth(value);
 }
 
-
-void PenTool::_transferDrawing() {
-    // Internal function.  Used to transfer the current drawing to the Cel.  Requires that the 
-    // PenTool is down.
-    if (!_penDown)
-        return;
-
-    // Using the draw buffer, create another painter instance that will
-    // convert all of the black lines to the color
-    QColor clr = BlitApp::app()->curColor();
-    QImage drawBuff = _drawBuffer->copy();
-    QPainter drawBuffPainter(&drawBuff);
-    drawBuffPainter.setCompositionMode(QPainter::CompositionMode_SourceIn);
-    drawBuffPainter.fillRect(0, 0, drawBuff.width(), drawBuff.height(), clr);
-
-    // Then put it onto the Cel
-    QImage celBuff = _celImage->copy();
-    QPainter celBuffPainter(&celBuff);
-    celBuffPainter.drawImage(0, 0, drawBuff);
-
-    // Apply the update
-    BlitApp::app()->copyOntoCel(celBuff);
-}
-
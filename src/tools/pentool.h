@@ -9,9 +9,8 @@
 
 
 #include "tools/tool.h"
+#include "tools/strokeengine.h"
 #include <QPointF>
-#include <QPen>
-#include <QPainter>
 class QLineF;
 class QSpinBox;
 
@@ -43,19 +42,13 @@ public slots:
     void onMouseReleased(QGraphicsSceneMouseEvent *event);
 
 private:
-    // Internal functions
-    void _transferDrawing();
-
     // Member vars
-    QPainter _painter;
-    QPen _pen;
+    StrokeEngine _stroke;
 
     // State variables for when painting
     bool _penDown = false;
     QPointF _lastPoint;
     QPointF _celPos;
-    QImage *_celImage = NULL;
-    QImage *_drawBuffer = NULL;
 };
 
 
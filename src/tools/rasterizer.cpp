@@ -0,0 +1,325 @@
+// File:         rasterizer.cpp
+// Author:       Ben Summerton (define-private-public)
+// Description:  Source implementation of the raster functions
+
+
+/*
+    All of the shapes are worked out with integer (or pixel center) math so they come out
+    the same every time, which is what we want for pixel art.  Nothing here is anti-aliased.
+
+    Each shape function appends to a list of spans; shapes can be added together (e.g. a
+    filled polygon and its outline).  draw() merges any spans that overlap before writing them,
+    so no pixel is blended twice even with a translucent color.
+*/
+
+
+#include "tools/rasterizer.h"
+#include "util.h"
+#include <QImage>
+#include <QtMath>
+#include <algorithm>
+#include <climits>
+
+
+/*!
+    Internal function.  Offsets from a pixel for a square pen of \a width, so that it's centered
+    on the pixel (even widths lean to the top left).
+*/
+static inline void penOffsets(int width, int &o0, int &o1) {
+    width = qMax(1, width);
+    o0 = -(width / 2);
+    o1 = o0 + width - 1;
+}
+
+
+/*!
+    Adds a line from \a a to \a b (both ends included) that is \a width pixels thick.  It's
+    drawn like a square pen being dragged along a Bresenham line, but each row comes out as a
+    single span instead of a pixel at a time.
+*/
+void raster::line(Spans &spans, QPoint a, QPoint b, int width) {
+    int o0, o1;
+    penOffsets(width, o0, o1);
+
+    // Coverage of each row
+    int top = qMin(a.y(), b.y()) + o0;
+    int rows = qAbs(b.y() - a.y()) + (o1 - o0) + 1;
+    QVector<int> minX(rows, INT_MAX);
+    QVector<int> maxX(rows, INT_MIN);
+
+    // Bresenham, for all octants
+    int x = a.x(), y = a.y();
+    int dx = qAbs(b.x() - x), sx = (x < b.x()) ? 1 : -1;
+    int dy = -qAbs(b.y() - y), sy = (y < b.y()) ? 1 : -1;
+    int err = dx + dy;
+    while (true) {
+        // The pen is a square, so it covers the same columns on every row it touches
+        for (int i = (y + o0 - top); i <= (y + o1 - top); i++) {
+            minX[i] = qMin(minX[i], x + o0);
+            maxX[i] = qMax(maxX[i], x + o1);
+        }
+
+        if ((x == b.x()) && (y == b.y()))
+            break;
+
+        int e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y += sy;
+        }
+    }
+
+    // A square dragged along a line is convex, so one span per row covers it
+    for (int i = 0; i < rows; i++)
+        spans.append({top + i, minX[i], maxX[i]});
+}
+
+
+/*!
+    Adds lines between each of \a points.  If \a closed is true, the last point is also joined
+    back up to the first.
+*/
+void raster::polyline(Spans &spans, const QVector<QPoint> &points, int width, bool closed) {
+    if (points.isEmpty())
+        return;
+
+    if (points.size() == 1) {
+        raster::line(spans, points[0], points[0], width);
+        return;
+    }
+
+    for (int i = 1; i < points.size(); i++)
+        raster::line(spans, points[i - 1], points[i], width);
+
+    if (closed && (points.size() > 2))
+        raster::line(spans, points.last(), points.first(), width);
+}
+
+
+/*!
+    Adds a rectangle.  If \a filled is false then only an outline \a width pixels thick is
+    added; the outline is centered on the edges of \a r.
+*/
+void raster::rect(Spans &spans, QRect r, int width, bool filled) {
+    int o0, o1;
+    penOffsets(width, o0, o1);
+
+    r = r.normalized();
+    QRect outer = r.adjusted(o0, o0, o1, o1);
+    QRect inner = r.adjusted(o1 + 1, o1 + 1, o0 - 1, o0 - 1);
+    bool hollow = !filled && (inner.left() <= inner.right());
+
+    for (int y = outer.top(); y <= outer.bottom(); y++) {
+        if (hollow && (y >= inner.top()) && (y <= inner.bottom())) {
+            // Just the sides
+            spans.append({y, outer.left(), inner.left() - 1});
+            spans.append({y, inner.right() + 1, outer.right()});
+        } else
+            spans.append({y, outer.left(), outer.right()});
+    }
+}
+
+
+/*!
+    Internal function.  Works out which pixels on row \a y have their centers inside of the
+    ellipse that fits in \a r.  Returns false if there aren't any, in which case \a l and \a rr
+    are set to the middle pixel.
+*/
+static bool ellipseRow(const QRect &r, int y, int &l, int &rr) {
+    qreal a = r.width() / 2.0;
+    qreal b = r.height() / 2.0;
+    qreal cx = r.left() + a;
+    qreal cy = r.top() + b;
+
+    qreal t = ((y + 0.5) - cy) / b;
+    qreal hx = a * qSqrt(qMax((qreal)0, 1 - (t * t)));
+    l = qCeil(cx - hx - 0.5);
+    rr = qFloor(cx + hx - 0.5);
+
+    if (l > rr) {
+        l = rr = qFloor(cx);
+        return false;
+    }
+
+    return true;
+}
+
+
+/*!
+    Adds an ellipse that fits inside of \a r.  If \a filled is false then only an outline
+    \a width pixels thick is added.  Where the edge is steep, each row of the outline is
+    stretched to meet the rows next to it so there aren't any gaps.
+*/
+void raster::ellipse(Spans &spans, QRect r, int width, bool filled) {
+    int o0, o1;
+    penOffsets(width, o0, o1);
+
+    r = r.normalized();
+    QRect outer = r.adjusted(o0, o0, o1, o1);
+    QRect inner = r.adjusted(o1 + 1, o1 + 1, o0 - 1, o0 - 1);
+    bool hollow = !filled && inner.isValid();
+
+    // Outside edges of every row first, so the neighbours can be looked at
+    int rows = outer.height();
+    QVector<int> outL(rows), outR(rows);
+    for (int i = 0; i < rows; i++)
+        ellipseRow(outer, outer.top() + i, outL[i], outR[i]);
+
+    for (int i = 0; i < rows; i++) {
+        int y = outer.top() + i;
+        int inL, inR;
+
+        if (!hollow || (i == 0) || (i == (rows - 1)) || !ellipseRow(inner, y, inL, inR)) {
+            spans.append({y, outL[i], outR[i]});
+            continue;
+        }
+
+        // Reach over to where the rows above/below start, so the outline stays connected
+        int mid = outL[i] + ((outR[i] - outL[i]) / 2);
+        int leftEnd = qMax(inL, qMax(outL[i - 1], outL[i + 1])) - 1;
+        int rightStart = qMin(inR, qMin(outR[i - 1], outR[i + 1])) + 1;
+        leftEnd = qBound(outL[i], leftEnd, mid);
+        rightStart = qBound(mid + 1, rightStart, outR[i]);
+
+        if (leftEnd + 1 >= rightStart)
+            spans.append({y, outL[i], outR[i]});
+        else {
+            spans.append({y, outL[i], leftEnd});
+            spans.append({y, rightStart, outR[i]});
+        }
+    }
+}
+
+
+/*!
+    Adds a filled polygon with corners at \a points (even-odd rule).  Pixels are filled if
+    their centers are inside of it, and the edges are always included.
+*/
+void raster::polygon(Spans &spans, const QVector<QPoint> &points) {
+    if (points.size() < 3) {
+        raster::polyline(spans, points);
+        return;
+    }
+
+    int top = INT_MAX, bottom = INT_MIN;
+    for (auto iter = points.begin(); iter != points.end(); iter++) {
+        top = qMin(top, iter->y());
+        bottom = qMax(bottom, iter->y());
+    }
+
+    // Corners are on pixel centers, so are the scanlines; half open on y so that a corner
+    // isn't counted twice
+    QVector<qreal> xs;
+    int n = points.size();
+    for (int y = top; y < bottom; y++) {
+        xs.clear();
+        for (int i = 0; i < n; i++) {
+            QPoint p0 = points[i];
+            QPoint p1 = points[(i + 1) % n];
+            if (p0.y() > p1.y())
+                qSwap(p0, p1);
+
+            if ((y >= p0.y()) && (y < p1.y()))
+                xs.append(p0.x() + ((qreal)(y - p0.y()) * (p1.x() - p0.x()) / (p1.y() - p0.y())));
+        }
+
+        std::sort(xs.begin(), xs.end());
+        for (int i = 0; (i + 1) < xs.size(); i += 2) {
+            int x0 = qCeil(xs[i]);
+            int x1 = qFloor(xs[i + 1]);
+            if (x0 <= x1)
+                spans.append({y, x0, x1});
+        }
+    }
+
+    // Edges
+    raster::polyline(spans, points, 1, true);
+}
+
+
+/*!
+    Sorts \a spans by row, and joins together any that overlap or touch.
+*/
+void raster::normalize(Spans &spans) {
+    if (spans.size() < 2)
+        return;
+
+    std::sort(spans.begin(), spans.end(), [](const Span &a, const Span &b) {
+        return (a.y < b.y) || ((a.y == b.y) && (a.x0 < b.x0));
+    });
+
+    int out = 0;
+    for (int i = 1; i < spans.size(); i++) {
+        Span &cur = spans[out];
+        const Span &next = spans[i];
+        if ((next.y == cur.y) && (next.x0 <= (cur.x1 + 1)))
+            cur.x1 = qMax(cur.x1, next.x1);
+        else
+            spans[++out] = next;
+    }
+
+    spans.resize(out + 1);
+}
+
+
+/*!
+    Returns the smallest rectangle that holds all of \a spans.
+*/
+QRect raster::bounds(const Spans &spans) {
+    if (spans.isEmpty())
+        return QRect();
+
+    int l = INT_MAX, t = INT_MAX, r = INT_MIN, b = INT_MIN;
+    for (auto iter = spans.begin(); iter != spans.end(); iter++) {
+        l = qMin(l, iter->x0);
+        r = qMax(r, iter->x1);
+        t = qMin(t, iter->y);
+        b = qMax(b, iter->y);
+    }
+
+    return QRect(QPoint(l, t), QPoint(r, b));
+}
+
+
+/*!
+    Writes \a spans into \a img (which should be premultiplied ARGB32) with \a clr, blended over
+    what's there.  Spans that are off of \a img are clipped.  Returns the area that was changed.
+    If \a img is in another format, it's converted first.
+*/
+QRect raster::draw(QImage &img, Spans spans, QColor clr) {
+    if (img.format() != QImage::Format_ARGB32_Premultiplied)
+        img = img.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+    raster::normalize(spans);
+
+    QRgb px = qPremultiply(clr.rgba());
+    bool opaque = (qAlpha(px) == 0xFF);
+    int w = img.width(), h = img.height();
+    QRect dirty;
+
+    for (auto iter = spans.begin(); iter != spans.end(); iter++) {
+        if ((iter->y < 0) || (iter->y >= h))
+            continue;
+
+        int x0 = qMax(0, iter->x0);
+        int x1 = qMin(w - 1, iter->x1);
+        if (x0 > x1)
+            continue;
+
+        QRgb *row = (QRgb *)img.scanLine(iter->y);
+        if (opaque)
+            std::fill(row + x0, row + x1 + 1, px);
+        else {
+            for (int x = x0; x <= x1; x++)
+                row[x] = util::blendOver(px, row[x]);
+        }
+
+        dirty |= QRect(x0, iter->y, x1 - x0 + 1, 1);
+    }
+
+    return dirty;
+}
@@ -0,0 +1,42 @@
+// File:         rasterizer.h
+// Author:       Ben Summerton (define-private-public)
+// Description:  Integer rasterizers for the shape based tools (e.g. Line & Shape).  Shapes are turned
+//               into horizontal spans of pixels, which are then written right into an image's
+//               scanlines.
+
+
+#ifndef RASTERIZER_H
+#define RASTERIZER_H
+
+
+#include <QVector>
+#include <QPoint>
+#include <QRect>
+#include <QColor>
+class QImage;
+
+
+namespace raster {
+    // A run of pixels on one row, x0 to x1 (inclusive)
+    struct Span {
+        int y;
+        int x0;
+        int x1;
+    };
+    typedef QVector<Span> Spans;
+
+    // Shapes, all coordinates are pixels (a rect's right/bottom are included)
+    void line(Spans &spans, QPoint a, QPoint b, int width=1);
+    void polyline(Spans &spans, const QVector<QPoint> &points, int width=1, bool closed=false);
+    void rect(Spans &spans, QRect r, int width=1, bool filled=false);
+    void ellipse(Spans &spans, QRect r, int width=1, bool filled=false);
+    void polygon(Spans &spans, const QVector<QPoint> &points);
+
+    // Using spans
+    void normalize(Spans &spans);
+    QRect bounds(const Spans &spans);
+    QRect draw(QImage &img, Spans spans, QColor clr);
+};
+
+
+#endif // RASTERIZER_H
@@ -5,11 +5,16 @@
 
 #include "tools/resizetool.h"
 #include "blitapp.h"
+#include "selection.h"
 #include "animation/cel.h"
+#include "animation/pngcel.h"
 #include "animation/celref.h"
+#include "widgets/drawing/canvas.h"
+#include "widgets/drawing/overlayitem.h"
 #include <QtMath>
 #include <QPair>
 #include <QPointF>
+#include <QRect>
 #include <QLineF>
 #include <QPixmap>
 #include <QIcon>
@@ -64,68 +69,15 @@ QIcon ResizeTool::icon() {
 
 
 /*!
-    TODO document
+    While dragging, this only shows an outline of where the Cel's edges will be (via the
+    Canvas's OverlayItem).  The Cel itself isn't touched until the mouse is released.
+
+    \sa onMouseReleased()
 */
 void ResizeTool::onMouseMoved(QGraphicsSceneMouseEvent *event){
     if (_resizingCel) {
-        // Normalize point
-        QPointF pos = event->scenePos() - _startingMousePos;
-        pos.setX(qFloor(pos.x()));
-        pos.setY(qFloor(pos.y()));
-
-        qDebug() << "[ResizeTool onMouseMoved] pos=" << pos;
-
-        // TODO there are some issues with showing a preview of a resize.  It might be best
-        //      instead to show a preview while dragging instead of doing the actual resize.
-        //      It also might be better to fundementall change that the Cel has no size (or
-        //      a hard coded sized, and the CelRef is just a viewport for that Cel.
-        //
-        //      That second part is kind of big and huge, it might be better for the
-        //      milestone.
-        //
-        // TODO log this for (P-3) under [High Priority]
-
-        Cel *cel = _ref->cel();
-
-        // Based on which op, do a resize
-        switch (_op) {
-            case _ResizeOp::Left:
-                cel->resize(_startWidth - pos.x(), _startHeight);
-                _ref->setX(_startingCelPos.x() + pos.x());
-                break;
-
-            case _ResizeOp::Right:
-                cel->resize(_startWidth + pos.x(), _startHeight);
-                break;
-
-            case _ResizeOp::Top:
-                cel->resize(_startWidth, _startHeight - pos.y());
-                _ref->setY(_startingCelPos.y() + pos.y());
-                break;
-
-            case _ResizeOp::Bottom:
-                cel->resize(_startWidth, _startHeight + pos.y());
-                break;
-
-            case _ResizeOp::TopLeft:
-                cel->resize(_startWidth - pos.x(), _startHeight - pos.y());
-                _ref->setPos(_startingCelPos + pos);
-                break;
-
-            case _ResizeOp::TopRight:
-                cel->resize(_startWidth + pos.x(), _startHeight - pos.y());
-                _ref->setY(_startingCelPos.y() + pos.y());
-                break;
-
-            case _ResizeOp::BottomLeft:
-                cel->resize(_startWidth - pos.x(), _startHeight + pos.y());
-                _ref->setX(_startingCelPos.x() + pos.x());
-                break;
-
-            case _ResizeOp::BottomRight:
-                cel->resize(_startWidth + pos.x(), _startHeight + pos.y());
-                break;
-        }
+        QRect rect = _newRect(event->scenePos());
+        BlitApp::app()->canvas()->overlay()->setOutline(rect);
     }
 }
 
@@ -150,6 +102,13 @@ void ResizeTool::onMousePressed(QGraphicsSceneMouseEvent *event){
     _startingCelPos = _ref->pos();
     _startWidth = cel->width();
     _startHeight = cel->height();
+    _op = _ResizeOp::None;
+
+    // Outline is in Cel coordinates
+    OverlayItem *overlay = BlitApp::app()->canvas()->overlay();
+    overlay->clear();
+    overlay->setPos(_startingCelPos);
+    overlay->setOutline(QRectF(0, 0, _startWidth, _startHeight));
 
     // Depending on where the offset is in relation to the edges of the CelRef, do the resize.
     QPointF offset = _startingMousePos - _startingCelPos;
@@ -180,9 +139,7 @@ void ResizeTool::onMousePressed(QGraphicsSceneMouseEvent *event){
     else if ((bottomRight <= xRadius) && (bottomRight <= yRadius))
         _op = _ResizeOp::BottomRight;
 
-    // If no other op has been chosen, chose a side one
-    // TODO, these is a bug here, this algorithm needs to be revised (try to do a left resize op, but when the mouse is far
-    //       away from the left cel
+    // If no other op has been chosen, chose the closest side
     if (_op == _ResizeOp::None) {
         // Make a list of pairs of the distances and operations
         QPair<qreal, _ResizeOp> l(left, _ResizeOp::Left);
@@ -195,7 +152,7 @@ void ResizeTool::onMousePressed(QGraphicsSceneMouseEvent *event){
         // Sort the list by first value of the pair
         qSort(sides.begin(), sides.end(),
             [](auto a, auto b) {
-                return (a.first <= b.first);
+                return (a.first < b.first);
             }
         );
 
@@ -208,10 +165,27 @@ void ResizeTool::onMousePressed(QGraphicsSceneMouseEvent *event){
 
 
 /*!
-    TODO document
+    Does the actual resize.  The Cel is reallocated once, and the pixels are moved so that the
+    edge (or corner) across from the one that was dragged stays put.
 */
 void ResizeTool::onMouseReleased(QGraphicsSceneMouseEvent *event){
     if (_resizingCel) {
+        BlitApp::app()->canvas()->overlay()->clear();
+
+        QRect rect = _newRect(event->scenePos());
+        Cel *cel = _ref->cel();
+        if (rect.size() != cel->size()) {
+            // Mask's coordinates would be for the old size
+            BlitApp::app()->selection()->clear();
+
+            if (cel->type() == PNG_CEL_TYPE)
+                ((PNGCel *)cel)->resize(-rect.x(), -rect.y(), rect.width(), rect.height());
+            else
+                cel->resize(rect.size());
+
+            _ref->setPos(_startingCelPos + rect.topLeft());
+        }
+
         // Reset
         _resizingCel = false;
         _startingCelPos = QPointF();
@@ -224,6 +198,37 @@ void ResizeTool::onMouseReleased(QGraphicsSceneMouseEvent *event){
 }
 
 
+/*!
+    Internal function.  Figures out where the Cel's edges would be if the mouse was at
+    \a scenePos, for the current resize op.  The returned rectangle is in Cel coordinates (so
+    its top left is how far the Cel's position will move), and it's always at least 1x1.
+*/
+QRect ResizeTool::_newRect(QPointF scenePos) {
+    // Normalize point
+    QPointF pos = scenePos - _startingMousePos;
+    int dx = qFloor(pos.x());
+    int dy = qFloor(pos.y());
+    int w = _startWidth;
+    int h = _startHeight;
+
+    // Based on which op, move the edges
+    int left = 0, top = 0, right = w, bottom = h;
+    switch (_op) {
+        case _ResizeOp::Left:           left = qMin(dx, w - 1);                                 break;
+        case _ResizeOp::Right:          right = qMax(w + dx, 1);                                break;
+        case _ResizeOp::Top:            top = qMin(dy, h - 1);                                  break;
+        case _ResizeOp::Bottom:         bottom = qMax(h + dy, 1);                               break;
+        case _ResizeOp::TopLeft:        left = qMin(dx, w - 1);     top = qMin(dy, h - 1);      break;
+        case _ResizeOp::TopRight:       right = qMax(w + dx, 1);    top = qMin(dy, h - 1);      break;
+        case _ResizeOp::BottomLeft:     left = qMin(dx, w - 1);     bottom = qMax(h + dy, 1);   break;
+        case _ResizeOp::BottomRight:    right = qMax(w + dx, 1);    bottom = qMax(h + dy, 1);   break;
+        default: break;
+    }
+
+    return QRect(left, top, right - left, bottom - top);
+}
+
+
 /*!
     Returns a string for \a op.  Returns an empty string if \a op
     isn't valid.
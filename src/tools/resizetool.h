@@ -10,6 +10,7 @@
 
 #include "tools/tool.h"
 #include <QPointF>
+#include <QRect>
 class CelRef;
 
 
@@ -41,6 +42,7 @@ private:
 
     // Member functions
     QString resizeOpStr(_ResizeOp op);
+    QRect _newRect(QPointF scenePos);
 
     // Member vars
     bool _resizingCel = false;
@@ -0,0 +1,345 @@
+// File:         selecttool.cpp
+// Author:       Ben Summerton (define-private-public)
+// Description:  Source implementation of the SelectTool Tool
+
+
+/*!
+    \inmodule Tools
+    \class SelectTool
+    \brief SelectTool makes Selections on the current Cel, and moves the selected pixels.
+
+    In rectangle and lasso mode, dragging outside of the selection makes a new one (only an
+    outline is shown while dragging; the mask is made on release).  A single click without
+    dragging deselects.  In magic wand mode, clicking selects the connected area that's
+    similar in color to the clicked pixel.
+
+    Dragging inside of the selection lifts the pixels up (see Selection::lift()) and moves
+    them.  The Scale option scales them.  They're put back into the Cel when Commit is
+    clicked, a new selection is made, or the selection is cleared.
+*/
+
+
+#include "tools/selecttool.h"
+#include "blitapp.h"
+#include "selection.h"
+#include "animation/celref.h"
+#include "animation/cel.h"
+#include "animation/pngcel.h"
+#include <QtMath>
+#include <QVector>
+#include <QIcon>
+#include <QSpinBox>
+#include <QComboBox>
+#include <QPushButton>
+#include <QHBoxLayout>
+#include <QFormLayout>
+#include <QGraphicsSceneMouseEvent>
+#include <cstring>
+
+
+// Export the Tool
+//Q_EXPORT_PLUGIN2(blit_tool_select, SelectTool);
+
+
+SelectTool::SelectTool(QObject *parent) :
+    Tool(parent)
+{
+    // Do nothing
+}
+
+
+SelectTool::~SelectTool() {
+    // Do nothing
+}
+
+
+QString SelectTool::name() {
+    // returns the name of the Tool
+    return tr("Select");
+}
+
+
+QString SelectTool::desc() {
+    // A small tooltip
+    return tr("Selects part of a Cel to move, scale, or draw inside of.");
+}
+
+
+QIcon SelectTool::icon() {
+    return QIcon(":/select_tool_icon");
+}
+
+
+QWidget *SelectTool::options() {
+    // Return apanel to change tool options
+    void (QSpinBox::*spinnerValueChanged)(int) = &QSpinBox::valueChanged;
+    void (QComboBox::*currentIndexChanged)(int) = &QComboBox::currentIndexChanged;
+
+    // Make the options panel
+    QWidget *optionsPanel = new QWidget();
+    optionsPanel->setMaximumWidth(TOOL_OPTIONS_PANEL_MAX_WIDTH);
+
+    // Mode
+    QComboBox *modeBox = new QComboBox(optionsPanel);
+    modeBox->addItem(tr("Rectangle"), RectMode);
+    modeBox->addItem(tr("Lasso"), LassoMode);
+    modeBox->addItem(tr("Magic Wand"), WandMode);
+    modeBox->setCurrentIndex(modeBox->findData(_mode));
+
+    // Tolerance (for the wand)
+    QSpinBox *toleranceSpinner = new QSpinBox(optionsPanel);
+    toleranceSpinner->setMinimum(0x00);
+    toleranceSpinner->setMaximum(0xFF);
+    toleranceSpinner->setValue(_tolerance);
+
+    // Scale (for floating pixels)
+    QSpinBox *scaleSpinner = new QSpinBox(optionsPanel);
+    scaleSpinner->setMinimum(1);
+    scaleSpinner->setMaximum(1600);
+    scaleSpinner->setSuffix("%");
+    scaleSpinner->setValue(_scale);
+
+    // Buttons
+    QPushButton *commitButton = new QPushButton(tr("Commit"), optionsPanel);
+    QPushButton *deselectButton = new QPushButton(tr("Deselect"), optionsPanel);
+
+    // Layout
+    QFormLayout *layout = new QFormLayout(optionsPanel);
+    QHBoxLayout *buttonLayout = new QHBoxLayout();
+    buttonLayout->addWidget(commitButton);
+    buttonLayout->addWidget(deselectButton);
+    layout->addRow(tr("Mode:"), modeBox);
+    layout->addRow(tr("Tolerance:"), toleranceSpinner);
+    layout->addRow(tr("Scale:"), scaleSpinner);
+    layout->addRow(buttonLayout);
+
+    // Signals & slots
+    connect(modeBox, currentIndexChanged, this, &SelectTool::_onModeComboBoxIndexChanged);
+    connect(toleranceSpinner, spinnerValueChanged, this, &SelectTool::_onToleranceSpinnerValueChanged);
+    connect(scaleSpinner, spinnerValueChanged, this, &SelectTool::_onScaleSpinnerValueChanged);
+    connect(commitButton, &QPushButton::clicked, this, &SelectTool::_onCommitButtonClicked);
+    connect(deselectButton, &QPushButton::clicked, this, &SelectTool::_onDeselectButtonClicked);
+
+    return optionsPanel;
+}
+
+
+void SelectTool::onMouseDoubleClicked(QGraphicsSceneMouseEvent *event) {
+    // Do nothing
+}
+
+
+void SelectTool::onMouseMoved(QGraphicsSceneMouseEvent *event) {
+    Selection *sel = BlitApp::app()->selection();
+    QPointF pt = event->scenePos() - _celPos;
+
+    if (_dragging) {
+        // Only the preview moves
+        sel->setFloatTransform(_startOffset + (pt - _anchor), _scale / 100.0);
+    } else if (_selecting) {
+        // Just show an outline for now, the mask gets made on release
+        if (_mode == RectMode)
+            sel->setPreview(QPolygonF(QRectF(_anchor, pt).normalized()));
+        else if (_mode == LassoMode) {
+            _lasso.append(pt);
+            sel->setPreview(_lasso);
+        }
+    }
+}
+
+
+void SelectTool::onMousePressed(QGraphicsSceneMouseEvent *event) {
+    // Needs a PNGCel to select on
+    CelRef *ref = BlitApp::app()->curCelRef();
+    Cel *cel = BlitApp::app()->curCel();
+    if (!ref || !cel || (cel->type() != PNG_CEL_TYPE))
+        return;
+
+    PNGCel *pc = (PNGCel *)cel;
+    Selection *sel = BlitApp::app()->selection();
+    _celPos = ref->pos();
+    QPointF pt = event->scenePos() - _celPos;
+
+    // Grab what's selected
+    if ((sel->cel() == pc) && sel->contains(QPoint(qFloor(pt.x()), qFloor(pt.y())))) {
+        if (!sel->isFloating()) {
+            sel->lift();
+            sel->setFloatTransform(QPointF(), _scale / 100.0);
+        }
+
+        _dragging = sel->isFloating();
+        _anchor = pt;
+        _startOffset = sel->floatOffset();
+        return;
+    }
+
+    // Put down anything that's floating before starting a new one
+    sel->commit();
+
+    switch (_mode) {
+        case RectMode:
+            _selecting = true;
+            _anchor = pt;
+            sel->setPreview(QPolygonF(QRectF(pt, pt)));
+            break;
+
+        case LassoMode:
+            _selecting = true;
+            _lasso.clear();
+            _lasso.append(pt);
+            sel->setPreview(_lasso);
+            break;
+
+        case WandMode:
+            _selectWand(pc, QPoint(qFloor(pt.x()), qFloor(pt.y())));
+            break;
+    }
+}
+
+
+void SelectTool::onMouseReleased(QGraphicsSceneMouseEvent *event) {
+    Selection *sel = BlitApp::app()->selection();
+    Cel *cel = BlitApp::app()->curCel();
+    PNGCel *pc = (cel && (cel->type() == PNG_CEL_TYPE)) ? (PNGCel *)cel : NULL;
+    QPointF pt = event->scenePos() - _celPos;
+
+    if (_selecting && pc) {
+        // Make the mask, a click without dragging deselects
+        if (_mode == RectMode) {
+            QRect rect = QRectF(_anchor, pt).normalized().toAlignedRect();
+            if ((rect.width() > 1) || (rect.height() > 1))
+                sel->selectRect(pc, rect);
+            else
+                sel->clear();
+        } else if (_mode == LassoMode) {
+            if (_lasso.size() >= 3)
+                sel->selectPolygon(pc, _lasso);
+            else
+                sel->clear();
+        }
+    }
+
+    // Cleanup state
+    sel->setPreview(QPolygonF());
+    _selecting = false;
+    _dragging = false;
+    _lasso.clear();
+    _celPos = QPointF();
+}
+
+
+void SelectTool::_onModeComboBoxIndexChanged(int index) {
+    // Combo box items are in the same order as the modes
+    _mode = (Mode)index;
+}
+
+
+void SelectTool::_onToleranceSpinnerValueChanged(int value) {
+    // How close a color has to be to get picked up by the wand
+    _tolerance = value;
+}
+
+
+void SelectTool::_onScaleSpinnerValueChanged(int value) {
+    // Scales the floating pixels (lifting them up if needed)
+    _scale = value;
+
+    Selection *sel = BlitApp::app()->selection();
+    if (sel->isEmpty())
+        return;
+
+    if (!sel->isFloating())
+        sel->lift();
+    sel->setFloatTransform(sel->floatOffset(), _scale / 100.0);
+}
+
+
+void SelectTool::_onCommitButtonClicked() {
+    // Puts the floating pixels down
+    BlitApp::app()->selection()->commit();
+}
+
+
+void SelectTool::_onDeselectButtonClicked() {
+    // Puts down anything floating and drops the selection
+    BlitApp::app()->selection()->clear();
+}
+
+
+/*!
+    Internal function.  Selects the area connected to \a seed on \a cel where the color is
+    within the tolerance of the color at \a seed.  A scanline flood is used, so each pixel is
+    only looked at a few times.
+*/
+void SelectTool::_selectWand(PNGCel *cel, QPoint seed) {
+    QImage *img = cel->imageData();
+    if (!img || !img->rect().contains(seed))
+        return;
+
+    QImage ref = img->convertToFormat(QImage::Format_ARGB32);
+    int w = ref.width(), h = ref.height();
+    QRgb target = ref.pixel(seed);
+
+    // Work out which pixels are close enough first, so the flood doesn't have to
+    QVector<uchar> inside(w * h);
+    for (int y = 0; y < h; y++) {
+        const QRgb *row = (const QRgb *)ref.constScanLine(y);
+        uchar *in = inside.data() + (y * w);
+        for (int x = 0; x < w; x++) {
+            QRgb c = row[x];
+            int d = qMax(qMax(qAbs(qRed(c) - qRed(target)), qAbs(qGreen(c) - qGreen(target))),
+                         qMax(qAbs(qBlue(c) - qBlue(target)), qAbs(qAlpha(c) - qAlpha(target))));
+            in[x] = (d <= _tolerance);
+        }
+    }
+
+    // Flood it
+    QImage mask(w, h, QImage::Format_Alpha8);
+    mask.fill(0x00);
+    int minX = w, minY = h, maxX = -1, maxY = -1;
+
+    QVector<QPoint> stack;
+    stack.append(seed);
+    while (!stack.isEmpty()) {
+        QPoint p = stack.takeLast();
+        uchar *in = inside.data() + (p.y() * w);
+        uchar *m = mask.scanLine(p.y());
+        if (!in[p.x()] || m[p.x()])
+            continue;
+
+        // Go out to the ends of the span
+        int l = p.x(), r = p.x();
+        while ((l > 0) && in[l - 1] && !m[l - 1])
+            l--;
+        while ((r < (w - 1)) && in[r + 1] && !m[r + 1])
+            r++;
+
+        std::memset(m + l, 0xFF, r - l + 1);
+        minX = qMin(minX, l);
+        maxX = qMax(maxX, r);
+        minY = qMin(minY, p.y());
+        maxY = qMax(maxY, p.y());
+
+        // Look for spans above and below
+        for (int ny = p.y() - 1; ny <= p.y() + 1; ny += 2) {
+            if ((ny < 0) || (ny >= h))
+                continue;
+
+            uchar *nin = inside.data() + (ny * w);
+            uchar *nm = mask.scanLine(ny);
+            bool inSpan = false;
+            for (int x = l; x <= r; x++) {
+                bool open = nin[x] && !nm[x];
+                if (open && !inSpan)
+                    stack.append(QPoint(x, ny));
+                inSpan = open;
+            }
+        }
+    }
+
+    if (maxX < 0)
+        return;
+
+    QRect bounds(QPoint(minX, minY), QPoint(maxX, maxY));
+    BlitApp::app()->selection()->selectMask(cel, mask.copy(bounds), bounds);
+}
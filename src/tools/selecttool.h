@@ -0,0 +1,77 @@
+// File:         selecttool.h
+// Author:       Ben Summerton (define-private-public)
+// Description:  SelectTool is an implementation of the Tool interface.  It comes standard in Blit.
+//               It makes rectangle, lasso, and magic wand selections, and moves/scales what's
+//               selected.
+
+
+#ifndef SELECT_TOOL_H
+#define SELECT_TOOL_H
+
+
+#include "tools/tool.h"
+#include <QPointF>
+#include <QPolygonF>
+class PNGCel;
+class QSpinBox;
+
+
+class SelectTool : public Tool {
+    Q_OBJECT;
+    Q_INTERFACES(Tool);
+
+
+public:
+    enum Mode {
+        RectMode,        // Drag out a rectangle
+        LassoMode,        // Draw around the area freehand
+        WandMode        // Pick an area of similar color
+    };
+
+    SelectTool(QObject *parent=NULL);
+    ~SelectTool();
+
+    // Tool Info
+    QString name();
+    QString desc();
+    QIcon icon();
+
+    QWidget *options();
+
+
+public slots:
+    // For drawing
+    void onMouseDoubleClicked(QGraphicsSceneMouseEvent *event);
+    void onMouseMoved(QGraphicsSceneMouseEvent *event);
+    void onMousePressed(QGraphicsSceneMouseEvent *event);
+    void onMouseReleased(QGraphicsSceneMouseEvent *event);
+
+
+private slots:
+    void _onModeComboBoxIndexChanged(int index);
+    void _onToleranceSpinnerValueChanged(int value);
+    void _onScaleSpinnerValueChanged(int value);
+    void _onCommitButtonClicked();
+    void _onDeselectButtonClicked();
+
+
+private:
+    void _selectWand(PNGCel *cel, QPoint seed);
+
+    // Member vars
+    Mode _mode = RectMode;
+    int _tolerance = 0;
+    int _scale = 100;                // Percent, for the floating selection
+
+    // State variables
+    bool _selecting = false;        // Dragging out a new selection
+    bool _dragging = false;            // Moving the floating selection
+    QPointF _celPos;
+    QPointF _anchor;                // Where the selection/drag started (Cel coordinates)
+    QPointF _startOffset;            // Float offset when the drag started
+    QPolygonF _lasso;
+
+};
+
+
+#endif // SELECT_TOOL_H
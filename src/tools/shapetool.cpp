@@ -25,12 +25,14 @@
 #include "blitapp.h"
 #include "util.h"
 #include "animation/celref.h"
+#include "tools/rasterizer.h"
+#include "widgets/drawing/canvas.h"
+#include "widgets/drawing/overlayitem.h"
 #include <QtMath>
 #include <QVector>
 #include <QPoint>
 #include <QPointF>
 #include <QPixmap>
-#include <QPainter>
 #include <QIcon>
 #include <QLabel>
 #include <QSpinBox>
@@ -40,18 +42,6 @@
 #include <QGraphicsSceneMouseEvent>
 
 
-/*== OVERLOADED qHash function ==*/
-inline uint qHash(const QPoint p) {
-    // Should be unique as possible
-    return qFloor(qPow(p.x(), p.y()));
-}
-
-inline uint qHash(const QPointF p) {
-    return qHash(p.toPoint());
-}
-/*== OVERLOADED WARNING ==*/
-
-
 // Export the Tool
 //Q_EXPORT_PLUGIN2(blit_tool_pen, ShapeTool);
 
@@ -113,15 +103,21 @@ QWidget *ShapeTool::options() {
 //    _sameSizeBox->setChecked(_sameSize);
 //    _sameSizeBox->setEnabled(_shape != Polygon);
 
+    // Filled option
+    QCheckBox *filledBox = new QCheckBox(optionsPanel);
+    filledBox->setChecked(_filled);
+
     // Layout
     QFormLayout *layout = new QFormLayout(optionsPanel);
     layout->addRow(tr("Size:"), sizeSpinner);
     layout->addRow(tr("Shape:"), shapeBox);
+    layout->addRow(tr("Filled:"), filledBox);
 //    layout->addRow(tr("Same Size:"), _sameSizeBox);
 
     // Signals & slots
     connect(sizeSpinner, spinnerValueChanged, this, &ShapeTool::_onSizeSpinnerValueChanged);
     connect(shapeBox, currentIndexChanged, this, &ShapeTool::_onShapeBoxChanged);
+    connect(filledBox, &QCheckBox::clicked, this, &ShapeTool::_onFilledBoxClicked);
 //    connect(_sameSizeBox, &QCheckBox::clicked, this, &ShapeTool::_onSameSizeBoxClicked);
 
     return optionsPanel;
@@ -170,7 +166,7 @@ void ShapeTool::onMousePressed(QGraphicsSceneMouseEvent *event) {
 
         // Cel stuff
         _celPos = ref->pos();
-        _celImage = new QImage(BlitApp::app()->celImage());
+        BlitApp::app()->canvas()->overlay()->setPos(_celPos);
 
         // Calculate the start point
         _startPoint = event->scenePos(); //.toPoint();
@@ -235,21 +231,20 @@ void ShapeTool::_onSameSizeBoxClicked(bool checked) {
 }
 
 
+/*!
+    Switches between drawing only the outline of the shapes, or filling them in.
+*/
+void ShapeTool::_onFilledBoxClicked(bool checked) {
+    _filled = checked;
+}
+
+
 void ShapeTool::_transferDrawing() {
-    // Internal function.  Used to transfer the current drawing to the Cel.  Requires that the 
-    // ShapeTool is down.
+    // Internal function.  Used to show the current drawing in the Canvas' overlay.  Requires
+    // that the ShapeTool is down.
     if (!_penDown)
         return;
 
-    // for pen
-    QPen drawBuffPen(_pen);
-    drawBuffPen.setColor(Qt::black);
-
-    // Drawing buffer
-    QImage drawBuff = util::mkBlankImage(_celImage->size());
-    QPainter drawBuffPainter(&drawBuff);
-    drawBuffPainter.setPen(drawBuffPen);
-
     // compute the bounds
     QPoint tl(_startPoint.toPoint() - _celPos.toPoint());        // Top Left
     QPoint wh(_curPoint.toPoint() - _celPos.toPoint());            // Width & Height
@@ -315,87 +310,53 @@ void ShapeTool::_transferDrawing() {
 
 
     // Chose a shape to draw
+    raster::Spans spans;
+    int width = _pen.width();
+    QRect bounds(tl, tl + wh);
+
     switch (_shape) {
         case Box:
-            // Draw the four corners (have to do this because of how QPainter works
-            drawBuffPainter.drawPoint(tl);                        // Top Left
-            drawBuffPainter.drawPoint(tl.x() + wh.x(), tl.y());    // Top Right
-            drawBuffPainter.drawPoint(tl + wh);                    // Bottom Right
-            drawBuffPainter.drawPoint(tl.x(), tl.y() + wh.y());
-
-            // Draw the box
-            drawBuffPainter.drawRect(tl.x(), tl.y(), wh.x(), wh.y());
+            raster::rect(spans, bounds, width, _filled);
             break;
 
         case Ellipse:
-            // Always draw a point
-            if (wh.isNull())
-                drawBuffPainter.drawPoint(tl);
-            
-            drawBuffPainter.drawEllipse(tl.x(), tl.y(), wh.x(), wh.y());
+            raster::ellipse(spans, bounds, width, _filled);
             break;
 
-        case Polygon:
-            // TODO can't really rely on QPainter's line drawing system since wern't not getting
-            //      lines from pixel to pixel.  It's kind of difficult to explain, but we need
-            //      to figure out how to work with it so we Don't have to do this janky hack
-            //      down here and implement the bresenham line algorithm for what should be a
-            //      minor task.  the current method also makes it so Antialising cannot work.
-            // If we have some points, then draw them.
-            if (_points.size() > 0) {
-                QVector<QPoint> toDraw;
-                _points.push_back(_curPoint);        // Temporary
-
-                // Go thorugh all of the points
-                QList<QPointF>::const_iterator iter = _points.begin();
-                QPointF cur, prev = *iter;
-                toDraw << prev.toPoint();            // Add the first
-                while ((iter + 1) < _points.end()) {
-                    // goto the next point
-                    iter++;
-                    cur = *iter;
-
-                    // Add the point to the vector to draw
-                    toDraw << cur.toPoint();
-                    toDraw << math::bresenhamLinePoints(prev, cur).toVector();
-
-                    // Setup for the next point
-                    prev = cur;
-                }
-
-                // Do the drawing of the points
-                drawBuffPainter.save();
-                drawBuffPainter.translate(-_celPos);
-                drawBuffPainter.drawPoints(toDraw.data(), toDraw.size());
-                drawBuffPainter.restore();
-
-                _points.pop_back();                // And take it off
+        case Polygon: {
+            // All of the corners so far, plus where the mouse is
+            QVector<QPoint> corners;
+            _points.push_back(_curPoint);        // Temporary
+            for (auto iter = _points.begin(); iter != _points.end(); iter++) {
+                QPointF pt = *iter - _celPos;
+                corners.append(QPoint(qFloor(pt.x()), qFloor(pt.y())));
             }
+            _points.pop_back();                    // And take it off
+
+            if (_filled)
+                raster::polygon(spans, corners);
+            raster::polyline(spans, corners, width);
             break;
+        }
     }
 
-
-    drawBuffPainter.setCompositionMode(QPainter::CompositionMode_SourceIn);
-    drawBuffPainter.fillRect(0, 0, drawBuff.width(), drawBuff.height(), _pen.color());
-
-    // Then put it onto the Cel
-    QImage celBuff = _celImage->copy();
-    QPainter celBuffPainter(&celBuff);
-    celBuffPainter.drawImage(0, 0, drawBuff);
-
-    // Apply the update
-    BlitApp::app()->copyOntoCel(celBuff);
+    // Only preview it, _reset() puts it onto the Cel
+    BlitApp::app()->canvas()->overlay()->setSpans(spans, _pen.color());
 }
 
 
 /*!
-    Used to reset the state of the tool after a drawing is done.
+    Used to reset the state of the tool after a drawing is done.  The shape that was being
+    previewed is put onto the Cel.
 */
 void ShapeTool::_reset() {
     // Only do stuff if the pen is down
     if (!_penDown)
         return;
 
+    // Done drawing
+    BlitApp::app()->canvas()->overlay()->commit();
+
     // Null out
     _startPoint = QPointF();
     _curPoint = QPointF();
@@ -406,8 +367,6 @@ void ShapeTool::_reset() {
 
     // Cel stuff
     _celPos = QPointF();
-    delete _celImage;
-    _celImage = NULL;
 
     // Bring the pen back up
     _penDown = false;
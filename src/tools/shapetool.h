@@ -44,6 +44,7 @@ private slots:
     // For options panel
     void _onShapeBoxChanged(int index);
     void _onSameSizeBoxClicked(bool checked);
+    void _onFilledBoxClicked(bool checked);
 
 
 public slots:
@@ -63,6 +64,7 @@ private:
     QPen _pen;
     Shape _shape;
     bool _sameSize = false;
+    bool _filled = false;            // Fill in the shape instead of just outlining it
     QPointer<QCheckBox> _sameSizeBox;
 
     // State variables for when painting
@@ -72,7 +74,6 @@ private:
     QPointF _startPoint;
     QPointF _curPoint;
     QPointF _celPos;
-    QImage *_celImage = NULL;
 
 };
 
@@ -0,0 +1,247 @@
+// File:         strokeengine.cpp
+// Author:       Ben Summerton (define-private-public)
+// Description:  Source implementation of the StrokeEngine class
+
+
+/*!
+    \class StrokeEngine
+    \brief StrokeEngine draws a stroke into the current Cel, one segment at a time.
+
+    At the start of a stroke a snapshot of the Cel is taken (once) and a coverage
+    mask is made.  Each new segment is drawn into the mask, and then only the area
+    around that segment is redone in the Cel: it's restored from the snapshot and
+    the colored (or erasing) mask is composited on top.  Keeping the mask (instead
+    of drawing each segment straight onto the Cel) means that overlapping segments
+    of a translucent stroke don't build up.
+
+    The Cel is painted in place (see PNGCel::imageData()), and only the changed
+    area is reported with PNGCel::damage(), so the cost of each segment depends on
+    the size of the segment and not the size of the Cel.
+
+    Mouse moves can come in a lot faster than the screen can show them.  Points
+    given to lineTo() are only queued up, and once per display frame (or when
+    flush() is called) they are all drawn as one polyline.  This keeps the amount
+    of work per update bounded no matter how fast the events come in.
+*/
+
+
+#include "tools/strokeengine.h"
+#include "blitapp.h"
+#include "util.h"
+#include "animation/cel.h"
+#include "animation/pngcel.h"
+#include <QPainter>
+#include <QPolygonF>
+#include <QRectF>
+#include <QGuiApplication>
+#include <QScreen>
+#include <QtMath>
+#include <QDebug>
+
+
+StrokeEngine::StrokeEngine(QObject *parent) :
+    QObject(parent)
+{
+    _flushTimer.setSingleShot(true);
+    connect(&_flushTimer, &QTimer::timeout, this, &StrokeEngine::_onFlushTimerTimeout);
+}
+
+
+StrokeEngine::~StrokeEngine() {
+    // Do nothing
+}
+
+
+/*!
+    Starts a new stroke on the current Cel.  \a width is the size of the pen, and
+    \a clr is the color to paint with (for Paint) or the amount to erase by using
+    its alpha (for Erase).
+
+    Returns false if there isn't a current Cel that can be drawn on.  Any stroke
+    that is still going will be ended first.
+*/
+bool StrokeEngine::begin(Mode mode, qreal width, QColor clr) {
+    if (active())
+        end();
+
+    // Only PNGCels that are loaded can be painted in place
+    Cel *cel = BlitApp::app()->curCel();
+    if (!cel || (cel->type() != PNG_CEL_TYPE))
+        return false;
+
+    PNGCel *pc = (PNGCel *)cel;
+    if (!pc->imageData())
+        return false;
+
+    // Setup state; the snapshot is a shallow copy, the Cel detaches from it on the first edit
+    _cel = pc;
+    _mode = mode;
+    _clr = clr;
+    _snapshot = *pc->imageData();
+    _mask = util::mkBlankImage(pc->size());
+    _pen = QPen(Qt::black, width, Qt::SolidLine, Qt::RoundCap, Qt::RoundJoin);
+    _strokeRect = QRect();
+    _pending.clear();
+
+    // Batch up points at the rate of the display
+    qreal fps = 60;
+    QScreen *screen = QGuiApplication::primaryScreen();
+    if (screen && (screen->refreshRate() > 0))
+        fps = screen->refreshRate();
+    _flushTimer.setInterval(qMax(1, qRound(1000.0 / fps)));
+
+    return true;
+}
+
+
+/*!
+    Finishes up the current stroke (drawing any points that are still queued up)
+    and lets go of the snapshot and mask.
+*/
+void StrokeEngine::end() {
+    flush();
+    _flushTimer.stop();
+
+    _cel = NULL;
+    _snapshot = QImage();
+    _mask = QImage();
+}
+
+
+/*!
+    Returns true if a stroke is currently being drawn.
+*/
+bool StrokeEngine::active() {
+    return !_cel.isNull();
+}
+
+
+/*!
+    Draws a single point of the stroke at \a pt.  Should be used for the first
+    point of a stroke.
+*/
+void StrokeEngine::drawPoint(QPointF pt) {
+    if (!active())
+        return;
+
+    QPainter p(&_mask);
+    p.setPen(_pen);
+    p.drawPoint(pt);
+    p.end();
+    _lastPoint = pt;
+
+    qreal pad = _pen.widthF() + 1;
+    _apply(QRectF(pt.x() - pad, pt.y() - pad, pad * 2, pad * 2).toAlignedRect());
+}
+
+
+/*!
+    Draws the segment of the stroke from \a a to \a b.
+*/
+void StrokeEngine::drawLine(QPointF a, QPointF b) {
+    if (!active())
+        return;
+
+    QPainter p(&_mask);
+    p.setPen(_pen);
+    p.drawLine(a, b);
+    p.end();
+    _lastPoint = b;
+
+    qreal pad = _pen.widthF() + 1;
+    _apply(QRectF(a, b).normalized().adjusted(-pad, -pad, pad, pad).toAlignedRect());
+}
+
+
+/*!
+    Continues the stroke from the last point drawn to \a pt.  The point is queued
+    up, and drawn along with any others at the next display frame.
+
+    \sa flush()
+*/
+void StrokeEngine::lineTo(QPointF pt) {
+    if (!active())
+        return;
+
+    _pending.append(pt);
+    if (!_flushTimer.isActive())
+        _flushTimer.start();
+}
+
+
+/*!
+    Draws all of the points queued up by lineTo() right now, as a single polyline.
+*/
+void StrokeEngine::flush() {
+    if (!active() || _pending.isEmpty())
+        return;
+
+    // One polyline from where the stroke left off
+    QPolygonF line;
+    line.reserve(_pending.size() + 1);
+    line << _lastPoint;
+    for (auto iter = _pending.begin(); iter != _pending.end(); iter++)
+        line << *iter;
+    _pending.clear();
+
+    QPainter p(&_mask);
+    p.setPen(_pen);
+    p.drawPolyline(line);
+    p.end();
+    _lastPoint = line.last();
+
+    qreal pad = _pen.widthF() + 1;
+    _apply(line.boundingRect().adjusted(-pad, -pad, pad, pad).toAlignedRect());
+}
+
+
+/*!
+    Triggered by the flush timer, draws the queued up points.
+*/
+void StrokeEngine::_onFlushTimerTimeout() {
+    flush();
+}
+
+
+/*!
+    Returns the area of the Cel that has been touched by the current stroke so far.
+*/
+QRect StrokeEngine::strokeRect() {
+    return _strokeRect;
+}
+
+
+/*!
+    Internal function.  Redoes \a rect of the Cel from the snapshot and the mask,
+    then tells the Cel about it.
+*/
+void StrokeEngine::_apply(QRect rect) {
+    QImage *img = _cel ? _cel->imageData() : NULL;
+    if (!img)
+        return;
+
+    rect &= img->rect();
+    if (rect.isEmpty())
+        return;
+
+    // Color (or set the erase amount of) just this part of the stroke
+    QImage stroke = _mask.copy(rect);
+    QPainter sp(&stroke);
+    sp.setCompositionMode(QPainter::CompositionMode_SourceIn);
+    sp.fillRect(stroke.rect(), _clr);
+    sp.end();
+
+    // Restore from the snapshot, then lay the stroke on
+    QPainter p(img);
+    p.setCompositionMode(QPainter::CompositionMode_Source);
+    p.drawImage(rect.topLeft(), _snapshot, rect);
+    if (_mode == Erase)
+        p.setCompositionMode(QPainter::CompositionMode_DestinationOut);
+    else
+        p.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    p.drawImage(rect.topLeft(), stroke);
+    p.end();
+
+    _strokeRect |= rect;
+    _cel->damage(rect);
+}
@@ -0,0 +1,71 @@
+// File:         strokeengine.h
+// Author:       Ben Summerton (define-private-public)
+// Description:  StrokeEngine rasterizes strokes from the stroke based tools (e.g. Pen & Eraser)
+//               directly into the current Cel, one batch of points per display frame.
+
+
+#ifndef STROKE_ENGINE_H
+#define STROKE_ENGINE_H
+
+
+#include <QObject>
+#include <QPointF>
+#include <QVector>
+#include <QTimer>
+#include <QRect>
+#include <QColor>
+#include <QImage>
+#include <QPen>
+#include <QPointer>
+class PNGCel;
+
+
+class StrokeEngine : public QObject {
+    Q_OBJECT;
+
+public:
+    enum Mode {
+        Paint,        // Stroke is painted over the Cel with the color
+        Erase        // Stroke erases from the Cel, the color's alpha is how much
+    };
+
+    StrokeEngine(QObject *parent=NULL);
+    ~StrokeEngine();
+
+    // Stroke lifetime
+    bool begin(Mode mode, qreal width, QColor clr);
+    void end();
+    bool active();
+
+    // Drawing (in Cel coordinates)
+    void drawPoint(QPointF pt);
+    void drawLine(QPointF a, QPointF b);
+    void lineTo(QPointF pt);
+    void flush();
+
+    // Info
+    QRect strokeRect();
+
+
+private slots:
+    void _onFlushTimerTimeout();
+
+
+private:
+    void _apply(QRect rect);
+
+    QPointer<PNGCel> _cel;        // Cel being drawn on, NULL when not in a stroke
+    Mode _mode = Paint;
+    QColor _clr;
+    QPen _pen;                    // Used to draw into _mask
+    QImage _snapshot;            // The Cel's image from before the stroke
+    QImage _mask;                // Coverage of the stroke so far
+    QRect _strokeRect;            // Everything the stroke has touched so far
+    QPointF _lastPoint;            // End of the stroke that's been drawn
+    QVector<QPointF> _pending;    // Points from lineTo() that haven't been drawn yet
+    QTimer _flushTimer;            // Draws the pending points once per display frame
+
+};
+
+
+#endif // STROKE_ENGINE_H
@@ -0,0 +1,547 @@
+// File:         undohistory.cpp
+// Author:       Ben Summerton (define-private-public)
+// Description:  Source implementation of the UndoHistory, CelTilesCommand & TimingCommand classes
+
+
+/*!
+    \class UndoHistory
+    \brief UndoHistory records edits to Cels so they can be undone and redone.
+
+    An edit is started with beginCelEdit() (BlitApp does this when the mouse is pressed on the
+    Canvas) and finished with endCelEdit() (after the mouse is released).  In between, the
+    Cel::damaged() signal is used to find out what area was changed.  Only the tiles of that
+    area that actually changed are saved, compressed, as a CelTilesCommand on a QUndoStack.
+
+    There is a limit to how much memory the saved tiles can take up.  When it's gone over,
+    the oldest steps are moved out into a temporary file on the disk, and are read back in
+    when they are needed.
+*/
+
+
+#include "undohistory.h"
+#include "animation/pngcel.h"
+#include "animation/xsheet.h"
+#include "animation/timedframe.h"
+#include "blitapp.h"
+#include <QUndoStack>
+#include <QTemporaryFile>
+#include <QDataStream>
+#include <QDebug>
+#include <cstring>
+
+
+/*!
+    Creates an empty UndoHistory.
+*/
+UndoHistory::UndoHistory(QObject *parent) :
+    QObject(parent)
+{
+    _stack = new QUndoStack(this);
+    _stack->setUndoLimit(UNDO_DEFAULT_STEP_LIMIT);
+}
+
+
+/*!
+    Cleans up, and removes the spill file (if there is one).
+*/
+UndoHistory::~UndoHistory() {
+    // Commands need the spill file, so they go first
+    _stack->clear();
+}
+
+
+/*!
+    Returns the underlying QUndoStack.  Useful for making undo/redo actions.
+*/
+QUndoStack *UndoHistory::stack() {
+    return _stack;
+}
+
+
+/*!
+    Returns how many bytes of saved tiles can be kept in memory before older steps are
+    moved out to the disk.
+*/
+qint64 UndoHistory::memoryLimit() {
+    return _memoryLimit;
+}
+
+
+/*!
+    Sets how many \a bytes of saved tiles can be kept in memory.  If it's already over, older
+    steps will be moved out to the disk right away.
+*/
+void UndoHistory::setMemoryLimit(qint64 bytes) {
+    _memoryLimit = qMax((qint64)0, bytes);
+    _enforceMemoryLimit();
+}
+
+
+/*!
+    Returns how many bytes of saved tiles are currently being kept in memory.
+*/
+qint64 UndoHistory::memoryUsage() {
+    qint64 total = 0;
+    for (int i = 0; i < _stack->count(); i++) {
+        CelTilesCommand *cmd = dynamic_cast<CelTilesCommand *>(const_cast<QUndoCommand *>(_stack->command(i)));
+        if (cmd)
+            total += cmd->memoryUsage();
+    }
+
+    return total;
+}
+
+
+/*!
+    Starts recording an edit to \a cel.  If an edit is already being recorded, that one will be
+    finished first.  Does nothing if \a cel is NULL or isn't loaded.
+
+    \sa endCelEdit()
+*/
+void UndoHistory::beginCelEdit(PNGCel *cel) {
+    if (editing())
+        endCelEdit();
+
+    if (!cel || !cel->imageData())
+        return;
+
+    // Shallow copy, the Cel's image detaches from it when it's first painted on
+    _editCel = cel;
+    _editBefore = *cel->imageData();
+    _editRect = QRect();
+    connect(cel, &Cel::damaged, this, &UndoHistory::_onCelDamaged);
+}
+
+
+/*!
+    Returns true if an edit is being recorded right now.
+*/
+bool UndoHistory::editing() {
+    return !_editCel.isNull();
+}
+
+
+/*!
+    Finishes recording the current edit.  If any part of the Cel was changed, a new step is
+    pushed onto the stack.
+
+    \sa beginCelEdit()
+*/
+void UndoHistory::endCelEdit() {
+    if (!editing()) {
+        _editBefore = QImage();
+        return;
+    }
+
+    PNGCel *cel = _editCel;
+    disconnect(cel, &Cel::damaged, this, &UndoHistory::_onCelDamaged);
+
+    // Save what changed
+    QImage *after = cel->imageData();
+    if (!_editRect.isEmpty() && after) {
+        if (after->size() == _editBefore.size()) {
+            CelTilesCommand *cmd = new CelTilesCommand(this, cel, _editBefore, *after, _editRect);
+            if (cmd->isEmpty())
+                delete cmd;
+            else {
+                _stack->push(cmd);
+                _enforceMemoryLimit();
+            }
+        } else
+            qDebug() << "[UndoHistory endCelEdit] Cel" << cel->name() << "was resized during the edit, it can't be undone";
+    }
+
+    // Cleanup
+    _editCel = NULL;
+    _editBefore = QImage();
+    _editRect = QRect();
+}
+
+
+/*!
+    Undoes the last step.
+*/
+void UndoHistory::undo() {
+    endCelEdit();
+    _stack->undo();
+}
+
+
+/*!
+    Redoes the last step that was undone.
+*/
+void UndoHistory::redo() {
+    endCelEdit();
+    _stack->redo();
+}
+
+
+/*!
+    Throws away all of the steps (e.g. when a new Animation is loaded).  The spill file is
+    removed too.
+*/
+void UndoHistory::clear() {
+    // Don't let a half done edit be pushed after this
+    if (_editCel)
+        disconnect(_editCel, &Cel::damaged, this, &UndoHistory::_onCelDamaged);
+    _editCel = NULL;
+    _editBefore = QImage();
+    _editRect = QRect();
+
+    _stack->clear();
+
+    if (_spillFile) {
+        delete _spillFile;
+        _spillFile = NULL;
+    }
+}
+
+
+/*!
+    Appends \a data to the spill file, and returns where it was put.  Returns -1 if it couldn't
+    be written.
+
+    \sa unspill()
+*/
+qint64 UndoHistory::spill(const QByteArray &data) {
+    // Make the file the first time it's needed
+    if (!_spillFile) {
+        _spillFile = new QTemporaryFile(this);
+        if (!_spillFile->open()) {
+            qDebug() << "[UndoHistory spill] couldn't open a temporary file for undo history";
+            delete _spillFile;
+            _spillFile = NULL;
+            return -1;
+        }
+    }
+
+    qint64 offset = _spillFile->size();
+    if (!_spillFile->seek(offset) || (_spillFile->write(data) != data.size())) {
+        qDebug() << "[UndoHistory spill] couldn't write to" << _spillFile->fileName();
+        return -1;
+    }
+
+    return offset;
+}
+
+
+/*!
+    Reads \a size bytes back out of the spill file from \a offset.
+
+    \sa spill()
+*/
+QByteArray UndoHistory::unspill(qint64 offset, qint64 size) {
+    if (!_spillFile || !_spillFile->seek(offset))
+        return QByteArray();
+
+    return _spillFile->read(size);
+}
+
+
+/*!
+    Called via Cel::damaged() while an edit is being recorded, keeps track of the area that
+    was changed.
+*/
+void UndoHistory::_onCelDamaged(QRect rect) {
+    _editRect |= rect;
+}
+
+
+/*!
+    Internal function.  Moves the oldest steps out to the disk until the memory usage is under
+    the limit.
+*/
+void UndoHistory::_enforceMemoryLimit() {
+    qint64 usage = memoryUsage();
+    for (int i = 0; (i < _stack->count()) && (usage > _memoryLimit); i++) {
+        CelTilesCommand *cmd = dynamic_cast<CelTilesCommand *>(const_cast<QUndoCommand *>(_stack->command(i)));
+        if (!cmd || cmd->spilled())
+            continue;
+
+        qint64 before = cmd->memoryUsage();
+        cmd->spill();
+        usage -= (before - cmd->memoryUsage());
+    }
+}
+
+
+
+/*!
+    \class CelTilesCommand
+    \brief CelTilesCommand is one step of UndoHistory, an edit to a single Cel.
+
+    \a rect of \a cel is split up into tiles of UNDO_TILE_SIZE.  Only tiles where \a before and
+    \a after are different are kept.  Their pixels from before and after the edit are packed
+    together and compressed.
+*/
+CelTilesCommand::CelTilesCommand(UndoHistory *history, PNGCel *cel, const QImage &before, const QImage &after, QRect rect) :
+    QUndoCommand(QObject::tr("Edit %1").arg(cel->name())),
+    _history(history),
+    _cel(cel),
+    _celSize(after.size())
+{
+    QImage b = before.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    QImage a = after.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    rect &= a.rect();
+    if (rect.isEmpty())
+        return;
+
+    // Line the tiles up on the grid
+    int ts = UNDO_TILE_SIZE;
+    int left = (rect.left() / ts) * ts;
+    int top = (rect.top() / ts) * ts;
+
+    QByteArray raw;
+    QDataStream out(&raw, QIODevice::WriteOnly);
+    for (int ty = top; ty <= rect.bottom(); ty += ts) {
+        for (int tx = left; tx <= rect.right(); tx += ts) {
+            QRect tile = QRect(tx, ty, ts, ts) & a.rect();
+            int rowBytes = tile.width() * 4;
+
+            // Skip the tiles that are the same
+            bool same = true;
+            for (int y = tile.top(); same && (y <= tile.bottom()); y++)
+                same = (std::memcmp(b.constScanLine(y) + (tile.left() * 4), a.constScanLine(y) + (tile.left() * 4), rowBytes) == 0);
+            if (same)
+                continue;
+
+            // Before, then after
+            out << tile;
+            for (int y = tile.top(); y <= tile.bottom(); y++)
+                out.writeRawData((const char *)b.constScanLine(y) + (tile.left() * 4), rowBytes);
+            for (int y = tile.top(); y <= tile.bottom(); y++)
+                out.writeRawData((const char *)a.constScanLine(y) + (tile.left() * 4), rowBytes);
+
+            _numTiles++;
+        }
+    }
+
+    if (_numTiles > 0)
+        _data = qCompress(raw, 1);
+}
+
+
+CelTilesCommand::~CelTilesCommand() {
+    // Nothing to do, the spill file is cleaned up with the UndoHistory
+}
+
+
+/*!
+    Returns true if none of the tiles were changed.
+*/
+bool CelTilesCommand::isEmpty() {
+    return (_numTiles == 0);
+}
+
+
+/*!
+    Returns how many bytes this step is taking up in memory.
+*/
+qint64 CelTilesCommand::memoryUsage() {
+    return _data.size();
+}
+
+
+/*!
+    Returns true if the tiles have been moved out to the disk.
+*/
+bool CelTilesCommand::spilled() {
+    return (_spillOffset >= 0);
+}
+
+
+/*!
+    Moves the tiles out to the UndoHistory's spill file to free up memory.
+*/
+void CelTilesCommand::spill() {
+    if (spilled() || _data.isEmpty())
+        return;
+
+    qint64 offset = _history->spill(_data);
+    if (offset < 0)
+        return;        // Couldn't, keep it in memory
+
+    _spillOffset = offset;
+    _spillSize = _data.size();
+    _data = QByteArray();
+}
+
+
+/*!
+    Puts the tiles from before the edit back.
+*/
+void CelTilesCommand::undo() {
+    _apply(false);
+}
+
+
+/*!
+    Puts the tiles from after the edit back.  Does nothing the first time it's called, since
+    the edit has already been made when this is pushed onto the stack.
+*/
+void CelTilesCommand::redo() {
+    if (_firstRedo) {
+        _firstRedo = false;
+        return;
+    }
+
+    _apply(true);
+}
+
+
+/*!
+    Internal function.  Writes the saved tiles into the Cel, either the ones from \a after or
+    from before the edit.  Only the area of the tiles is repainted.
+*/
+void CelTilesCommand::_apply(bool after) {
+    if (!_cel || (_numTiles == 0))
+        return;
+
+    if (_cel->size() != _celSize) {
+        qDebug() << "[CelTilesCommand _apply] Cel" << _cel->name() << "has been resized since, skipping";
+        return;
+    }
+
+    QByteArray raw = qUncompress(_tiles());
+    if (raw.isEmpty())
+        return;
+
+    // Paint right on the Cel if it's loaded, else go through a copy
+    QImage copy;
+    QImage *img = _cel->imageData();
+    if (!img) {
+        copy = _cel->image();
+        img = &copy;
+    }
+    if (img->format() != QImage::Format_ARGB32_Premultiplied)
+        *img = img->convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+    QDataStream in(raw);
+    QRect damaged;
+    for (int i = 0; i < _numTiles; i++) {
+        QRect tile;
+        in >> tile;
+        int rowBytes = tile.width() * 4;
+
+        // Skip over the before tiles if we want the after ones
+        if (after)
+            in.skipRawData(rowBytes * tile.height());
+
+        for (int y = tile.top(); y <= tile.bottom(); y++)
+            in.readRawData((char *)img->scanLine(y) + (tile.left() * 4), rowBytes);
+
+        if (!after)
+            in.skipRawData(rowBytes * tile.height());
+
+        damaged |= tile;
+    }
+
+    if (copy.isNull())
+        _cel->damage(damaged);
+    else
+        _cel->setImage(copy);
+}
+
+
+/*!
+    Internal function.  Returns the compressed tiles, reading them from the disk if they were
+    spilled.
+*/
+QByteArray CelTilesCommand::_tiles() {
+    if (spilled())
+        return _history->unspill(_spillOffset, _spillSize);
+    else
+        return _data;
+}
+
+
+
+/*!
+    \class TimingCommand
+    \brief TimingCommand is one step of UndoHistory, a range of an XSheet that was retimed.
+
+    The range starts at \a index of \a plane in \a xsheet, and has the TimedFrames in \a before.
+    They're swapped out for the ones in \a after (which are new, and not in an XSheet) with
+    XSheet::replaceFrames(), so going either way is one pass, and one round of signals.  The
+    command owns whichever list isn't in the XSheet.
+
+    Unlike CelTilesCommand, the change isn't made yet when this is pushed, the first redo()
+    does it.
+*/
+TimingCommand::TimingCommand(XSheet *xsheet, int plane, int index, QList<TimedFrame *> before, QList<TimedFrame *> after, QString text) :
+    QUndoCommand(text),
+    _xsheet(xsheet),
+    _plane(plane),
+    _index(index)
+{
+    for (auto iter = before.begin(); iter != before.end(); iter++)
+        _before.append(*iter);
+    for (auto iter = after.begin(); iter != after.end(); iter++)
+        _after.append(*iter);
+}
+
+
+/*!
+    Deletes the TimedFrames that aren't in the XSheet.
+*/
+TimingCommand::~TimingCommand() {
+    QList<QPointer<TimedFrame>> &spare = _applied ? _before : _after;
+    for (auto iter = spare.begin(); iter != spare.end(); iter++) {
+        if (*iter && ((*iter)->index() < 0))
+            delete iter->data();
+    }
+}
+
+
+/*!
+    Puts the TimedFrames from before the retiming back.
+*/
+void TimingCommand::undo() {
+    if (_applied && _swap(_after, _before))
+        _applied = false;
+}
+
+
+/*!
+    Puts the retimed TimedFrames in.
+*/
+void TimingCommand::redo() {
+    if (!_applied && _swap(_before, _after))
+        _applied = true;
+}
+
+
+/*!
+    Internal function.  Replaces \a out with \a in, if \a out is still where it was in the
+    XSheet (other edits to the timeline aren't undoable, so it might not be).  Returns false
+    if nothing was done.  The Animation is saved afterwards.
+*/
+bool TimingCommand::_swap(const QList<QPointer<TimedFrame>> &out, const QList<QPointer<TimedFrame>> &in) {
+    if (!_xsheet)
+        return false;
+
+    for (int i = 0; i < out.size(); i++) {
+        if (!out.at(i) || (_xsheet->frameAt(_index + i, _plane) != out.at(i))) {
+            qDebug() << "[TimingCommand _swap] The timeline has changed since, skipping" << text();
+            return false;
+        }
+    }
+
+    QList<TimedFrame *> frames;
+    for (auto iter = in.begin(); iter != in.end(); iter++) {
+        if (!(*iter) || !(*iter)->hasFrame()) {
+            qDebug() << "[TimingCommand _swap] A frame has been deleted since, skipping" << text();
+            return false;
+        }
+
+        frames.append(*iter);
+    }
+
+    // Saved once everything is in
+    _xsheet->beginChanges();
+    _xsheet->replaceFrames(_index, out.size(), frames, _plane);
+    BlitApp::app()->saveAnim();
+    _xsheet->commitChanges();
+
+    return true;
+}
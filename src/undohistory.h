@@ -0,0 +1,140 @@
+// File:         undohistory.h
+// Author:       Ben Summerton (define-private-public)
+// Description:  UndoHistory keeps track of edits to Cels (as tiles) so they can be undone and
+//               redone.  Built on top of Qt's Undo Framework.  Retiming a range of the XSheet is
+//               undoable too (TimingCommand).
+
+
+#ifndef UNDO_HISTORY_H
+#define UNDO_HISTORY_H
+
+
+#define UNDO_TILE_SIZE 64                                    // Width & height of the tiles that are saved
+#define UNDO_DEFAULT_MEMORY_LIMIT (64 * 1024 * 1024)        // Bytes of (compressed) tiles to keep in memory
+#define UNDO_DEFAULT_STEP_LIMIT 500                            // How many steps of undo to keep
+
+
+#include <QObject>
+#include <QUndoCommand>
+#include <QPointer>
+#include <QImage>
+#include <QRect>
+#include <QByteArray>
+#include <QList>
+#include <QString>
+class PNGCel;
+class XSheet;
+class TimedFrame;
+class QUndoStack;
+class QTemporaryFile;
+
+
+class UndoHistory : public QObject {
+    Q_OBJECT;
+
+public:
+    UndoHistory(QObject *parent=NULL);
+    ~UndoHistory();
+
+    QUndoStack *stack();
+
+    // Memory
+    qint64 memoryLimit();
+    void setMemoryLimit(qint64 bytes);
+    qint64 memoryUsage();
+
+    // Cel edits
+    void beginCelEdit(PNGCel *cel);
+    bool editing();
+
+    // Spill file, used by the commands
+    qint64 spill(const QByteArray &data);
+    QByteArray unspill(qint64 offset, qint64 size);
+
+
+public slots:
+    void endCelEdit();
+    void undo();
+    void redo();
+    void clear();
+
+
+private slots:
+    void _onCelDamaged(QRect rect);
+
+
+private:
+    void _enforceMemoryLimit();
+
+    QUndoStack *_stack = NULL;                    // Where the steps live
+    qint64 _memoryLimit = UNDO_DEFAULT_MEMORY_LIMIT;
+    QTemporaryFile *_spillFile = NULL;            // Old steps get moved out to here (made on demand)
+
+    // Current Cel edit
+    QPointer<PNGCel> _editCel;                    // Cel being edited, NULL if none
+    QImage _editBefore;                            // Image of the Cel before the edit (shallow copy)
+    QRect _editRect;                            // Area that the edit has damaged so far
+
+};
+
+
+// A single edit to a Cel, only the tiles that changed are saved (before & after, compressed)
+class CelTilesCommand : public QUndoCommand {
+
+public:
+    CelTilesCommand(UndoHistory *history, PNGCel *cel, const QImage &before, const QImage &after, QRect rect);
+    ~CelTilesCommand();
+
+    // Info
+    bool isEmpty();
+    qint64 memoryUsage();
+    bool spilled();
+    void spill();
+
+    // QUndoCommand
+    void undo();
+    void redo();
+
+
+private:
+    void _apply(bool after);
+    QByteArray _tiles();
+
+    UndoHistory *_history;
+    QPointer<PNGCel> _cel;
+    QSize _celSize;                    // Size of the Cel when the edit was made
+    QByteArray _data;                // Compressed tiles, empty if spilled
+    qint64 _spillOffset = -1;        // Where in the spill file the tiles are
+    qint64 _spillSize = 0;
+    int _numTiles = 0;
+    bool _firstRedo = true;            // Edit was already done when this was pushed
+
+};
+
+
+// Retiming of a range of TimedFrames in an XSheet plane, the frames are swapped for new ones
+class TimingCommand : public QUndoCommand {
+
+public:
+    TimingCommand(XSheet *xsheet, int plane, int index, QList<TimedFrame *> before, QList<TimedFrame *> after, QString text);
+    ~TimingCommand();
+
+    // QUndoCommand
+    void undo();
+    void redo();
+
+
+private:
+    bool _swap(const QList<QPointer<TimedFrame>> &out, const QList<QPointer<TimedFrame>> &in);
+
+    QPointer<XSheet> _xsheet;
+    int _plane;
+    int _index;                                    // Where the range starts in the plane
+    QList<QPointer<TimedFrame>> _before;        // What was in the range
+    QList<QPointer<TimedFrame>> _after;            // What it's replaced with
+    bool _applied = false;                        // _after is in the XSheet
+
+};
+
+
+#endif // UNDO_HISTORY_H
@@ -9,6 +9,9 @@
 #include <QPointF>
 #include <QColor>
 #include <QImage>
+#include <QRectF>
+#include <QPainter>
+#include <QtMath>
 #include <QDebug>
 
 /*!
@@ -94,6 +97,130 @@ QString util::sizeToStr(QSize size) {
 }
 
 
+/*!
+    Returns a copy of \a src that is half the width and height (but never
+    smaller than 1x1).  Each pixel is the average of the 2x2 block it covers
+    (a box filter).  The returned image is in the format of
+    ARGB_32_Premultiplied, so averaging the channels directly is correct.
+*/
+QImage util::halfScale(const QImage &src) {
+    QImage img = src.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    int sw = img.width(), sh = img.height();
+    int w = qMax(1, sw / 2), h = qMax(1, sh / 2);
+    QImage half(w, h, QImage::Format_ARGB32_Premultiplied);
+
+    for (int y = 0; y < h; y++) {
+        // Clamp for sources that are only one pixel tall
+        const QRgb *row0 = (const QRgb *)img.constScanLine(qMin(2 * y, sh - 1));
+        const QRgb *row1 = (const QRgb *)img.constScanLine(qMin((2 * y) + 1, sh - 1));
+        QRgb *dest = (QRgb *)half.scanLine(y);
+
+        for (int x = 0; x < w; x++) {
+            int x0 = qMin(2 * x, sw - 1);
+            int x1 = qMin((2 * x) + 1, sw - 1);
+            QRgb a = row0[x0], b = row0[x1], c = row1[x0], d = row1[x1];
+
+            // Average two channels at a time, (sum of four bytes fits in the 16 bit gap)
+            quint32 rb = (((a & 0x00FF00FF) + (b & 0x00FF00FF) + (c & 0x00FF00FF) + (d & 0x00FF00FF) + 0x00020002) >> 2) & 0x00FF00FF;
+            quint32 ag = ((((a >> 8) & 0x00FF00FF) + ((b >> 8) & 0x00FF00FF) + ((c >> 8) & 0x00FF00FF) + ((d >> 8) & 0x00FF00FF) + 0x00020002) >> 2) & 0x00FF00FF;
+            dest[x] = rb | (ag << 8);
+        }
+    }
+
+    return half;
+}
+
+
+/*!
+    Returns mip level \a level of \a base, where level 0 is \a base itself and
+    each next level is half the size of the previous one.  \a levels is a cache
+    of the already generated levels (index 0 holds level 1); missing levels are
+    generated lazily with halfScale() and stored there.  Clear \a levels when
+    \a base changes.
+
+    If \a level goes past the 1x1 level, the smallest level is returned.
+*/
+QImage util::mipLevel(const QImage &base, QList<QImage> &levels, int level) {
+    if ((level <= 0) || base.isNull())
+        return base;
+
+    // Generate what we don't have yet
+    while (levels.size() < level) {
+        const QImage &prev = levels.isEmpty() ? base : levels.last();
+        if ((prev.width() == 1) && (prev.height() == 1))
+            break;
+
+        levels.append(util::halfScale(prev));
+    }
+
+    if (levels.isEmpty())
+        return base;
+    else
+        return levels[qMin(level, levels.size()) - 1];
+}
+
+
+/*!
+    Draws \a base onto \a painter at (0, 0), but only the part of it that is
+    covered by \a exposed (in the same coordinates as \a base).  A null \a exposed
+    means draw everything.  If the painter is scaled down, a smaller mip level
+    from \a levels is used instead (see mipLevel()).
+
+    This is meant for QGraphicsItem::paint() implementations, where \a exposed
+    is QStyleOptionGraphicsItem::exposedRect.
+*/
+void util::drawImageMipmapped(QPainter *painter, const QImage &base, QList<QImage> &levels, const QRectF &exposed) {
+    if (base.isNull())
+        return;
+
+    // Figure out what part of the image is needed
+    QRect full(QPoint(0, 0), base.size());
+    QRect src = exposed.isNull() ? full : (exposed.toAlignedRect() & full);
+    if (src.isEmpty())
+        return;
+
+    // Full size, straight copy of the sub rect
+    int level = math::mipLevelForScale(painter->worldTransform().m11());
+    if (level == 0) {
+        painter->drawImage(src.topLeft(), base, src);
+        return;
+    }
+
+    // Map the sub rect into the mip level, then back out again for the target
+    QImage mip = util::mipLevel(base, levels, level);
+    qreal fx = (qreal)mip.width() / base.width();
+    qreal fy = (qreal)mip.height() / base.height();
+    QRect mipSrc = QRectF(src.x() * fx, src.y() * fy, src.width() * fx, src.height() * fy).toAlignedRect();
+    mipSrc &= QRect(QPoint(0, 0), mip.size());
+
+    QRectF target(mipSrc.x() / fx, mipSrc.y() / fy, mipSrc.width() / fx, mipSrc.height() / fy);
+    painter->drawImage(target, mip, mipSrc);
+}
+
+
+/*!
+    Mixes \a count pixels of \a src into \a dest, using \a weights as how much of \a dest to
+    keep (255 keeps all of \a dest, 0 replaces it with \a src).  There isn't any branching per
+    pixel, so this is cheap enough to run over whole rows of a Cel (e.g. to keep an edit inside
+    of a selection mask).
+*/
+void util::blendRow(QRgb *dest, const QRgb *src, const uchar *weights, int count) {
+    for (int i = 0; i < count; i++) {
+        quint32 w = weights[i];
+        quint32 iw = 255 - w;
+        quint32 d = dest[i], s = src[i];
+
+        // Two channels at a time, (255 * 255 fits in the 16 bit gap)
+        quint32 rb = ((d & 0x00FF00FF) * w) + ((s & 0x00FF00FF) * iw);
+        rb = (rb + ((rb >> 8) & 0x00FF00FF) + 0x00800080) >> 8;
+        quint32 ag = (((d >> 8) & 0x00FF00FF) * w) + (((s >> 8) & 0x00FF00FF) * iw);
+        ag = (ag + ((ag >> 8) & 0x00FF00FF) + 0x00800080) & 0xFF00FF00;
+
+        dest[i] = (rb & 0x00FF00FF) | ag;
+    }
+}
+
+
 /*!
     Uses Bresenham's line algorithm, this will return a list of (integer) points
     that are used to construct the line between the two points.  Implementation based
@@ -154,3 +281,17 @@ QList<QPoint> math::bresenhamLinePoints(QPointF a, QPointF b) {
 }
 
 
+/*!
+    Picks a mip level for an image that is being drawn at \a scale (e.g. the
+    m11() of a painter's world transform).  At 1:1 or larger this is always 0
+    (the full sized image).  Below that it's the level that is closest to, but
+    not smaller than, the size it will be drawn at.
+
+    \sa util::mipLevel()
+*/
+int math::mipLevelForScale(qreal scale) {
+    if ((scale >= 1.0) || (scale <= 0.0))
+        return 0;
+
+    return qFloor(std::log2(1.0 / scale));
+}
@@ -13,7 +13,10 @@ class QColor;
 class QPoint;
 class QPointF;
 class QUuid;
+class QRectF;
+class QPainter;
 #include <QList>
+#include <QRgb>
 
 
 namespace util {
@@ -22,6 +25,26 @@ namespace util {
     QImage mkBlankImage(QSize size);
     QColor invert(QColor clr);
     QString sizeToStr(QSize size);
+    QImage halfScale(const QImage &src);
+    QImage mipLevel(const QImage &base, QList<QImage> &levels, int level);
+    void drawImageMipmapped(QPainter *painter, const QImage &base, QList<QImage> &levels, const QRectF &exposed);
+    void blendRow(QRgb *dest, const QRgb *src, const uchar *weights, int count);
+
+    // Blends src over dst (both premultiplied), same as QPainter's default SourceOver
+    // composition.  Inline since it's used per pixel by the fill and rasterizers.
+    inline QRgb blendOver(QRgb src, QRgb dst) {
+        uint inv = 255 - qAlpha(src);
+        if (inv == 0)
+            return src;
+
+        // Two channels at a time, (x * inv + 128) * 257 >> 16 is x * inv / 255 rounded
+        quint32 rb = (dst & 0x00FF00FF) * inv + 0x00800080;
+        rb = ((rb + ((rb >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+        quint32 ag = ((dst >> 8) & 0x00FF00FF) * inv + 0x00800080;
+        ag = (ag + ((ag >> 8) & 0x00FF00FF)) & 0xFF00FF00;
+
+        return src + (rb | ag);
+    }
 };
 
 
@@ -29,6 +52,7 @@ namespace util {
 namespace math {
     QList<QPoint> bresenhamLinePoints(qreal aX, qreal aY, qreal bX, qreal bY);
     QList<QPoint> bresenhamLinePoints(QPointF a, QPointF b);
+    int mipLevelForScale(qreal scale);
 };
 
 #endif // UTIL_H
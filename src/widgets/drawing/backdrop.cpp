@@ -9,8 +9,12 @@
     \brief Backdrop is a QGraphicObject that appears behind Frame in the Canvas widget.
 
     It is simply nothing more than presentation.  It allows you to change the color of
-    itself.  It does not (currently) affect how things will be rendered;  it is currently
-    a visual aid.  Backdrops should only be used inside Canvas Widgets.
+    itself, or to show a transparency checkerboard or a (tiled) image instead (see
+    Backdrop::Style).  It does not (currently) affect how things will be rendered;  it is
+    currently a visual aid.  Backdrops should only be used inside Canvas Widgets.
+
+    The checkerboard is made from a single pre-rendered tile, and image backdrops are
+    kept as a QPixmap, so painting the backdrop is always one textured fill.
 */
 
 
@@ -19,6 +23,7 @@
 #include "widgets/drawing/canvas.h"
 #include <QtMath>
 #include <QPainter>
+#include <QPolygonF>
 #include <QDebug>
 
 
@@ -59,50 +64,30 @@ void Backdrop::paint(QPainter *painter, const QStyleOptionGraphicsItem *option,
     qreal invZoom = 1.0 / _zoom;        // Zoom inverse
     if (invZoom > 1.0)
         invZoom = 1.0;
+    QRectF area(boundingRect());
 
     // Main area
-    if (_clr.alpha() != 0xFF) {
-        // Got some alpha, make the boxes
-
-        qreal boxSize = _boxSize / _zoom;
-        qreal diagLength = qSqrt(qPow(boxSize, 2) + qPow(boxSize, 2));
-        qreal boxesPerColumn = _size.height() / diagLength;
-
-        // Create the (rotated) boxes
-        QVector<QRectF> boxes;
-        qreal x = 0, y = 0;
-        qreal travWidth = 0, travHeight = 0;
-        while (travHeight < (_size.height() + diagLength)) {
-            x = 0;
-            travWidth = 0;
-            while (travWidth < (_size.width() + diagLength)) {
-                 QRectF rect(x + y, y - x, boxSize, boxSize);
-                 boxes.append(rect);
-
-                 x += boxSize;
-                 travWidth += diagLength;
-            }
-
-            y += boxSize;
-            travHeight += diagLength;
-        }
-
-        // Draw background
-        painter->setPen(Qt::NoPen);
-        painter->fillRect(0, 0, _size.width(), _size.height(), Qt::white);
-
-        // Draw little grey boxes
-        painter->save();
-        painter->setClipping(true);
-        painter->setClipRegion(QRegion(0, 0, _size.width(), _size.height()));
-        painter->setBrush(QColor(0xE0, 0xE0, 0xE0));
-        painter->translate(-(travWidth - _size.width()) / 2, -(travHeight - _size.height()) / 2);        // Center the boxes
-        painter->rotate(45);
-        painter->drawRects(boxes);
-        painter->restore();
-
+    painter->setPen(Qt::NoPen);
+    switch (_style) {
+        case CheckerboardStyle:
+            _fillCheckerboard(painter, area);
+            break;
+
+        case ImageStyle:
+            if (_image.isNull())
+                _fillCheckerboard(painter, area);
+            else
+                painter->fillRect(area, QBrush(_image));        // Image pixels line up with Frame pixels
+            break;
+
+        case ColorStyle:
+        default:
+            // Got some alpha, show the boxes
+            if (_clr.alpha() != 0xFF)
+                _fillCheckerboard(painter, area);
+            painter->fillRect(area, _clr);        // Always give it the overlay
+            break;
     }
-    painter->fillRect(0, 0, _size.width(), _size.height(), _clr);        // Always give it the overlay
 
     // Outline
     QPointF tl(-invZoom, -invZoom);
@@ -129,6 +114,22 @@ QColor Backdrop::color() {
 }
 
 
+/*!
+    Returns how the backdrop is currently being drawn.
+*/
+Backdrop::Style Backdrop::style() {
+    return _style;
+}
+
+
+/*!
+    Returns the image used for ImageStyle.  May be a null pixmap.
+*/
+QPixmap Backdrop::image() {
+    return _image;
+}
+
+
 /*!
     Sets the size of the backdrop to \a size, only if it isn't the exact same
     already.
@@ -160,6 +161,29 @@ void Backdrop::setColor(QColor clr) {
 }
 
 
+/*!
+    Sets how the backdrop will be drawn to \a style.  Will cause the item to update
+    if it's different.
+*/
+void Backdrop::setStyle(Style style) {
+    if (_style != style) {
+        _style = style;
+        update();
+    }
+}
+
+
+/*!
+    Sets the \a image that is tiled over the backdrop when the style is ImageStyle.
+    One pixel of the image covers one pixel of the Frame.  Will cause the item to
+    update.
+*/
+void Backdrop::setImage(QPixmap image) {
+    _image = image;
+    update();
+}
+
+
 /*!
     Triggered via the Canvas::zoomChanged() signal, this will tell the Backdrop
     to redraw if the zoom is not the same
@@ -171,3 +195,45 @@ void Backdrop::_onCanvasZoomChanged(qreal zoom) {
     }
 }
 
+
+/*!
+    Internal function.  Fills \a area (in item coordinates) with the transparency
+    checkerboard.  The checkerboard always has the same size on screen no matter
+    what the zoom is, so the fill is done in device coordinates with the cached tile.
+*/
+void Backdrop::_fillCheckerboard(QPainter *painter, const QRectF &area) {
+    if (_checkerTile.isNull())
+        _mkCheckerTile();
+
+    // Map the area onto the screen, and line the tile up with its corner
+    QRect devArea = painter->worldTransform().mapRect(area).toAlignedRect();
+
+    painter->save();
+    painter->resetTransform();
+    painter->setBrushOrigin(devArea.topLeft());
+    painter->fillRect(devArea, QBrush(_checkerTile));
+    painter->restore();
+}
+
+
+/*!
+    Internal function.  Renders one repeat of the checkerboard into _checkerTile.
+    The boxes are _boxSize pixels wide and rotated by 45 degrees, which makes for
+    a tile that is a single grey diamond on a white background.
+*/
+void Backdrop::_mkCheckerTile() {
+    int d = qMax(2, qRound(_boxSize * M_SQRT2));        // Diagonal of a box
+    qreal h = d / 2.0;
+
+    _checkerTile = QPixmap(d, d);
+    _checkerTile.fill(Qt::white);
+
+    QPolygonF diamond;
+    diamond << QPointF(h, 0) << QPointF(d, h) << QPointF(h, d) << QPointF(0, h);
+
+    QPainter p(&_checkerTile);
+    p.setPen(Qt::NoPen);
+    p.setBrush(QColor(0xE0, 0xE0, 0xE0));
+    p.drawPolygon(diamond);
+    p.end();
+}
@@ -8,6 +8,7 @@
 
 
 #include <QGraphicsObject>
+#include <QPixmap>
 class Canvas;
 
 
@@ -15,6 +16,12 @@ class Backdrop : public QGraphicsObject {
     Q_OBJECT;
 
 public:
+    enum Style {
+        ColorStyle,            // Solid color, checkerboard shows through if it has alpha
+        CheckerboardStyle,    // Transparency checkerboard only
+        ImageStyle            // Tiled image (falls back to the checkerboard if there isn't one)
+    };
+
     Backdrop(Canvas *canvas, QGraphicsItem *parent=NULL);
     ~Backdrop();
 
@@ -24,11 +31,15 @@ public:
 
     // Info
     QColor color();
+    Style style();
+    QPixmap image();
 
 
 public slots:
     void setSize(QSize size);
     void setColor(QColor clr);
+    void setStyle(Style style);
+    void setImage(QPixmap image);
 
 
 private slots:
@@ -36,7 +47,13 @@ private slots:
 
 
 private:
+    void _fillCheckerboard(QPainter *painter, const QRectF &area);
+    void _mkCheckerTile();
+
+    Style _style = ColorStyle;    // How the backdrop is drawn
     QColor _clr;            // Color of the backdrop
+    QPixmap _image;            // Image for ImageStyle, tiled over the backdrop
+    QPixmap _checkerTile;    // One repeat of the checkerboard, in screen pixels (made on demand)
     QSize _size;            // Size of the backdrop (in pixels)
     qreal _zoom = 1;        // Zoom of the canvas
     qreal _boxSize = 16;    // Size of the boxes;
@@ -13,7 +13,13 @@
 #include "animation/frame.h"
 #include "animation/frameitem.h"
 #include "animation/timedframe.h"
+#include "animation/xsheet.h"
 #include "widgets/drawing/backdrop.h"
+#include "widgets/drawing/compositeitem.h"
+#include "widgets/drawing/selectionitem.h"
+#include "widgets/drawing/overlayitem.h"
+#include "widgets/drawing/planeitem.h"
+#include "widgets/drawing/playbackitem.h"
 #include <QtCore/qmath.h>
 #include <QTransform>
 #include <QPoint>
@@ -22,11 +28,15 @@
 #include <QSizeF>
 #include <QRect>
 #include <QRectF>
+#include <QLineF>
+#include <QVector>
 #include <QPainter>
+#include <algorithm>
 #include <QEvent>
 #include <QGraphicsScene>
-#include <QGraphicsLineItem>
 #include <QGraphicsSceneMouseEvent>
+#include <QImage>
+#include <QPixmap>
 #include <QDebug>
 
 
@@ -37,6 +47,7 @@ Canvas::Canvas(QWidget *parent) :
     setAlignment(Qt::AlignCenter);
     setFrameShape(QFrame::NoFrame);
     setMouseTracking(true);
+    setCacheMode(QGraphicsView::CacheBackground);        // It's a plain fill, no need to redo it every time
 
     // Create the scene
     _scene = new CanvasScene(this);
@@ -51,6 +62,23 @@ Canvas::Canvas(QWidget *parent) :
     _backdrop->setColor(Qt::white);
     _scene->addItem(_backdrop);
 
+    // Only shown in raster mode
+    _compositeItem = new CompositeItem();
+    _compositeItem->setZValue(CANVAS_LIGHT_TABLE_BEFORE_Z_START);
+    _compositeItem->setVisible(false);
+    _scene->addItem(_compositeItem);
+
+    // Only shown during playback
+    _playbackItem = new PlaybackItem();
+    _playbackItem->setZValue(CANVAS_FRAME_Z_START);
+    _playbackItem->setVisible(false);
+    _scene->addItem(_playbackItem);
+
+    // Tool previews, under the selection
+    _overlayItem = new OverlayItem();
+    _overlayItem->setZValue(CANVAS_FOREGROUND_Z_START);
+    _scene->addItem(_overlayItem);
+
 //    _lightTableNumBefore = 2;        // How many to get before the current frame
 //    _lightTableNumAfter = 2;        // How many to get after the current frame
 //    _lightTableFadeStep = 3;
@@ -122,12 +150,18 @@ void Canvas::showGrid(bool showIt) {
     // Toggles the grid overlay on and off.  true for On, false for Off.
     _showGrid = showIt;
 
-    // Adjust visibily for the items
-    for (auto iter = _gridItems.begin(); iter != _gridItems.end(); iter++)
-        (*iter)->setVisible(_showGrid && (_zoom >= _minZoomForGrid));
+    // The grid is drawn in drawForeground(), so only that layer needs a repaint
+    _scene->invalidate(sceneRect(), QGraphicsScene::ForegroundLayer);
+}
+
 
-    // For update the scene's rectangle
-    _scene->invalidate();
+/*!
+    Returns true if the Canvas is in raster mode.
+
+    \sa setRasterMode()
+*/
+bool Canvas::rasterMode() {
+    return _rasterMode;
 }
 
 
@@ -155,53 +189,12 @@ void Canvas::onFrameSizeChanged(QSize size) {
     // Adjust the Secene rect
     setSceneRect(QRectF(QPointF(0, 0), size));
 
-    // Recrete the grid, regardless if it's being shown or not. (or min zoom)
-    // First remove all of the lines
-    for (auto iter = _gridItems.begin(); iter != _gridItems.end(); iter++) {
-        _scene->removeItem(*iter);
-        delete *iter;
-    }
-    _gridItems.clear();
-
-    // Add new grid lines
-    QRectF visible = getVisibleRect();
-    int vx = qFloor(visible.x());
-    int vy = qFloor(visible.y());
-    int vw = qCeil(visible.width());
-    int vh = qCeil(visible.height());
-    qreal invZoom = 1.0 /  _zoom;        // mulplicative inverse
-    if (invZoom > 1.0)
-        invZoom = _zoom;
-    Qt::PenStyle style = (_zoom < 12) ? Qt::SolidLine : Qt::DotLine;
-    QPen pen(QPen(Qt::lightGray, invZoom, style, Qt::SquareCap, Qt::MiterJoin));
-
-    // Vertical lines
-    for (int x = vx; x < vw; x++) {
-        // Make the line
-        QGraphicsLineItem *line = new QGraphicsLineItem(x, vy, x, vh + invZoom);
-        line->setPen(pen);
-        line->setVisible(_showGrid && (_zoom >= _minZoomForGrid));
-        line->setZValue(CANVAS_FOREGROUND_Z_START);
-
-        // Add to things
-        _scene->addItem(line);
-        _gridItems.append(line);
-    }
-
-    // Horizontal lines
-    for (int y = vy; y < vh; y++) {
-        QGraphicsLineItem *line = new QGraphicsLineItem(vx, y, vw + invZoom, y);
-        line->setPen(pen);
-        line->setVisible(_showGrid && (_zoom >= _minZoomForGrid));
-        line->setZValue(CANVAS_FOREGROUND_Z_START);
-
-        // Add to things
-        _scene->addItem(line);
-        _gridItems.append(line);
-    }
-
     // update the backdrop
     _backdrop->setSize(size);
+    _compositeItem->setSize(size);
+    _playbackItem->setSize(size);
+    for (auto iter = _planeItems.begin(); iter != _planeItems.end(); iter++)
+        (*iter)->setSize(size);
 
     // Debug Info
     qDebug() << "[Canvas onFrameSizeChanged] size=" << size;
@@ -210,6 +203,12 @@ void Canvas::onFrameSizeChanged(QSize size) {
 
 void Canvas::onZoomChanged(double zoom) {
     // Slots called by the BlitApps's signal zoomChanged.
+    _requestedZoom = zoom;
+
+    // Raster mode only blits at whole number zooms (when zoomed in)
+    if (_rasterMode && (zoom > 1))
+        zoom = qRound(zoom);
+
     _zoom = zoom;
     emit zoomChanged(_zoom);
 
@@ -217,17 +216,6 @@ void Canvas::onZoomChanged(double zoom) {
     setTransform(QTransform());
     scale(zoom, zoom);
 
-    // Adjust the grid lines
-    qreal invZoom = 1.0 /  _zoom;        // mulplicative inverse
-    if (invZoom > 1.0)
-        invZoom = _zoom;
-    Qt::PenStyle style = (_zoom < 12) ? Qt::SolidLine : Qt::DotLine;
-    QPen pen(QPen(Qt::lightGray, invZoom, style, Qt::SquareCap, Qt::MiterJoin));
-    for (auto iter = _gridItems.begin(); iter != _gridItems.end(); iter++) {
-        (*iter)->setPen(pen);
-        (*iter)->setVisible(_showGrid && (_zoom >= _minZoomForGrid));
-    }
-
     // Request a redraw
     update();
 }
@@ -275,37 +263,309 @@ void Canvas::setFrame(TimedFrame *tf) {
                 crIter++;
             }
 
-            // Add in the light table
-            // Out with the old, and in with the new
-            _removeLightTableItems();
-            _createLightTableItems();
-
             // Set the var (and signals & slots)
             _frame = frame;
             connect(_frame, &Frame::destroyed, this, &Canvas::_onFrameDestroyed);
             connect(_frame, &Frame::celAdded, this, &Canvas::_onCelAdded);
             connect(_frame, &Frame::celRemoved, this, &Canvas::_onCelRemoved);
             connect(_frame, &Frame::celMoved, this, &Canvas::_onCelMoved);
+
+            // Add in the light table (after _frame is set, raster mode needs it)
+            // Out with the old, and in with the new
+            _removeLightTableItems();
+            _createLightTableItems();
         }
 
+        // Might have switched planes
+        _stackPlaneItems();
+
         // Info
         qDebug() << "[Canvas setFrame] frame=" << _frame << " timedframe=" << tf;
     }
 }
 
 
+/*!
+    Shows the other planes of \a xsheet above and below the current Frame.  Each one gets a
+    PlaneItem, which keeps its own cached renders.  The current TimedFrame's plane is left to
+    the CelRefItems (or the CompositeItem).  Passing NULL removes them all.
+*/
+void Canvas::setXSheet(XSheet *xsheet) {
+    // Out with the old
+    if (_xsheet)
+        disconnect(_xsheet, 0, this, 0);
+    for (auto iter = _planeItems.begin(); iter != _planeItems.end(); iter++) {
+        _scene->removeItem(*iter);
+        delete *iter;
+    }
+    _planeItems.clear();
+
+    // In with the new
+    _xsheet = xsheet;
+    if (_xsheet) {
+        for (int i = 0; i < _xsheet->numPlanes(); i++)
+            _onPlaneAdded(i);
+        connect(_xsheet, &XSheet::planeAdded, this, &Canvas::_onPlaneAdded);
+    }
+
+    qDebug() << "[Canvas setXSheet] xsheet=" << xsheet;
+}
+
+
+/*!
+    Triggered via BlitApp::curSeqNumChanged().  Has the other planes show what they have at
+    \a seqNum.  Only the PlaneItems whose Frame is different will redraw.  During playback
+    they're left alone until it stops.
+*/
+void Canvas::setSeqNum(quint32 seqNum) {
+    _seqNum = seqNum;
+    if (_playingBack)
+        return;
+
+    for (auto iter = _planeItems.begin(); iter != _planeItems.end(); iter++)
+        (*iter)->setSeqNum(_seqNum);
+}
+
+
+/*!
+    Triggered via BlitApp::animationPlaybackStateChanged().  While \a playing, the current
+    Frame isn't changed on each tick of playback (that would rebuild the CelRefItems, light
+    table, etc. every time).  Instead, everything is hidden but the PlaybackItem, which
+    shows what the PlaybackEngine renders ahead (see setPlaybackImage()).  When playback
+    stops, the planes catch up to the last sequence number.
+*/
+void Canvas::setPlayingBack(bool playing) {
+    if (_playingBack == playing)
+        return;
+
+    _playingBack = playing;
+
+    // Swap the items for the current Frame with its plane's PlaneItem
+    for (auto iter = _frameItems.begin(); iter != _frameItems.end(); iter++)
+        (*iter)->setVisible(!_playingBack);
+    for (auto iter = _lightTableItems.begin(); iter != _lightTableItems.end(); iter++)
+        (*iter)->setVisible(!_playingBack);
+    _compositeItem->setVisible(_rasterMode && !_playingBack);
+    _playbackItem->setVisible(_playingBack);
+    _stackPlaneItems();
+
+    if (!_playingBack) {
+        _playbackItem->setImage(QImage());
+        setSeqNum(_seqNum);
+    }
+
+    qDebug() << "[Canvas setPlayingBack] playing=" << _playingBack;
+}
+
+
+/*!
+    Triggered via PlaybackEngine::frameReady().  Shows \a image while playing back.
+*/
+void Canvas::setPlaybackImage(QImage image) {
+    _playbackItem->setImage(image);
+}
+
+
 void Canvas::onCurCelRefChanged(CelRef *cel) {
     // Tripped when the current Cel is changed.  Will cause the widget to redraw the view & scene
+    if (_selectionItem)
+        _selectionItem->setCelRef(cel);
+
+    // Anything being previewed was for the old Cel
+    _overlayItem->clear();
+    if (cel)
+        _overlayItem->setPos(cel->pos());
+
     if (_frame)
         _scene->invalidate();
 }
 
 
 /*!
-    Changes the color of the backdrop to \a clr
+    Returns the color of the current Frame at \a scenePos, as it's composited (without the
+    backdrop) with the other planes above and below it.  If \a withLightTable is true, the
+    light table frames are mixed in the same way that they're shown.  The view itself isn't
+    looked at, so zooming and anything drawn ontop of the Frame don't change the result.
+
+    The pixel is taken from what the items have already rendered (the CompositeItem, the
+    PlaneItems and the light table's FrameItems) when that's still good.  Only when it isn't
+    is that one pixel of the Frame rendered.
+
+    Returns an invalid color if there isn't anything there.
+*/
+QColor Canvas::sampleColor(QPointF scenePos, bool withLightTable) {
+    if (!_frame)
+        return QColor();
+
+    QPoint px(qFloor(scenePos.x()), qFloor(scenePos.y()));
+    auto renderPixel = [px](Frame *frame) {
+        return frame->render(QRect(px, QSize(1, 1))).pixel(0, 0);
+    };
+
+    // Everything that's shown (premultiplied), in z order
+    struct Layer {
+        QRgb clr;
+        qreal opacity;
+        qreal z;
+    };
+    QList<Layer> layers;
+    QRgb clr;
+
+    // The current Frame, in raster mode it's already composited with the light table
+    bool lightTableDone = false;
+    if (_rasterMode && withLightTable && _compositeItem->sample(px, &clr))
+        lightTableDone = true;
+    else if (!_rasterMode || !_compositeItem->sampleFrame(_frame, px, &clr))
+        clr = renderPixel(_frame);
+    layers.append({clr, 1.0, CANVAS_FRAME_Z_START});
+
+    if (withLightTable && !lightTableDone) {
+        for (int i = 0; i < _lightTableFrames.size(); i++) {
+            const LightTableFrame &ltf = _lightTableFrames.at(i);
+            if (!ltf.frame)
+                continue;
+
+            // Outside of raster mode, each one has a FrameItem (in the same order)
+            bool cached = false;
+            if (_rasterMode)
+                cached = _compositeItem->sampleFrame(ltf.frame, px, &clr);
+            else if (i < _lightTableItems.size())
+                cached = _lightTableItems.at(i)->sample(px, &clr);
+
+            if (!cached)
+                clr = renderPixel(ltf.frame);
+            layers.append({clr, ltf.opacity, ltf.z});
+        }
+    }
+
+    // The other planes, at the z their PlaneItems are stacked at
+    int curPlane = _tf ? _tf->plane() : 0;
+    for (auto iter = _planeItems.begin(); iter != _planeItems.end(); iter++) {
+        PlaneItem *pi = *iter;
+        if (pi->plane() == curPlane)
+            continue;
+
+        if (!pi->sample(px, &clr)) {
+            TimedFrame *tf = _xsheet ? _xsheet->frameAtSeq(_seqNum, pi->plane()) : NULL;
+            if (!tf || !tf->frame())
+                continue;
+
+            clr = renderPixel(tf->frame());
+        }
+        layers.append({clr, 1.0, pi->zValue()});
+    }
+
+    std::stable_sort(layers.begin(), layers.end(), [](const Layer &a, const Layer &b) {
+        return a.z < b.z;
+    });
+
+    QImage sample(1, 1, QImage::Format_ARGB32_Premultiplied);
+    sample.fill(Qt::transparent);
+    QImage layerPx(1, 1, QImage::Format_ARGB32_Premultiplied);
+    QPainter p(&sample);
+    for (auto iter = layers.begin(); iter != layers.end(); iter++) {
+        layerPx.setPixel(0, 0, iter->clr);
+        p.setOpacity(iter->opacity);
+        p.drawImage(0, 0, layerPx);
+    }
+    p.end();
+
+    // Premultiplied, undo that
+    clr = sample.pixel(0, 0);
+    if (qAlpha(clr) == 0)
+        return QColor();
+    else
+        return QColor::fromRgba(qUnpremultiply(clr));
+}
+
+
+/*!
+    Returns the item that Tools can use to show what they're drawing before it's put onto the
+    Cel.  Will never be NULL.
+*/
+OverlayItem *Canvas::overlay() {
+    return _overlayItem;
+}
+
+
+/*!
+    Shows \a selection ontop of everything else.  Should only be called once (by BlitApp).
+*/
+void Canvas::setSelection(Selection *selection) {
+    if (_selectionItem || !selection)
+        return;
+
+    _selectionItem = new SelectionItem(selection);
+    _selectionItem->setZValue(CANVAS_FOREGROUND_Z_START + 1);
+    _scene->addItem(_selectionItem);
+}
+
+
+/*!
+    Changes the color of the backdrop to \a clr, and switches it over to being
+    drawn as a color.  Does nothing if \a clr is invalid.
 */
 void Canvas::setBackdropColor(QColor clr) {
+    if (!clr.isValid())
+        return;
+
     _backdrop->setColor(clr);
+    _backdrop->setStyle(Backdrop::ColorStyle);
+}
+
+
+/*!
+    Tiles \a img behind the Frame instead of a color.  Does nothing if \a img is
+    null.
+*/
+void Canvas::setBackdropImage(QImage img) {
+    if (img.isNull())
+        return;
+
+    _backdrop->setImage(QPixmap::fromImage(img));
+    _backdrop->setStyle(Backdrop::ImageStyle);
+}
+
+
+/*!
+    Shows only the transparency checkerboard behind the Frame.
+*/
+void Canvas::setBackdropCheckerboard() {
+    _backdrop->setStyle(Backdrop::CheckerboardStyle);
+}
+
+
+/*!
+    Turns raster mode on or off with \a raster.  In raster mode the Frame (and the
+    light table) are composited into one cached buffer that is drawn with a single
+    nearest neighbor blit of the visible area, and zooms above 100% are rounded to
+    whole numbers.  The CelRefItems are kept around so that their outlines and
+    names (and the grid) are still drawn on top, and the mouse signals are the
+    same in either mode.
+
+    Will schedule a redraw of the Canvas.
+*/
+void Canvas::setRasterMode(bool raster) {
+    if (_rasterMode == raster)
+        return;
+
+    _rasterMode = raster;
+
+    // The CelRefItems only draw their overlays in raster mode
+    for (auto iter = _frameItems.begin(); iter != _frameItems.end(); iter++) {
+        (*iter)->setFlag(QGraphicsItem::ItemHasNoContents, _rasterMode);
+        (*iter)->update();
+    }
+
+    // Swap between the FrameItems and the CompositeItem
+    _compositeItem->setVisible(_rasterMode && !_playingBack);
+    _removeLightTableItems();
+    _createLightTableItems();
+
+    // Redo the zoom (rounding)
+    onZoomChanged(_requestedZoom);
+
+    qDebug() << "[Canvas setRasterMode] raster mode" << (_rasterMode ? "on" : "off");
 }
 
 
@@ -467,15 +727,8 @@ void Canvas::drawBackground(QPainter *painter, const QRectF &rect) {
     //   1. the background behind the frame
     //   2. the background behind the rest of the widget
     //
-    // The first should be a more "dynmaic," BG, while the second is something that is just a plain color
-
-    // Vars
-    QRect frameRect(QPoint(0, 0), BlitApp::app()->frameSize());
-    int fw = frameRect.width();
-    int fh = frameRect.height();
-    double invZoom = 1.0 / _zoom;        // mulplicative inverse
-    if (invZoom > 1.0)
-        invZoom = _zoom;
+    // The first should be a more "dynmaic," BG, while the second is something that is just a plain color.
+    // The first is handled by the Backdrop item, and the second is cached by the view (CacheBackground).
 
     // Draw the background for the rest of the widget
     painter->setPen(Qt::NoPen);
@@ -483,6 +736,49 @@ void Canvas::drawBackground(QPainter *painter, const QRectF &rect) {
 }
 
 
+/*!
+    Draws the pixel grid over the Frame.  Only the lines that fall within the
+    exposed \a rect are drawn, and nothing is drawn unless the grid is turned
+    on and the zoom is at least _minZoomForGrid.  Doing it here (instead of with
+    a QGraphicsLineItem per row/column) keeps the grid out of the scene.
+
+    \sa showGrid()
+*/
+void Canvas::drawForeground(QPainter *painter, const QRectF &rect) {
+    // Check if we need to draw anything at all
+    if (!_showGrid || (_zoom < _minZoomForGrid))
+        return;
+
+    // Only bother with the exposed part of the Frame
+    QRectF area = rect.intersected(sceneRect());
+    if (area.isEmpty())
+        return;
+
+    // Grid lines lay on the integer boundaries of the exposed area
+    int left = qCeil(area.left());
+    int right = qFloor(area.right());
+    int top = qCeil(area.top());
+    int bottom = qFloor(area.bottom());
+
+    QVector<QLineF> lines;
+    lines.reserve((right - left + 1) + (bottom - top + 1));
+    for (int x = left; x <= right; x++)
+        lines.append(QLineF(x, area.top(), x, area.bottom()));        // Vertical lines
+    for (int y = top; y <= bottom; y++)
+        lines.append(QLineF(area.left(), y, area.right(), y));        // Horizontal lines
+
+    // Cosmetic pen, so the lines are always one device pixel wide
+    Qt::PenStyle style = (_zoom < 12) ? Qt::SolidLine : Qt::DotLine;
+    QPen pen(Qt::lightGray, 1, style, Qt::SquareCap, Qt::MiterJoin);
+    pen.setCosmetic(true);
+
+    painter->save();
+    painter->setPen(pen);
+    painter->drawLines(lines);
+    painter->restore();
+}
+
+
 /*!
     Adds \cr to the internal Canvas Scene.
 */
@@ -491,6 +787,8 @@ void Canvas::_addCelRef(CelRef *cr) {
     CelRefItem *cri = cr->mkItem();
     cri->setCanvas(this);
     cri->setZValue(CANVAS_FRAME_Z_START + cri->zValue());        // TODO the CRI already sets it own Z value?  Should it?
+    cri->setFlag(QGraphicsItem::ItemHasNoContents, _rasterMode);        // CompositeItem draws the image data
+    cri->setVisible(!_playingBack);
     _frameItems.insert(cr, cri);
     _scene->addItem(cri);
 }
@@ -511,7 +809,8 @@ void Canvas::_removeCelRef(CelRef *cr) {
     and add the light table objects.
 
     the light table flag must be set to `true` for this function to work, else 
-    nothing will happen
+    nothing will happen.  In raster mode, the Frames are given to the CompositeItem
+    (along with the current Frame) instead of getting their own FrameItems.
 */
 void Canvas::_createLightTableItems() {
     if (_lightTableOn && _tf) {
@@ -525,12 +824,8 @@ void Canvas::_createLightTableItems() {
             // Try to grab the frame before the cursor
             TimedFrame *before = cursor->before(_lightTableLooping);
             if (before) {
-                // Got it, create a Frame Item
-                FrameItem *fi = before->frame()->mkItem();
-                fi->setOpacity(opacity);
-                fi->setZValue(CANVAS_LIGHT_TABLE_BEFORE_Z_START + z);
-                _scene->addItem(fi);
-                _lightTableItems.append(fi);
+                // Got it, show it
+                _addLightTableFrame(before->frame(), opacity, CANVAS_LIGHT_TABLE_BEFORE_Z_START + z);
 
                 // inc
                 z++;
@@ -552,12 +847,8 @@ void Canvas::_createLightTableItems() {
             // See if we can get a frame after the cursor
             TimedFrame *after = cursor->after(_lightTableLooping);
             if (after) {
-                // got it, create a Frame Item
-                FrameItem *fi = after->frame()->mkItem();
-                fi->setOpacity(opacity);
-                fi->setZValue(CANVAS_LIGHT_TABLE_AFTER_Z_START + z);
-                _scene->addItem(fi);
-                _lightTableItems.append(fi);
+                // got it, show it
+                _addLightTableFrame(after->frame(), opacity, CANVAS_LIGHT_TABLE_AFTER_Z_START + z);
     
                 // inc
                 z++;
@@ -569,11 +860,16 @@ void Canvas::_createLightTableItems() {
             }
         }
     }
+
+    // The CompositeItem draws the current Frame too
+    if (_rasterMode && _frame)
+        _compositeItem->addFrame(_frame, 1.0, CANVAS_FRAME_Z_START);
 }
 
 
 /*!
-    Internal utility function.  Will always clear out (if any) light table items.
+    Internal utility function.  Will always clear out (if any) light table items,
+    and empties out the CompositeItem.
 */
 void Canvas::_removeLightTableItems() {
     for (auto iter = _lightTableItems.begin(); iter != _lightTableItems.end(); iter++) {
@@ -581,6 +877,65 @@ void Canvas::_removeLightTableItems() {
         delete *iter;
     }
     _lightTableItems.clear();
+    _lightTableFrames.clear();
+    _compositeItem->clear();
+}
+
+
+/*!
+    Internal utility function.  Shows \a frame in the light table at \a opacity
+    and z value \a z.  Either creates a FrameItem for it, or adds it to the
+    CompositeItem if in raster mode.
+*/
+void Canvas::_addLightTableFrame(Frame *frame, qreal opacity, qreal z) {
+    _lightTableFrames.append({frame, opacity, z});
+
+    if (_rasterMode) {
+        _compositeItem->addFrame(frame, opacity, z);
+        return;
+    }
+
+    FrameItem *fi = frame->mkItem();
+    fi->setOpacity(opacity);
+    fi->setZValue(z);
+    fi->setVisible(!_playingBack);
+    _scene->addItem(fi);
+    _lightTableItems.append(fi);
+}
+
+
+/*!
+    Triggered when the XSheet gets a new \a plane.  Makes a PlaneItem for it.
+*/
+void Canvas::_onPlaneAdded(int plane) {
+    PlaneItem *pi = new PlaneItem(_xsheet, plane);
+    pi->setSize(sceneRect().size().toSize());
+    pi->setSeqNum(_seqNum);
+    _scene->addItem(pi);
+    _planeItems.append(pi);
+
+    _stackPlaneItems();
+}
+
+
+/*!
+    Internal utility function.  Puts the planes under the current one below the light table,
+    and the ones over it above the light table.  The current plane's PlaneItem is hidden,
+    since its Frame is already being shown.  All of them are hidden during playback.
+*/
+void Canvas::_stackPlaneItems() {
+    int curPlane = _tf ? _tf->plane() : 0;
+    for (auto iter = _planeItems.begin(); iter != _planeItems.end(); iter++) {
+        PlaneItem *pi = *iter;
+        int plane = pi->plane();
+        pi->setVisible(!_playingBack && (plane != curPlane));
+        if (plane == curPlane)
+            pi->setZValue(CANVAS_FRAME_Z_START);
+        else if (plane < curPlane)
+            pi->setZValue(CANVAS_PLANE_BELOW_Z_START + plane);
+        else
+            pi->setZValue(CANVAS_PLANE_ABOVE_Z_START + plane);
+    }
 }
 
 
@@ -8,27 +8,36 @@
 #define CANVAS_H
 
 #define CANVAS_BACKGROUND_Z_START -1000
+#define CANVAS_PLANE_BELOW_Z_START 200
 #define CANVAS_LIGHT_TABLE_BEFORE_Z_START 300
 #define CANVAS_FRAME_Z_START 600
 #define CANVAS_LIGHT_TABLE_AFTER_Z_START 900
+#define CANVAS_PLANE_ABOVE_Z_START 950
 #define CANVAS_FOREGROUND_Z_START 1000
 
 
 #include <QGraphicsView>
 #include <QList>
 #include <QHash>
+#include <QPointer>
 class CanvasScene;
 class CelRef;
 class CelRefItem;
 class Frame;
 class FrameItem;
 class TimedFrame;
+class XSheet;
+class PlaneItem;
+class PlaybackItem;
 class Backdrop;
+class CompositeItem;
+class SelectionItem;
+class OverlayItem;
+class Selection;
 class QSize;
 class QImage;
 class QGraphicsScene;
 class QGraphicsItem;
-class QGraphicsLineItem;
 class QGraphicsSceneMouseEvent;
 
 
@@ -46,6 +55,14 @@ public:
     QRectF getVisibleRect();
     qreal zoom();
     QColor backdropColor();
+    bool rasterMode();
+    QColor sampleColor(QPointF scenePos, bool withLightTable=false);
+
+    // Selection
+    void setSelection(Selection *selection);
+
+    // For tools to preview what they're drawing
+    OverlayItem *overlay();
 
 
 public slots:
@@ -53,8 +70,15 @@ public slots:
     void onZoomChanged(double zoom);
     void onFrameSizeChanged(QSize size);
     void setFrame(TimedFrame *tf);
+    void setXSheet(XSheet *xsheet);
+    void setSeqNum(quint32 seqNum);
     void onCurCelRefChanged(CelRef *cel);
     void setBackdropColor(QColor clr);
+    void setBackdropImage(QImage img);
+    void setBackdropCheckerboard();
+    void setRasterMode(bool raster);
+    void setPlayingBack(bool playing);
+    void setPlaybackImage(QImage image);
 
     // Light Table
     void turnOnLightTable(bool enable);
@@ -78,6 +102,9 @@ private slots:
     void _onCelRemoved(CelRef *ref);
     void _onCelMoved(CelRef *ref);
 
+    // For the other planes
+    void _onPlaneAdded(int plane);
+
 
 signals:
     // Mouse signals
@@ -97,6 +124,7 @@ protected:
     void leaveEvent(QEvent *evnet);
 
     void drawBackground(QPainter *painter, const QRectF &rect);
+    void drawForeground(QPainter *painter, const QRectF &rect);
 
 
 private:
@@ -105,13 +133,27 @@ private:
     void _removeCelRef(CelRef *cr);
     void _createLightTableItems();
     void _removeLightTableItems();
+    void _addLightTableFrame(Frame *frame, qreal opacity, qreal z);
+    void _stackPlaneItems();
 
     // Member vars
     CanvasScene *_scene = NULL;                        // Where all of the presentation for the drawing stuff takes place
     Backdrop *_backdrop = NULL;                        // A color/image that appears behind all of the Cels in every scene.
     QHash<CelRef *, CelRefItem *> _frameItems;        // List of all of items, most typically will be CelRefs; TODO bad name since FrameItems is another class, maybe thing of something different here...
     QList<FrameItem *> _lightTableItems;            // Used for light-table/onion skinning
-    QList<QGraphicsLineItem *> _gridItems;            // List of all of items that are used for the grid
+
+    // A Frame that's shown in the light table (kept for sampling, no matter how it's drawn)
+    struct LightTableFrame {
+        QPointer<Frame> frame;
+        qreal opacity;
+        qreal z;
+    };
+    QList<LightTableFrame> _lightTableFrames;
+    CompositeItem *_compositeItem = NULL;            // Draws the Frame and light table from one buffer when in raster mode
+    SelectionItem *_selectionItem = NULL;            // Outline of the selection, and any floating pixels
+    OverlayItem *_overlayItem = NULL;                // Shapes that are still being drawn by a Tool
+    QList<PlaneItem *> _planeItems;                    // One for each plane of the XSheet, the current plane's is hidden
+    PlaybackItem *_playbackItem = NULL;                // Shows the PlaybackEngine's renders, in place of the planes
 
 //    QList<QGraphicsItem *> _backgroundItems;        // Items for the background
 
@@ -124,7 +166,12 @@ private:
     // State vars
     Frame *_frame = NULL;                // Pointer to current Frame object that is being edited
     TimedFrame *_tf = NULL;                // Pointer to the current TimedFrame object
+    QPointer<XSheet> _xsheet;            // Where the other planes come from
+    quint32 _seqNum = 1;                // Current sequence number, for the other planes
     qreal _zoom = 1;                    // Zoom as a floating point
+    qreal _requestedZoom = 1;            // Zoom that was asked for (raster mode rounds it to a whole number)
+    bool _rasterMode = false;            // Draw the Frame from a single composited buffer instead of per Cel items
+    bool _playingBack = false;            // Only the PlaybackItem is drawn while the animation plays
     bool _showGrid = true;                // Boolean to show the grid or not
     bool _lightTableOn = false;            // Boolean to toggle the light-table on/off
     bool _lightTableLooping = false;    // Flag to use looping for the light table
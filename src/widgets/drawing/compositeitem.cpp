@@ -0,0 +1,317 @@
+// File:         compositeitem.cpp
+// Author:       Ben Summerton (define-private-public)
+// Description:  Source file for the CompositeItem class
+
+
+/*!
+    \inmodule Drawing
+    \class CompositeItem
+    \brief CompositeItem draws a stack of Frames from one cached image.
+
+    It's used by the Canvas when it's in raster mode.  Instead of having a CelRefItem
+    (and FrameItems for the light table) that each get drawn and scaled on every
+    repaint, all of the Frames are composited into one buffer.  Painting is then a
+    single (nearest neighbor) blit of the exposed part of the buffer.
+
+    Each Frame also keeps its own cached render, and both are only redone where they
+    have changed.  Edits to a Cel (Cel::damaged()) redo just the damaged area of the
+    Frames using it; anything else that changes a Frame redoes all of that Frame.
+*/
+
+
+#include "widgets/drawing/compositeitem.h"
+#include "animation/frame.h"
+#include "animation/celref.h"
+#include "animation/cel.h"
+#include "util.h"
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QDebug>
+
+
+/*!
+    Creates an empty CompositeItem.  Use setSize() and addFrame() to give it
+    something to draw.
+*/
+CompositeItem::CompositeItem(QGraphicsItem *parent) :
+    QGraphicsObject(parent)
+{
+    // So exposedRect is filled in for paint()
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+
+    qDebug() << "[CompositeItem created]";
+}
+
+
+/*!
+    Deconstructor.  Nothing but cleanup
+*/
+CompositeItem::~CompositeItem() {
+    qDebug() << "[CompositeItem destroyed]";
+}
+
+
+/*!
+    Returns the area of the item, the same as the frame size.
+*/
+QRectF CompositeItem::boundingRect() const {
+    return QRectF(QPointF(0, 0), _size);
+}
+
+
+/*!
+    Redoes the dirty part of the buffer (if any), then draws the exposed part of it.
+*/
+void CompositeItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    if (!_dirty.isEmpty()) {
+        _recomposite(_dirty);
+        _dirty = QRect();
+    }
+
+    util::drawImageMipmapped(painter, _buffer, _mips, option->exposedRect);
+}
+
+
+/*!
+    Adds \a frame to be drawn at \a opacity.  \a z works the same as a QGraphicsItem's
+    z value, higher values are drawn on top.  Will schedule a redraw.
+*/
+void CompositeItem::addFrame(Frame *frame, qreal opacity, qreal z) {
+    if (!frame)
+        return;
+
+    // Keep them sorted
+    Layer layer;
+    layer.frame = frame;
+    layer.opacity = opacity;
+    layer.z = z;
+    layer.render = util::mkBlankImage(_size);
+    layer.dirty = QRect(QPoint(0, 0), _size);
+
+    auto iter = _layers.begin();
+    while ((iter != _layers.end()) && (iter->z <= z))
+        iter++;
+    _layers.insert(iter, layer);
+
+    // Signals & slots
+    connect(frame, &Frame::celAdded, this, &CompositeItem::_onFrameChanged, Qt::UniqueConnection);
+    connect(frame, &Frame::celRemoved, this, &CompositeItem::_onFrameChanged, Qt::UniqueConnection);
+    connect(frame, &Frame::celMoved, this, &CompositeItem::_onFrameChanged, Qt::UniqueConnection);
+    connect(frame, &Frame::celRefPositionChanged, this, &CompositeItem::_onFrameChanged, Qt::UniqueConnection);
+    connect(frame, &Frame::destroyed, this, &CompositeItem::_onFrameChanged, Qt::UniqueConnection);
+    _connectCels(frame);
+
+    _invalidateAll();
+}
+
+
+/*!
+    Removes all of the Frames.  Will schedule a redraw.
+*/
+void CompositeItem::clear() {
+    for (auto iter = _layers.begin(); iter != _layers.end(); iter++) {
+        if (iter->frame) {
+            Frame *frame = iter->frame;
+            disconnect(frame, 0, this, 0);
+
+            QList<CelRef *> refs = frame->cels();
+            for (auto crIter = refs.begin(); crIter != refs.end(); crIter++) {
+                Cel *cel = (*crIter)->cel();
+                if (cel)
+                    disconnect(cel, 0, this, 0);
+            }
+        }
+    }
+
+    _layers.clear();
+    _invalidateAll();
+}
+
+
+/*!
+    Puts the pixel at \a px of the composited buffer (all of the Frames) into \a clr,
+    premultiplied.  Returns false if that part of the buffer is out of date.
+
+    \sa sampleFrame()
+*/
+bool CompositeItem::sample(QPoint px, QRgb *clr) {
+    if (_buffer.isNull() || _dirty.contains(px))
+        return false;
+
+    *clr = _buffer.valid(px) ? _buffer.pixel(px) : qRgba(0, 0, 0, 0);
+    return true;
+}
+
+
+/*!
+    Like sample(), but only looks at the cached render of \a frame (without its opacity).
+    Returns false if \a frame isn't one of the layers, or that part of its render is out of
+    date.
+
+    \sa sample()
+*/
+bool CompositeItem::sampleFrame(Frame *frame, QPoint px, QRgb *clr) {
+    for (auto iter = _layers.begin(); iter != _layers.end(); iter++) {
+        if (!iter->frame || (iter->frame.data() != frame))
+            continue;
+
+        if (iter->render.isNull() || iter->dirty.contains(px))
+            return false;
+
+        *clr = iter->render.valid(px) ? iter->render.pixel(px) : qRgba(0, 0, 0, 0);
+        return true;
+    }
+
+    return false;
+}
+
+
+/*!
+    Sets the size of the buffer to \a size (should be the frame size).  Will
+    schedule a redraw.
+*/
+void CompositeItem::setSize(QSize size) {
+    if (_size != size) {
+        prepareGeometryChange();
+        _size = size;
+        _buffer = util::mkBlankImage(_size);
+        for (auto iter = _layers.begin(); iter != _layers.end(); iter++)
+            iter->render = util::mkBlankImage(_size);
+
+        _invalidateAll();
+    }
+}
+
+
+/*!
+    Triggered when one of the Frames has a Cel added, removed or moved around.
+    Will redo all of that Frame.
+*/
+void CompositeItem::_onFrameChanged() {
+    QObject *frame = sender();
+    for (auto iter = _layers.begin(); iter != _layers.end(); iter++) {
+        // Destroyed Frames have already been nulled out
+        if (iter->frame && ((QObject *)iter->frame.data() != frame))
+            continue;
+
+        _connectCels(iter->frame);        // A new Cel might have come in
+        _invalidate(*iter, QRect(QPoint(0, 0), _size));
+    }
+}
+
+
+/*!
+    Triggered via Cel::damaged().  Redoes \a rect (in Cel coordinates) of every
+    place that the Cel shows up.
+*/
+void CompositeItem::_onCelDamaged(QRect rect) {
+    Cel *cel = qobject_cast<Cel *>(sender());
+    if (!cel)
+        return;
+
+    for (auto iter = _layers.begin(); iter != _layers.end(); iter++) {
+        if (!iter->frame)
+            continue;
+
+        QList<CelRef *> refs = iter->frame->cels();
+        for (auto crIter = refs.begin(); crIter != refs.end(); crIter++) {
+            if ((*crIter)->cel() == cel)
+                _invalidate(*iter, rect.translated((*crIter)->pos().toPoint()));
+        }
+    }
+}
+
+
+/*!
+    Triggered via Cel::resized().  Will redo everything.
+*/
+void CompositeItem::_onCelResized() {
+    _invalidateAll();
+}
+
+
+/*!
+    Internal function.  Watches all of the Cels in \a frame for changes.
+*/
+void CompositeItem::_connectCels(Frame *frame) {
+    if (!frame)
+        return;
+
+    QList<CelRef *> refs = frame->cels();
+    for (auto iter = refs.begin(); iter != refs.end(); iter++) {
+        Cel *cel = (*iter)->cel();
+        if (cel) {
+            connect(cel, &Cel::damaged, this, &CompositeItem::_onCelDamaged, Qt::UniqueConnection);
+            connect(cel, &Cel::resized, this, &CompositeItem::_onCelResized, Qt::UniqueConnection);
+        }
+    }
+}
+
+
+/*!
+    Internal function.  Marks \a rect of \a layer (and the buffer) to be redone on
+    the next paint, and schedules that paint.
+*/
+void CompositeItem::_invalidate(Layer &layer, QRect rect) {
+    rect &= QRect(QPoint(0, 0), _size);
+    if (rect.isEmpty())
+        return;
+
+    layer.dirty |= rect;
+    _dirty |= rect;
+    update(rect);
+}
+
+
+/*!
+    Internal function.  Marks everything to be redone on the next paint.
+*/
+void CompositeItem::_invalidateAll() {
+    QRect all(QPoint(0, 0), _size);
+    for (auto iter = _layers.begin(); iter != _layers.end(); iter++)
+        iter->dirty = all;
+
+    _dirty = all;
+    update();
+}
+
+
+/*!
+    Internal function.  Redraws \a rect of the buffer from the Frames.
+*/
+void CompositeItem::_recomposite(QRect rect) {
+    rect &= _buffer.rect();
+    if (rect.isEmpty())
+        return;
+
+    QPainter p(&_buffer);
+
+    // Clear out the old
+    p.setCompositionMode(QPainter::CompositionMode_Source);
+    p.fillRect(rect, Qt::transparent);
+    p.setCompositionMode(QPainter::CompositionMode_SourceOver);
+
+    // Each Frame is rendered on its own so the opacity applies to the Frame as a whole
+    for (auto iter = _layers.begin(); iter != _layers.end(); iter++) {
+        if (!iter->frame)
+            continue;
+
+        // Bring the Frame's render up to date first
+        QRect layerDirty = iter->dirty & iter->render.rect();
+        if (!layerDirty.isEmpty()) {
+            QPainter lp(&iter->render);
+            lp.setCompositionMode(QPainter::CompositionMode_Source);
+            lp.drawImage(layerDirty.topLeft(), iter->frame->render(layerDirty));
+            lp.end();
+        }
+        iter->dirty = QRect();
+
+        p.setOpacity(iter->opacity);
+        p.drawImage(rect.topLeft(), iter->render, rect);
+    }
+
+    p.end();
+
+    // Mip levels are stale now
+    _mips.clear();
+}
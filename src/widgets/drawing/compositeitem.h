@@ -0,0 +1,75 @@
+// File:         compositeitem.h
+// Author:       Ben Summerton (define-private-public)
+// Description:  Header file for the CompositeItem class.
+
+
+#ifndef COMPOSITE_ITEM_H
+#define COMPOSITE_ITEM_H
+
+
+#include <QGraphicsObject>
+#include <QPointer>
+#include <QImage>
+#include <QList>
+#include <QRect>
+class Frame;
+class Cel;
+class CelRef;
+
+
+class CompositeItem : public QGraphicsObject {
+    Q_OBJECT;
+
+public:
+    CompositeItem(QGraphicsItem *parent=NULL);
+    ~CompositeItem();
+
+    // Overrides
+    QRectF boundingRect() const;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget=NULL);
+
+    // Layers
+    void addFrame(Frame *frame, qreal opacity, qreal z);
+    void clear();
+
+    // Cached renders
+    bool sample(QPoint px, QRgb *clr);
+    bool sampleFrame(Frame *frame, QPoint px, QRgb *clr);
+
+
+public slots:
+    void setSize(QSize size);
+
+
+private slots:
+    // Frame & Cel signals
+    void _onFrameChanged();
+    void _onCelDamaged(QRect rect);
+    void _onCelResized();
+
+
+private:
+    // A Frame that is drawn into the buffer
+    struct Layer {
+        QPointer<Frame> frame;
+        qreal opacity;
+        qreal z;
+        QImage render;        // Cached render of the Frame
+        QRect dirty;        // Part of render that needs to be redone
+    };
+
+    void _connectCels(Frame *frame);
+    void _invalidate(Layer &layer, QRect rect);
+    void _invalidateAll();
+    void _recomposite(QRect rect);
+
+    QList<Layer> _layers;        // Sorted by z, bottom most first
+    QSize _size;                // Size of the buffer (the frame size)
+    QImage _buffer;                // Composite of all of the layers
+    QList<QImage> _mips;        // Lazily generated mip levels of _buffer
+    QRect _dirty;                // Part of _buffer that needs to be redone
+
+};
+
+
+#endif // COMPOSITE_ITEM_H
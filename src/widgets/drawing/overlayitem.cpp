@@ -0,0 +1,179 @@
+// File:         overlayitem.cpp
+// Author:       Ben Summerton (define-private-public)
+// Description:  Source file for the OverlayItem class
+
+
+/*!
+    \inmodule Drawing
+    \class OverlayItem
+    \brief OverlayItem shows a shape that's still being drawn, ontop of the current Cel.
+
+    Tools like the Line and Shape tools change what they're going to draw on every mouse move.
+    Instead of rewriting the Cel each time, they give their spans (see raster::Spans) to the
+    overlay, which just draws them as rectangles.  The Cel isn't touched, so none of its caches
+    are thrown out.  When the tool is done, commit() writes the spans into the current Cel in
+    one go.
+
+    It can also show a dashed outline (see setOutline()), for things like previewing a Cel's
+    new size before it's actually resized.
+
+    The overlay should be placed at the position of the current CelRef.
+*/
+
+
+#include "widgets/drawing/overlayitem.h"
+#include "blitapp.h"
+#include "undohistory.h"
+#include "selection.h"
+#include "animation/cel.h"
+#include "animation/pngcel.h"
+#include <QPainter>
+#include <QPen>
+#include <QImage>
+#include <QVector>
+
+
+OverlayItem::OverlayItem(QGraphicsItem *parent) :
+    QGraphicsObject(parent)
+{
+    // Do nothing
+}
+
+
+OverlayItem::~OverlayItem() {
+    // Do nothing
+}
+
+
+QRectF OverlayItem::boundingRect() const {
+    return _bounds;
+}
+
+
+/*!
+    Draws each span as a one pixel tall rectangle, and then the outline (if there is one).
+*/
+void OverlayItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    if (!_outline.isNull()) {
+        // Cosmetic so it stays one pixel wide on screen no matter the zoom
+        QPen pen(Qt::white, 0);
+        painter->setBrush(Qt::NoBrush);
+        painter->setPen(pen);
+        painter->drawRect(_outline);
+        pen.setColor(Qt::black);
+        pen.setStyle(Qt::DashLine);
+        painter->setPen(pen);
+        painter->drawRect(_outline);
+    }
+
+    if (_spans.isEmpty())
+        return;
+
+    QVector<QRect> rects;
+    rects.reserve(_spans.size());
+    for (auto iter = _spans.begin(); iter != _spans.end(); iter++)
+        rects.append(QRect(iter->x0, iter->y, iter->x1 - iter->x0 + 1, 1));
+
+    painter->setPen(Qt::NoPen);
+    painter->setBrush(_clr);
+    painter->drawRects(rects);
+}
+
+
+/*!
+    Shows \a spans (in Cel coordinates) in \a clr, replacing whatever was being shown.
+*/
+void OverlayItem::setSpans(const raster::Spans &spans, QColor clr) {
+    prepareGeometryChange();
+
+    _spans = spans;
+    raster::normalize(_spans);
+    _clr = clr;
+    _bounds = raster::bounds(_spans);
+    if (!_outline.isNull())
+        _bounds |= _outline.adjusted(-1, -1, 1, 1);
+
+    update();
+}
+
+
+/*!
+    Shows a dashed rectangle at \a outline (in Cel coordinates), replacing the last one.  Only
+    the outline's geometry changes, so this is cheap enough to call on every mouse move.  A
+    null rectangle hides it.
+*/
+void OverlayItem::setOutline(QRectF outline) {
+    prepareGeometryChange();
+
+    _outline = outline;
+    _bounds = raster::bounds(_spans);
+    if (!_outline.isNull())
+        _bounds |= _outline.adjusted(-1, -1, 1, 1);
+
+    update();
+}
+
+
+/*!
+    Returns true if nothing is being shown.
+*/
+bool OverlayItem::isEmpty() {
+    return _spans.isEmpty();
+}
+
+
+/*!
+    Writes what's being shown into the current Cel, and then clears the overlay.  Returns the
+    area of the Cel that was changed.
+*/
+QRect OverlayItem::commit() {
+    QRect dirty;
+    Cel *cel = BlitApp::app()->curCel();
+    if (_spans.isEmpty() || !cel) {
+        clear();
+        return dirty;
+    }
+
+    // If this isn't happening during a press on the Canvas, make it its own undo step
+    UndoHistory *history = BlitApp::app()->history();
+    Selection *selection = BlitApp::app()->selection();
+    bool ownEdit = !history->editing() && (cel->type() == PNG_CEL_TYPE);
+    if (ownEdit) {
+        history->beginCelEdit((PNGCel *)cel);
+        selection->beginEdit();
+    }
+
+    QImage *img = (cel->type() == PNG_CEL_TYPE) ? ((PNGCel *)cel)->imageData() : NULL;
+    if (img) {
+        // Right into the Cel
+        dirty = raster::draw(*img, _spans, _clr);
+        ((PNGCel *)cel)->damage(dirty);
+    } else {
+        // Cel isn't loaded, go through a copy
+        QImage buff = BlitApp::app()->celImage();
+        dirty = raster::draw(buff, _spans, _clr);
+        BlitApp::app()->copyOntoCel(buff);
+    }
+
+    if (ownEdit) {
+        selection->endEdit();
+        history->endCelEdit();
+    }
+
+    clear();
+    return dirty;
+}
+
+
+/*!
+    Stops showing anything.
+*/
+void OverlayItem::clear() {
+    prepareGeometryChange();
+
+    _spans.clear();
+    _outline = QRectF();
+    _bounds = QRectF();
+
+    update();
+}
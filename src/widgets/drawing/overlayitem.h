@@ -0,0 +1,47 @@
+// File:         overlayitem.h
+// Author:       Ben Summerton (define-private-public)
+// Description:  Header file for the OverlayItem class.
+
+
+#ifndef OVERLAY_ITEM_H
+#define OVERLAY_ITEM_H
+
+
+#include "tools/rasterizer.h"
+#include <QGraphicsObject>
+#include <QColor>
+#include <QRectF>
+
+
+class OverlayItem : public QGraphicsObject {
+    Q_OBJECT;
+
+public:
+    OverlayItem(QGraphicsItem *parent=NULL);
+    ~OverlayItem();
+
+    // Overrides
+    QRectF boundingRect() const;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget=NULL);
+
+    // Preview
+    void setSpans(const raster::Spans &spans, QColor clr);
+    bool isEmpty();
+    QRect commit();
+    void setOutline(QRectF outline);
+
+
+public slots:
+    void clear();
+
+
+private:
+    raster::Spans _spans;        // What's being previewed (normalized, in Cel coordinates)
+    QColor _clr;
+    QRectF _outline;             // Dashed rectangle to show, (e.g. a Cel's new size during a resize)
+    QRectF _bounds;
+
+};
+
+
+#endif // OVERLAY_ITEM_H
@@ -0,0 +1,322 @@
+// File:         planeitem.cpp
+// Author:       Ben Summerton (define-private-public)
+// Description:  Source file for the PlaneItem class
+
+
+/*!
+    \inmodule Drawing
+    \class PlaneItem
+    \brief PlaneItem draws what one plane of an XSheet shows at a sequence number.
+
+    The Canvas has one of these for each plane that isn't being edited, so the other planes
+    show up above or below the current Frame.  Going to a different sequence number only
+    looks up which Frame is there; the Frames that have been shown keep a cached render, so
+    flipping back and forth (or through a hold) doesn't render anything again.
+
+    Renders are only redone where they've changed.  Edits to a Cel (Cel::damaged()) redo just
+    the damaged area of the Frames using it; anything else that changes a Frame redoes all of
+    it.  Since a PlaneItem only watches the Frames of its own plane, drawing on one plane
+    leaves the caches of the others alone.
+
+    The cache is bounded by PLANE_ITEM_CACHE_LIMIT, the least recently used renders are
+    thrown out first.
+*/
+
+
+#include "widgets/drawing/planeitem.h"
+#include "animation/xsheet.h"
+#include "animation/timedframe.h"
+#include "animation/frame.h"
+#include "animation/celref.h"
+#include "animation/cel.h"
+#include "util.h"
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QDebug>
+
+
+/*!
+    Creates a PlaneItem that shows \a plane of \a xsheet.  Use setSize() and setSeqNum()
+    to give it something to draw.
+*/
+PlaneItem::PlaneItem(XSheet *xsheet, int plane, QGraphicsItem *parent) :
+    QGraphicsObject(parent),
+    _xsheet(xsheet),
+    _plane(plane),
+    _renders(PLANE_ITEM_CACHE_LIMIT)
+{
+    // So exposedRect is filled in for paint()
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+
+    if (_xsheet) {
+        connect(_xsheet, &XSheet::seqNumsChanged, this, &PlaneItem::_onSeqNumsChanged);
+        connect(_xsheet, &XSheet::frameRemoved, this, &PlaneItem::_onFrameRemoved);
+    }
+
+    _resolve();
+
+    qDebug() << "[PlaneItem created] plane=" << _plane;
+}
+
+
+/*!
+    Deconstructor.  Nothing but cleanup
+*/
+PlaneItem::~PlaneItem() {
+    qDebug() << "[PlaneItem destroyed] plane=" << _plane;
+}
+
+
+/*!
+    Returns the area of the item, the same as the frame size.
+*/
+QRectF PlaneItem::boundingRect() const {
+    return QRectF(QPointF(0, 0), _size);
+}
+
+
+/*!
+    Brings the shown Frame's render up to date (if it needs it), then draws the exposed part
+    of it.
+*/
+void PlaneItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    if (!_frame || _size.isEmpty())
+        return;
+
+    Render *render = _renders.object(_frame.data());
+    if (!render) {
+        // Wasn't shown before (or got thrown out of the cache)
+        render = new Render;
+        render->image = util::mkBlankImage(_size);
+        render->dirty = render->image.rect();
+
+        int cost = qMax(render->image.byteCount() / 1024, 1);
+        if (!_renders.insert(_frame.data(), render, cost))
+            return;                                        // Bigger than the whole cache
+        _mips.clear();
+    }
+
+    QRect dirty = render->dirty & render->image.rect();
+    if (!dirty.isEmpty()) {
+        QPainter p(&render->image);
+        p.setCompositionMode(QPainter::CompositionMode_Source);
+        p.drawImage(dirty.topLeft(), _frame->render(dirty));
+        p.end();
+
+        _mips.clear();
+    }
+    render->dirty = QRect();
+
+    util::drawImageMipmapped(painter, render->image, _mips, option->exposedRect);
+}
+
+
+/*!
+    Returns the plane of the XSheet that's being shown.
+*/
+int PlaneItem::plane() {
+    return _plane;
+}
+
+
+/*!
+    Puts the pixel at \a px (in item coordinates) of the shown Frame's cached render into
+    \a clr, premultiplied.  Returns false if there isn't a render for it yet, or that part of
+    it is out of date; it's up to the caller to render the pixel then.  If no Frame is shown,
+    \a clr is transparent.
+*/
+bool PlaneItem::sample(QPoint px, QRgb *clr) {
+    if (!_frame || _size.isEmpty()) {
+        *clr = qRgba(0, 0, 0, 0);
+        return true;
+    }
+
+    Render *render = _renders.object(_frame.data());
+    if (!render || render->dirty.contains(px))
+        return false;
+
+    *clr = render->image.valid(px) ? render->image.pixel(px) : qRgba(0, 0, 0, 0);
+    return true;
+}
+
+
+/*!
+    Sets the size of the renders to \a size (should be the frame size).  All of the cached
+    renders are thrown out.
+*/
+void PlaneItem::setSize(QSize size) {
+    if (_size != size) {
+        prepareGeometryChange();
+        _size = size;
+        _renders.clear();
+        _mips.clear();
+        update();
+    }
+}
+
+
+/*!
+    Shows the Frame that's at \a seqNum in the plane.  If it's been shown before, its cached
+    render is used.
+*/
+void PlaneItem::setSeqNum(int seqNum) {
+    if (_seqNum != seqNum) {
+        _seqNum = seqNum;
+        _resolve();
+    }
+}
+
+
+/*!
+    Triggered by the XSheet.  If \a plane is the one being shown, the Frame at the current
+    sequence number might be a different one now.
+*/
+void PlaneItem::_onSeqNumsChanged(int plane, int first, int last) {
+    Q_UNUSED(first);
+    Q_UNUSED(last);
+
+    if (plane == _plane)
+        _resolve();
+}
+
+
+/*!
+    Triggered by the XSheet when \a tf is taken out of it.  Since it could have been the
+    shown one (or the last one in the plane), figures out what's shown again.
+*/
+void PlaneItem::_onFrameRemoved(QPointer<TimedFrame> tf) {
+    if (tf && (tf->plane() != _plane))
+        return;
+
+    _resolve();
+}
+
+
+/*!
+    Triggered when one of the cached Frames has a Cel added, removed or moved around.  Will
+    redo all of that Frame.
+*/
+void PlaneItem::_onFrameChanged() {
+    Frame *frame = qobject_cast<Frame *>(sender());
+    if (!frame)
+        return;
+
+    _connectFrame(frame);        // A new Cel might have come in
+    _invalidate(frame, QRect(QPoint(0, 0), _size));
+}
+
+
+/*!
+    Triggered when one of the cached Frames is deleted.  Throws out its render.
+*/
+void PlaneItem::_onFrameDestroyed(QObject *obj) {
+    // Already partly destroyed, so only the pointer value can be used
+    _renders.remove(static_cast<Frame *>(obj));
+    if (!_frame)
+        _resolve();                // Was the shown one
+}
+
+
+/*!
+    Triggered via Cel::damaged().  Redoes \a rect (in Cel coordinates) of every cached Frame
+    that the Cel shows up in.
+*/
+void PlaneItem::_onCelDamaged(QRect rect) {
+    Cel *cel = qobject_cast<Cel *>(sender());
+    if (!cel)
+        return;
+
+    QList<Frame *> frames = _renders.keys();
+    for (auto iter = frames.begin(); iter != frames.end(); iter++) {
+        QList<CelRef *> refs = (*iter)->cels();
+        for (auto crIter = refs.begin(); crIter != refs.end(); crIter++) {
+            if ((*crIter)->cel() == cel)
+                _invalidate(*iter, rect.translated((*crIter)->pos().toPoint()));
+        }
+    }
+}
+
+
+/*!
+    Triggered via Cel::resized().  Will redo every cached Frame that the Cel is in.
+*/
+void PlaneItem::_onCelResized() {
+    Cel *cel = qobject_cast<Cel *>(sender());
+    if (!cel)
+        return;
+
+    QList<Frame *> frames = _renders.keys();
+    for (auto iter = frames.begin(); iter != frames.end(); iter++) {
+        QList<CelRef *> refs = (*iter)->cels();
+        for (auto crIter = refs.begin(); crIter != refs.end(); crIter++) {
+            if ((*crIter)->cel() == cel) {
+                _invalidate(*iter, QRect(QPoint(0, 0), _size));
+                break;
+            }
+        }
+    }
+}
+
+
+/*!
+    Internal function.  Looks up the Frame at the current sequence number of the plane.  If
+    it's a different one than what's shown, schedules a redraw.
+*/
+void PlaneItem::_resolve() {
+    Frame *frame = NULL;
+    if (_xsheet) {
+        TimedFrame *tf = _xsheet->frameAtSeq(_seqNum, _plane);
+        if (tf)
+            frame = tf->frame();
+    }
+
+    if (frame != _frame.data()) {
+        _frame = frame;
+        _mips.clear();
+        _connectFrame(frame);
+        update();
+    }
+}
+
+
+/*!
+    Internal function.  Watches \a frame, and all of its Cels, for changes.
+*/
+void PlaneItem::_connectFrame(Frame *frame) {
+    if (!frame)
+        return;
+
+    connect(frame, &Frame::celAdded, this, &PlaneItem::_onFrameChanged, Qt::UniqueConnection);
+    connect(frame, &Frame::celRemoved, this, &PlaneItem::_onFrameChanged, Qt::UniqueConnection);
+    connect(frame, &Frame::celMoved, this, &PlaneItem::_onFrameChanged, Qt::UniqueConnection);
+    connect(frame, &Frame::celRefPositionChanged, this, &PlaneItem::_onFrameChanged, Qt::UniqueConnection);
+    connect(frame, &Frame::destroyed, this, &PlaneItem::_onFrameDestroyed, Qt::UniqueConnection);
+
+    QList<CelRef *> refs = frame->cels();
+    for (auto iter = refs.begin(); iter != refs.end(); iter++) {
+        Cel *cel = (*iter)->cel();
+        if (cel) {
+            connect(cel, &Cel::damaged, this, &PlaneItem::_onCelDamaged, Qt::UniqueConnection);
+            connect(cel, &Cel::resized, this, &PlaneItem::_onCelResized, Qt::UniqueConnection);
+        }
+    }
+}
+
+
+/*!
+    Internal function.  Marks \a rect of \a frame's cached render to be redone.  If it's the
+    shown Frame, schedules a redraw of that area.  Frames that aren't cached are left alone,
+    they'll be rendered in full if they're shown again.
+*/
+void PlaneItem::_invalidate(Frame *frame, QRect rect) {
+    rect &= QRect(QPoint(0, 0), _size);
+    if (rect.isEmpty())
+        return;
+
+    Render *render = _renders.object(frame);
+    if (render)
+        render->dirty |= rect;
+
+    if (frame == _frame.data())
+        update(rect);
+}
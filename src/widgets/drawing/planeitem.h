@@ -0,0 +1,80 @@
+// File:         planeitem.h
+// Author:       Ben Summerton (define-private-public)
+// Description:  Header file for the PlaneItem class.
+
+
+#ifndef PLANE_ITEM_H
+#define PLANE_ITEM_H
+
+// Most memory (in KiB) that the cached renders of one plane can take up
+#define PLANE_ITEM_CACHE_LIMIT (64 * 1024)
+
+
+#include <QGraphicsObject>
+#include <QPointer>
+#include <QImage>
+#include <QList>
+#include <QCache>
+#include <QRect>
+class XSheet;
+class TimedFrame;
+class Frame;
+class Cel;
+
+
+class PlaneItem : public QGraphicsObject {
+    Q_OBJECT;
+
+public:
+    PlaneItem(XSheet *xsheet, int plane, QGraphicsItem *parent=NULL);
+    ~PlaneItem();
+
+    // Overrides
+    QRectF boundingRect() const;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget=NULL);
+
+    // Accessors
+    int plane();
+    bool sample(QPoint px, QRgb *clr);
+
+
+public slots:
+    void setSize(QSize size);
+    void setSeqNum(int seqNum);
+
+
+private slots:
+    // XSheet signals
+    void _onSeqNumsChanged(int plane, int first, int last);
+    void _onFrameRemoved(QPointer<TimedFrame> tf);
+
+    // Frame & Cel signals
+    void _onFrameChanged();
+    void _onFrameDestroyed(QObject *obj);
+    void _onCelDamaged(QRect rect);
+    void _onCelResized();
+
+
+private:
+    // Cached render of a Frame
+    struct Render {
+        QImage image;
+        QRect dirty;        // Part of image that needs to be redone
+    };
+
+    void _resolve();
+    void _connectFrame(Frame *frame);
+    void _invalidate(Frame *frame, QRect rect);
+
+    QPointer<XSheet> _xsheet;                // Where the frames come from
+    int _plane = 0;                            // Which plane of _xsheet is shown
+    int _seqNum = 1;                        // Sequence number being shown
+    QSize _size;                            // Size of the renders (the frame size)
+    QPointer<Frame> _frame;                    // Frame that's being shown
+    QCache<Frame *, Render> _renders;        // Renders of the Frames that have been shown, cost is in KiB
+    QList<QImage> _mips;                    // Lazily generated mip levels of the shown render
+
+};
+
+
+#endif // PLANE_ITEM_H
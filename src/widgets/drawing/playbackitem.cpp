@@ -0,0 +1,83 @@
+// File:         playbackitem.cpp
+// Author:       Ben Summerton (define-private-public)
+// Description:  Source file for the PlaybackItem class
+
+
+/*!
+    \inmodule Drawing
+    \class PlaybackItem
+    \brief PlaybackItem shows the renders from the PlaybackEngine while the animation plays.
+
+    The Canvas shows this instead of its PlaneItems during playback.  It doesn't look at the
+    XSheet or any Frames, it only draws the last image it was given.  Each one is only shown
+    for a moment, so no mip levels are made (unlike the PlaneItems), it's a plain blit of the
+    exposed area.
+*/
+
+
+#include "widgets/drawing/playbackitem.h"
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+#include <QDebug>
+
+
+/*!
+    Creates an empty PlaybackItem.
+*/
+PlaybackItem::PlaybackItem(QGraphicsItem *parent) :
+    QGraphicsItem(parent)
+{
+    // So exposedRect is filled in for paint()
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+
+    qDebug() << "[PlaybackItem created]";
+}
+
+
+/*!
+    Deconstructor.  Nothing but cleanup
+*/
+PlaybackItem::~PlaybackItem() {
+    qDebug() << "[PlaybackItem destroyed]";
+}
+
+
+/*!
+    Returns the area of the item, the same as the frame size.
+*/
+QRectF PlaybackItem::boundingRect() const {
+    return QRectF(QPointF(0, 0), _size);
+}
+
+
+/*!
+    Draws the exposed part of the image.
+*/
+void PlaybackItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    if (_image.isNull())
+        return;
+
+    QRectF exposed = option->exposedRect & QRectF(_image.rect());
+    painter->drawImage(exposed, _image, exposed);
+}
+
+
+/*!
+    Sets the size of the item to \a size (should be the frame size).
+*/
+void PlaybackItem::setSize(QSize size) {
+    if (_size != size) {
+        prepareGeometryChange();
+        _size = size;
+    }
+}
+
+
+/*!
+    Shows \a image, a null one clears it.  Will schedule a redraw.
+*/
+void PlaybackItem::setImage(const QImage &image) {
+    _image = image;
+    update();
+}
+
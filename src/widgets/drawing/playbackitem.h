@@ -0,0 +1,38 @@
+// File:         playbackitem.h
+// Author:       Ben Summerton (define-private-public)
+// Description:  Header file for the PlaybackItem class.
+
+
+#ifndef PLAYBACK_ITEM_H
+#define PLAYBACK_ITEM_H
+
+
+#include <QGraphicsItem>
+#include <QImage>
+#include <QSize>
+
+
+class PlaybackItem : public QGraphicsItem {
+
+public:
+    PlaybackItem(QGraphicsItem *parent=NULL);
+    ~PlaybackItem();
+
+    // Overrides
+    QRectF boundingRect() const;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget=NULL);
+
+    // Modifiers
+    void setSize(QSize size);
+    void setImage(const QImage &image);
+
+
+private:
+    QSize _size;                // Frame size
+    QImage _image;                // What's being shown
+
+};
+
+
+#endif // PLAYBACK_ITEM_H
+
@@ -0,0 +1,123 @@
+// File:         selectionitem.cpp
+// Author:       Ben Summerton (define-private-public)
+// Description:  Source file for the SelectionItem class
+
+
+/*!
+    \inmodule Drawing
+    \class SelectionItem
+    \brief SelectionItem draws the current Selection ontop of the Canvas.
+
+    It shows the outline of the selection (or the one being made), and if the selection is
+    floating it draws the lifted pixels where they've been moved/scaled to.  This is only
+    presentation, the Cel isn't touched until Selection::commit() is called.  The item should
+    be placed at the position of the CelRef that the selection is on.
+*/
+
+
+#include "widgets/drawing/selectionitem.h"
+#include "selection.h"
+#include "animation/celref.h"
+#include <QPainter>
+#include <QPen>
+#include <QTransform>
+#include <QStyleOptionGraphicsItem>
+
+
+SelectionItem::SelectionItem(Selection *selection, QGraphicsItem *parent) :
+    QGraphicsObject(parent),
+    _selection(selection)
+{
+    connect(selection, &Selection::changed, this, &SelectionItem::_onSelectionChanged);
+    _onSelectionChanged();
+}
+
+
+SelectionItem::~SelectionItem() {
+    // Do nothing
+}
+
+
+QRectF SelectionItem::boundingRect() const {
+    return _bounds;
+}
+
+
+/*!
+    Draws the floating pixels (if any), then the outline of the selection.
+*/
+void SelectionItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    if (!_selection)
+        return;
+
+    // Outline follows the floating pixels around
+    QTransform xform;
+    if (_selection->isFloating()) {
+        QRectF fr = _selection->floatRect();
+        painter->drawImage(fr, _selection->floatingImage());
+
+        QPointF tl = _selection->bounds().topLeft();
+        xform.translate(fr.left(), fr.top());
+        xform.scale(_selection->floatScale(), _selection->floatScale());
+        xform.translate(-tl.x(), -tl.y());
+    }
+
+    // Marching ants (well, standing still ones)
+    QPen light(Qt::white, 0);
+    QPen dark(Qt::black, 0, Qt::DashLine);
+
+    QPainterPath outline = xform.map(_selection->outline());
+    painter->setPen(light);
+    painter->drawPath(outline);
+    painter->setPen(dark);
+    painter->drawPath(outline);
+
+    QPolygonF preview = _selection->preview();
+    if (!preview.isEmpty()) {
+        painter->setPen(light);
+        painter->drawPolygon(preview);
+        painter->setPen(dark);
+        painter->drawPolygon(preview);
+    }
+}
+
+
+/*!
+    Makes the item follow \a ref around, since the selection is in the coordinates of its Cel.
+*/
+void SelectionItem::setCelRef(CelRef *ref) {
+    if (_ref)
+        disconnect(_ref, &CelRef::positionChanged, this, &SelectionItem::_onCelRefPositionChanged);
+
+    _ref = ref;
+    if (ref) {
+        connect(ref, &CelRef::positionChanged, this, &SelectionItem::_onCelRefPositionChanged);
+        setPos(ref->pos());
+    } else
+        setPos(0, 0);
+}
+
+
+/*!
+    Recalculates the area that the item covers, and repaints.
+*/
+void SelectionItem::_onSelectionChanged() {
+    prepareGeometryChange();
+
+    _bounds = QRectF();
+    if (_selection) {
+        _bounds = _selection->isFloating() ? _selection->floatRect() : QRectF(_selection->bounds());
+        _bounds |= _selection->preview().boundingRect();
+        _bounds.adjust(-1, -1, 1, 1);
+    }
+
+    update();
+}
+
+
+/*!
+    Called when the CelRef that's being followed is moved.
+*/
+void SelectionItem::_onCelRefPositionChanged(QPointF pos) {
+    setPos(pos);
+}
@@ -0,0 +1,44 @@
+// File:         selectionitem.h
+// Author:       Ben Summerton (define-private-public)
+// Description:  Header file for the SelectionItem class.
+
+
+#ifndef SELECTION_ITEM_H
+#define SELECTION_ITEM_H
+
+
+#include <QGraphicsObject>
+#include <QPointer>
+#include <QRectF>
+class Selection;
+class CelRef;
+
+
+class SelectionItem : public QGraphicsObject {
+    Q_OBJECT;
+
+public:
+    SelectionItem(Selection *selection, QGraphicsItem *parent=NULL);
+    ~SelectionItem();
+
+    // Overrides
+    QRectF boundingRect() const;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget=NULL);
+
+    void setCelRef(CelRef *ref);
+
+
+private slots:
+    void _onSelectionChanged();
+    void _onCelRefPositionChanged(QPointF pos);
+
+
+private:
+    QPointer<Selection> _selection;
+    QPointer<CelRef> _ref;                // CelRef that the item follows around
+    QRectF _bounds;                        // Area covered by the outline & floating pixels
+
+};
+
+
+#endif // SELECTION_ITEM_H
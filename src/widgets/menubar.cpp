@@ -5,11 +5,15 @@
 
 #include "widgets/menubar.h"
 #include "blitapp.h"
+#include "undohistory.h"
+#include "selection.h"
 #include "animation/animation.h"
 #include "widgets/drawing/canvas.h"
 #include <QAction>
 #include <QMenu>
 #include <QDockWidget>
+#include <QUndoStack>
+#include <QKeySequence>
 
 
 MenuBar::MenuBar(BlitApp *parent, QList<QDockWidget *> &docks) :
@@ -22,6 +26,14 @@ MenuBar::MenuBar(BlitApp *parent, QList<QDockWidget *> &docks) :
     _saveAsAction = new QAction(tr("Save &As..."), this);
     _quitAppAction = new QAction(tr("&Quit"), this);
 
+    // Edit Menu
+    _undoAction = parent->history()->stack()->createUndoAction(this, tr("&Undo"));
+    _undoAction->setShortcut(QKeySequence::Undo);
+    _redoAction = parent->history()->stack()->createRedoAction(this, tr("&Redo"));
+    _redoAction->setShortcut(QKeySequence::Redo);
+    _deselectAction = new QAction(tr("&Deselect"), this);
+    _deselectAction->setShortcut(QKeySequence(tr("Ctrl+Shift+A")));
+
     // Animation Menu
     _animPropsAction = new QAction(tr("&Properties"), this);
 
@@ -30,7 +42,13 @@ MenuBar::MenuBar(BlitApp *parent, QList<QDockWidget *> &docks) :
     _showGridAction->setCheckable(true);
     _showGridAction->setChecked(true);
 
+    _rasterModeAction = new QAction(tr("&Raster Mode"), this);
+    _rasterModeAction->setCheckable(true);
+    _rasterModeAction->setChecked(false);
+
     _setBackdropAction = new QAction(tr("Set &Backdrop Color"), this);
+    _setBackdropImageAction = new QAction(tr("Set Backdrop &Image..."), this);
+    _setBackdropCheckerboardAction = new QAction(tr("&Checkerboard Backdrop"), this);
 
 
     // Import
@@ -64,6 +82,14 @@ MenuBar::MenuBar(BlitApp *parent, QList<QDockWidget *> &docks) :
     _fileMenu->addSeparator();
     _fileMenu->addAction(_quitAppAction);
 
+    // Edit Menu
+    _editMenu = new QMenu(tr("&Edit"));
+    _editMenu->addAction(_undoAction);
+    _editMenu->addAction(_redoAction);
+    _editMenu->addSeparator();
+    _editMenu->addAction(_deselectAction);
+    _editMenu->hide();        // Hidden by default
+
     // Animation Menu
     _animMenu = new QMenu(tr("&Animation"));
     _animMenu->addAction(_animPropsAction);
@@ -72,7 +98,10 @@ MenuBar::MenuBar(BlitApp *parent, QList<QDockWidget *> &docks) :
     // Canvas Menu
     _canvasMenu = new QMenu(tr("&Canvas"));
     _canvasMenu->addAction(_showGridAction);
+    _canvasMenu->addAction(_rasterModeAction);
     _canvasMenu->addAction(_setBackdropAction);
+    _canvasMenu->addAction(_setBackdropImageAction);
+    _canvasMenu->addAction(_setBackdropCheckerboardAction);
     _canvasMenu->hide();    // Hidden by default
 
     /*== View Menu ==*/
@@ -109,9 +138,13 @@ MenuBar::MenuBar(BlitApp *parent, QList<QDockWidget *> &docks) :
     connect(_openAnimAction, &QAction::triggered, parent, &BlitApp::onOpenAnim);
     connect(_saveAsAction, &QAction::triggered, parent, &BlitApp::onSaveAs);
     connect(_quitAppAction, &QAction::triggered, parent, &BlitApp::close);
+    connect(_deselectAction, &QAction::triggered, parent->selection(), &Selection::clear);
     connect(_animPropsAction, &QAction::triggered, this, &MenuBar::_onAnimPropsClicked);
     connect(_showGridAction, &QAction::toggled, parent->canvas(), &Canvas::showGrid);
+    connect(_rasterModeAction, &QAction::toggled, parent->canvas(), &Canvas::setRasterMode);
     connect(_setBackdropAction, &QAction::triggered, parent, &BlitApp::onSetBackdrop);
+    connect(_setBackdropImageAction, &QAction::triggered, parent, &BlitApp::onSetBackdropImage);
+    connect(_setBackdropCheckerboardAction, &QAction::triggered, parent->canvas(), &Canvas::setBackdropCheckerboard);
     connect(_importStillImageAction, &QAction::triggered, parent, &BlitApp::showImportStillImage);
     connect(_exportSpritesheetAction, &QAction::triggered, parent, &BlitApp::showExportSpritesheet);
     connect(_exportStillImageAction, &QAction::triggered, parent, &BlitApp::showExportStillImage);
@@ -130,6 +163,7 @@ MenuBar::MenuBar(BlitApp *parent, QList<QDockWidget *> &docks) :
 void MenuBar::onAnimLoaded(Animation *anim) {
     // Add all menus
     addMenu(_fileMenu);
+    addMenu(_editMenu);
     addMenu(_animMenu);
     addMenu(_canvasMenu);
     addMenu(_viewMenu);
@@ -38,6 +38,7 @@ private slots:
 private:
     // GUI stuff
     QMenu *_fileMenu;
+    QMenu *_editMenu;
     QMenu *_importMenu;
     QMenu *_exportMenu;
     QMenu *_animMenu;
@@ -49,12 +50,18 @@ private:
     QAction *_openAnimAction;
     QAction *_saveAsAction;
     QAction *_quitAppAction;
+    QAction *_undoAction;
+    QAction *_redoAction;
+    QAction *_deselectAction;
     QAction *_animPropsAction;
     QAction *_importStillImageAction;
     QAction *_exportSpritesheetAction;
     QAction *_exportStillImageAction;
     QAction *_showGridAction;
+    QAction *_rasterModeAction;
     QAction *_setBackdropAction;
+    QAction *_setBackdropImageAction;
+    QAction *_setBackdropCheckerboardAction;
     QAction *_aboutBlitAction;
 
 
@@ -17,7 +17,7 @@
 
 //#include <QDebug>
 #include "widgets/timeline/bracketmarker.h"
-#include "widgets/timeline/tick.h"
+#include "widgets/timeline/tickstrip.h"
 #include "widgets/timeline/ruler.h"
 #include "widgets/timeline/timeline.h"
 #include "blitapp.h"
@@ -45,20 +45,10 @@ BracketMarker::BracketMarker(Timeline *timeline, BracketMarkerType bmType, QGrap
     Q_ASSERT(_timeline != NULL);
 
     // Setup the dimmer
-    int seqLength = BlitApp::app()->xsheet()->seqLength();
     _dimmer = new QGraphicsRectItem(this);
     _dimmer->setPen(Qt::NoPen);
     _dimmer->setBrush(QColor(0xA0, 0xA0, 0xA0, 0xD0));        // Transparent
-
-    // Change the rectangle based upon if it's the left or right bracket
-    if (_type == BracketMarkerType::LEFT) {
-        qreal width = TICK_WIDTH * 1;
-        _dimmer->setPos(-width, 0);
-        _dimmer->setRect(-width, RULER_HEIGHT, width, TICK_HEIGHT);
-    } else if (_type == BracketMarkerType::RIGHT) {
-        _dimmer->setPos(boundingRect().width() * 2, RULER_HEIGHT);
-        _dimmer->setRect(0, 0, (seqLength - 1) * TICK_WIDTH, TICK_HEIGHT);
-    }
+    updateDimmer();
 //    _dimmer->hide();                                    // Hidden by default
 
     qDebug() << "[BracketMarker created] " << this << " type=" << typeStr(_type);
@@ -143,7 +133,7 @@ int BracketMarker::type() const {
     a postive number.
 */
 int BracketMarker::seqNumOver() {
-    return ((int)(x() / TICK_WIDTH)) + 1;
+    return _timeline->seqNumAt(x());
 }
 
 
@@ -155,10 +145,8 @@ int BracketMarker::seqNumOver() {
 */
 void BracketMarker::moveToSeqNum(int seqNum) {
     // move ourselves
-    seqNum -= 1;
-    if (seqNum >= 0) {
-        setX(seqNum * TICK_WIDTH);
-        seqNum += 1;
+    if (seqNum >= 1) {
+        setX(_timeline->xAt(seqNum));
         emit seqNumOverChanged(seqNum);
     }
 
@@ -169,22 +157,35 @@ void BracketMarker::moveToSeqNum(int seqNum) {
         //  Move the right one with it (if it's farther)
         if (!rightBM->moving() && (seqNum > _rightStartSeqNum))
             rightBM->moveToSeqNum(seqNum);
-
-        // Dimmer
-        qreal width = TICK_WIDTH * seqNum;
-        _dimmer->setPos(0, 0);
-        _dimmer->setRect(-width, RULER_HEIGHT, width, TICK_HEIGHT);
     } else if (_type == BracketMarkerType::RIGHT) {
         //  Move the left one with it (if it's farther)
         if (!leftBM->moving() && (seqNum < _leftStartSeqNum))
             leftBM->moveToSeqNum(seqNum);
+    }
+
+    updateDimmer();
+}
+
 
-        // Dimmer
+/*!
+    Sizes the dimmer to cover everything before (or after) the sequence number the marker is
+    over.  The Timeline calls this when it's zoomed.
+*/
+void BracketMarker::updateDimmer() {
+    int seqNum = seqNumOver();
+    qreal w = _timeline->tickWidth();
+    qreal height = _timeline->tickStrip()->boundingRect().height();        // All planes, and the thumbnails
+
+    if (_type == BracketMarkerType::LEFT) {
+        qreal width = w * seqNum;
+        _dimmer->setPos(0, 0);
+        _dimmer->setRect(-width, RULER_HEIGHT, width, height);
+    } else if (_type == BracketMarkerType::RIGHT) {
         int seqLength = BlitApp::app()->xsheet()->seqLength();
-        _dimmer->setPos(boundingRect().width() * 2, RULER_HEIGHT);
-        _dimmer->setRect(0, 0, (seqLength - seqNum) * TICK_WIDTH, TICK_HEIGHT);
+        _dimmer->setPos(w, RULER_HEIGHT);
+        _dimmer->setRect(0, 0, qMax(seqLength - seqNum, 0) * w, height);
     }
-} 
+}
 
 
 /*!
@@ -242,14 +243,14 @@ void BracketMarker::mouseMoveEvent(QGraphicsSceneMouseEvent *event) {
 
         // Bounds Checking (For XSheet)
         int seqLength = BlitApp::app()->xsheet()->seqLength();
-        int maxX = (seqLength - 1) * TICK_WIDTH;
+        qreal maxX = _timeline->xAt(seqLength);
         if (newPos.x() < 0)
             newPos.setX(0);
         else if (newPos.x() > maxX)
             newPos.setX(maxX);
 
         // I like to move it move it
-        moveToSeqNum((newPos.x() / TICK_WIDTH) + 1);
+        moveToSeqNum(_timeline->seqNumAt(newPos.x()));
 
         qDebug() << "[BracketMarker mouseMoveEvent] type=" << typeStr(_type);
     }
@@ -284,7 +285,7 @@ QString BracketMarker::typeStr(BracketMarkerType type) {
 void BracketMarker::onXSheetSeqLengthChanged(int seqLength) {
     if (seqLength < seqNumOver())
         moveToSeqNum(seqLength);
-    
-    _dimmer->setRect(0, 0, (seqLength - seqNumOver()) * TICK_WIDTH, TICK_HEIGHT);
+
+    updateDimmer();
 }
 
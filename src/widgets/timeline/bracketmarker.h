@@ -34,6 +34,7 @@ public:
     // Sequence number stuff
     int seqNumOver();
     void moveToSeqNum(int seqNum);
+    void updateDimmer();
 
     // Actions
     void mousePressEvent(QGraphicsSceneMouseEvent *event);
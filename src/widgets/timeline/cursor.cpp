@@ -5,7 +5,8 @@
 
 
 #include "widgets/timeline/cursor.h"
-#include "widgets/timeline/tick.h"
+#include "widgets/timeline/tickstrip.h"
+#include "widgets/timeline/timeline.h"
 #include "widgets/timeline/ruler.h"
 #include "animation/timedframe.h"
 #include "animation/xsheet.h"
@@ -13,7 +14,6 @@
 #include <QPointF>
 #include <QRectF>
 #include <QPolygonF>
-#include <QList>
 #include <QPainter>
 #include <QPen>
 #include <QGraphicsLineItem>
@@ -21,9 +21,12 @@
 
 
 
-Cursor::Cursor(QGraphicsItem *parent) :
-    QGraphicsObject(parent)
+Cursor::Cursor(Timeline *timeline, QGraphicsItem *parent) :
+    QGraphicsObject(parent),
+    _timeline(timeline)
 {
+    Q_ASSERT(timeline != NULL);
+
     // Staring position is assmed to be the first frame
     setPos(0, 0);
 
@@ -84,15 +87,12 @@ void Cursor::mouseMoveEvent(QGraphicsSceneMouseEvent *event) {
     //   - If the _scrubbing variable is set, then well... scrub
     if (_scrubbing) {
         // Move everything to the postion of the mouse cursor.
-
-        Tick *t = getTickOver();
-
         // Move the cursor
         QPointF newPos(event->scenePos());
         newPos.setY(0);
 
         // Bounds checking
-        int maxX = BlitApp::app()->xsheet()->seqLength() * TICK_WIDTH;
+        qreal maxX = _timeline->xAt(BlitApp::app()->xsheet()->seqLength() + 1);
         if (newPos.x() < 0)
             newPos.setX(0);
         else if (newPos.x() > maxX)
@@ -102,14 +102,15 @@ void Cursor::mouseMoveEvent(QGraphicsSceneMouseEvent *event) {
         setPos(newPos);
 
         // Failsafe
-        if (!t)
+        TimedFrame *tf = timedFrameOver();
+        if (!tf)
             return;
 
-        // Have the tic, move onto it
-        if (t != _curTick) {
-            _curTick = t;
-            t->select();
-            emit overNewTick(t);
+        // Have the tick, move onto it
+        if (tf != _curTF) {
+            _curTF = tf;
+            _timeline->selectTickByTimedFrame(tf);
+            emit overNewTick(tf);
         }
 
         // And update the postion
@@ -121,68 +122,62 @@ void Cursor::mouseMoveEvent(QGraphicsSceneMouseEvent *event) {
 
 int Cursor::seqNumOver() {
     // Looks at the current position of the cursor and then returns a sequence number for that position
-    return ((int)(x() / TICK_WIDTH)) + 1;
+    return _timeline->seqNumAt(x());
 }
 
 
-Tick *Cursor::getTickOver() {
-    // Returns a pointer to the tick that the cursor (the _redLine part) is currently over, if any.
-    // May return a NULL pointer.
+TimedFrame *Cursor::timedFrameOver() {
+    // Returns a pointer to the TimedFrame whose Tick the cursor is currently over, if any.  Only the
+    // plane of the current TimedFrame counts, the others are just shown along with it.  It's looked
+    // up by the sequence number, there aren't any items to collide with.  May return a NULL pointer.
     //
-    // This function does not alter the _curTick variable
-
-    // The cursor should only collide with two items (max)
-    // Get the Tick object.  (Unfortunately, the Ruler collides, but we can forget about that easily)
-    QList<QGraphicsItem *> collides = _redLine->collidingItems();
-    Tick *tick = NULL;
-    for (int c = 0; c < collides.size(); c++) {
-        // Find the Tick
-        QGraphicsItem *gi = collides[c];
-        tick = qgraphicsitem_cast<Tick *>(gi);        // Will be Tick poiner on success, NULL on failure
-        if (tick)
-            break;
-    }
+    // This function does not alter the _curTF variable
+    XSheet *xsheet = BlitApp::app()->xsheet();
+    if (!xsheet)
+        return NULL;
+
+    TimedFrame *curTF = BlitApp::app()->curTimedFrame();
+    int plane = curTF ? curTF->plane() : 0;
+    return xsheet->frameAtSeq(seqNumOver(), plane);
+}
 
-    return tick;
+
+/*!
+    Sets how far down the red line goes, so it can cover all of the planes.
+*/
+void Cursor::setLineHeight(qreal height) {
+    _redLine->setLine(0, 1, 0, height);
 }
 
 
-void Cursor::onTickSelected() {
-    // Called when a Tick has been selected, it will move the cursor to that Tick/Frame
-    Tick *t = qobject_cast<Tick *>(sender());
+void Cursor::onTickSelected(TimedFrame *tf) {
+    // Called when a Tick has been selected (Timeline::tickSelected()), it will move the cursor to that
+    // Tick/Frame
 
     // Check to be apathetic
-    if (t == getTickOver())
+    if (tf == timedFrameOver())
         return;
 
-    if (t != _curTick) {
-        moveToTick(t);
-        _curTick = t;
+    if (tf != _curTF) {
+        moveToTimedFrame(tf);
+        _curTF = tf;
     }
 }
 
 
-void Cursor::moveToTick(Tick *tick) {
-    // Calls the funciton moveToFrame.  Is used when a Tick has been selected.  It doesn't select
-    // the tick setself
-    moveToTimedFrame(tick->timedFrame());
-}
-
-
 void Cursor::moveToTimedFrame(TimedFrame *tf) {
     // Moves the cursor to the Tick representing the supplied frame.  Only will work when not already
     // scrubbing through the Timeline.  Doesn't not select the Tick/Frame itself
     if (!_scrubbing)
-        setX((tf->seqNum() - 1) * TICK_WIDTH);
+        setX(_timeline->xAt(tf->seqNum()));
 }
 
 
 void Cursor::moveToSeqNum(int seqNum) {
     // Will move the cursor to a supplied sequence number.  seqNum must be a non-negative integer, if
     // isn't nothing will happen.  Will not select tick/frame
-    seqNum -= 1;
-    if (seqNum >= 0)
-        setX(seqNum * TICK_WIDTH);
+    if (seqNum >= 1)
+        setX(_timeline->xAt(seqNum));
     
     BlitApp::app()->setCurSeqNum(seqNumOver());
 } 
@@ -13,8 +13,9 @@
 
 
 #include <QGraphicsObject>
+#include <QPointer>
 class TimedFrame;
-class Tick;
+class Timeline;
 class QPainter;
 class QGraphicsLineItem;
 
@@ -25,7 +26,7 @@ class Cursor : public QGraphicsObject {
 public:
     enum { Type = UserType + CURSOR_TYPE };
 
-    Cursor(QGraphicsItem *parent=NULL);
+    Cursor(Timeline *timeline, QGraphicsItem *parent=NULL);
 
     // Virtuals that need to be implemented
     QRectF boundingRect() const;
@@ -39,26 +40,27 @@ public:
 
     // Accessors
     int seqNumOver();
-    Tick *getTickOver();
+    TimedFrame *timedFrameOver();
+    void setLineHeight(qreal height);
 
 
 public slots:
-    void onTickSelected();
-    void moveToTick(Tick *tick);                // Will not select Tick
+    void onTickSelected(TimedFrame *tf);
     void moveToTimedFrame(TimedFrame *tf);        // Will not select Tick
     void moveToSeqNum(int seqNum);                // Will not select Tick
 
 
 signals:
-    void overNewTick(Tick *tick);        // When the cursor is moved over a differnt/new Tick, it will emit its frame
+    void overNewTick(TimedFrame *tf);        // When the cursor is moved over a differnt/new Tick, it will emit its frame
      
 
 private:
     // Member vars
+    QPointer<Timeline> _timeline;        // Pointer to the parent Timeline widget
     bool _scrubbing = false;            // Are we currently moving the cursor?
     QPolygonF _shape;                    // Shape of the cursor
     QGraphicsLineItem *_redLine;        // Pointer to the a line that appears below the cursor
-    Tick *_curTick = NULL;                // Pointer to the Tick that is currently under the cursor (can be NULL)
+    QPointer<TimedFrame> _curTF;        // TimedFrame of the Tick that is currently under the cursor (can be NULL)
 
 
 };
@@ -4,7 +4,9 @@
 
 
 #include "widgets/timeline/ruler.h"
-#include "widgets/timeline/tick.h"
+#include "widgets/timeline/tickstrip.h"
+#include "widgets/timeline/timeline.h"
+#include <QtCore/qmath.h>
 #include <QString>
 #include <QPointF>
 #include <QSizeF>
@@ -13,13 +15,19 @@
 #include <QStaticText>
 #include <QPainter>
 #include <QLinearGradient>
+#include <QStyleOptionGraphicsItem>
 
 
-Ruler::Ruler(int length, int step, QGraphicsItem *parent) :
-    QGraphicsObject(parent)
+Ruler::Ruler(Timeline *timeline, int length, int step, QGraphicsItem *parent) :
+    QGraphicsObject(parent),
+    _timeline(timeline)
 {
     // Simple constructor, make sure to provide a non-negative length and a step value that is a positive
-    // integer, else it will be set to 1
+    // integer, else it will be set to 1.  timeline can't be NULL
+    Q_ASSERT(timeline != NULL);
+
+    // Only the exposed part is drawn (the sheet could be very long)
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
 
     // If the step provided is less th
     setStep(step);
@@ -28,7 +36,14 @@ Ruler::Ruler(int length, int step, QGraphicsItem *parent) :
 
 
 void Ruler::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
-    // Paints the object, overriden
+    // Paints the object, overriden.  Only what's in the exposed area is drawn, and the markings and
+    // numbers are spaced out more when zoomed out (see labelStep())
+    QRectF exposed = option->exposedRect & boundingRect();
+    qreal w = _timeline->tickWidth();
+    int labels = labelStep();
+    int marks = (w >= RULER_MIN_MARK_SPACING) ? 1 : qMax(labels / RULER_DEFAULT_STEP, 1);
+    if ((marks * w) < RULER_MIN_MARK_SPACING)
+        marks = labels;
 
     // Make the gradient background
     QLinearGradient grad(QPointF(0, 0), QPointF(0, RULER_HEIGHT));
@@ -37,34 +52,45 @@ void Ruler::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWi
 
     // Fill the background
     painter->setPen(Qt::NoPen);
-    painter->fillRect(boundingRect(), grad);
+    painter->fillRect(exposed, grad);
 
-    // The ticks
+    // The ticks (a marking at the start of a sequence number)
+    int first = qMax(((_timeline->seqNumAt(exposed.left()) - 1) / marks) * marks, 0);
     painter->setPen(Qt::darkGray);
-    for (int x = 0; x < ((_length + 1) * TICK_WIDTH); x += TICK_WIDTH)
-        painter->drawLine(x, RULER_HEIGHT - 10, x, RULER_HEIGHT - 1);
+    for (int n = first; n <= _length; n += marks) {
+        qreal x = n * w;
+        if (x > exposed.right())
+            break;
+        painter->drawLine(QPointF(x, RULER_HEIGHT - 10), QPointF(x, RULER_HEIGHT - 1));
+    }
 
-    // The numbers
+    // The numbers (starting a label to the left, since it could hang over into the exposed area)
     QFont numFont(painter->font());
     numFont.setPointSize(6);
     painter->setFont(numFont);
     painter->setPen(Qt::black);
-    for (int n = _step; n < (_length + 1); n += _step) {
-        QPointF topLeft((n - 1) * TICK_WIDTH, RULER_HEIGHT - 15);
+    first = qMax(((_timeline->seqNumAt(exposed.left() - RULER_MIN_LABEL_SPACING) / labels) * labels), labels);
+    for (int n = first; n < (_length + 1); n += labels) {
+        QPointF topLeft(_timeline->xAt(n), RULER_HEIGHT - 15);
+        if (topLeft.x() > exposed.right())
+            break;
+
         topLeft.rx() += 2;
         painter->drawStaticText(topLeft, QStaticText(QString::number(n)));
     }
 
     // And then draw the first number too
-    QPointF topLeft(0, RULER_HEIGHT - 15);
-    topLeft.rx() += 2;
-    painter->drawStaticText(topLeft, QStaticText("1"));
+    if (exposed.left() < RULER_MIN_LABEL_SPACING) {
+        QPointF topLeft(0, RULER_HEIGHT - 15);
+        topLeft.rx() += 2;
+        painter->drawStaticText(topLeft, QStaticText("1"));
+    }
 }
 
 
 QRectF Ruler::boundingRect() const {
     // Bouding rect, overriden method
-    return QRectF(0, 0, (_length * TICK_WIDTH) + 1, RULER_HEIGHT);
+    return QRectF(0, 0, _timeline->xAt(_length + 1) + 1, RULER_HEIGHT);
 //    w += 1;        // For good luck (no really, this makes it look a bit better)
 }
 
@@ -85,6 +111,26 @@ int Ruler::step() {
 }
 
 
+/*!
+    Returns how often a number is shown with the current zoom of the Timeline.  It's step() when
+    zoomed all the way in.  Zooming out grows it (1, 2, 5 times a power of ten of step()), so the
+    numbers don't run into each other.
+*/
+int Ruler::labelStep() {
+    qreal w = _timeline->tickWidth();
+    int mults[] = {1, 2, 5};
+    int base = _step;
+    int labels = _step;
+    for (int i = 0; (labels * w) < RULER_MIN_LABEL_SPACING; i++) {
+        if ((i % 3) == 2)
+            base *= 10;
+        labels = base * mults[(i + 1) % 3];
+    }
+
+    return labels;
+}
+
+
 int Ruler::length() {
     // Returns the length of the ruler set
     return _length;
@@ -118,6 +164,7 @@ void Ruler::setLength(int seqLen) {
     if (seqLen < 0)
         return;
     
+    prepareGeometryChange();            // Also if the tick width changed
     _length = seqLen;
 
     // The rest of the rect is easy
@@ -9,10 +9,14 @@
 
 #define RULER_HEIGHT 20
 #define RULER_DEFAULT_STEP 5
+#define RULER_MIN_LABEL_SPACING 40        // Closest (in pixels) that two numbers can be
+#define RULER_MIN_MARK_SPACING 3        // Closest (in pixels) that two markings can be
 #define RULER_TYPE 2
 
 
 #include <QGraphicsObject>
+#include <QPointer>
+class Timeline;
 
 
 class Ruler : public QGraphicsObject {
@@ -21,7 +25,7 @@ class Ruler : public QGraphicsObject {
 public:
     enum { Type = UserType + RULER_TYPE };
 
-    Ruler(int length, int step=RULER_DEFAULT_STEP, QGraphicsItem *parent=NULL);
+    Ruler(Timeline *timeline, int length, int step=RULER_DEFAULT_STEP, QGraphicsItem *parent=NULL);
 
     // Overriden functions
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget=NULL);
@@ -30,6 +34,7 @@ public:
 
     // Accessors
     int step();
+    int labelStep();
     int length();
 
 
@@ -39,6 +44,7 @@ public slots:
 
 
 private:
+    QPointer<Timeline> _timeline;        // Pointer to the parent Timeline widget
     int _step;            // How many sequence numbers to make a marking
     int _length;        // Maximum size
 
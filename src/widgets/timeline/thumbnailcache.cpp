@@ -0,0 +1,318 @@
+// File:         thumbnailcache.cpp
+// Author:       Ben Summerton (define-private-public)
+// Description:  Source file for the ThumbnailCache class
+
+
+/*!
+    \inmodule Timeline
+    \class ThumbnailCache
+    \brief Makes small renders of Frames (in the background) for the Timeline to show.
+
+    Asking for a thumbnail() never waits.  It gives back whatever is cached (which could be
+    nothing, or an out of date one) and, if that isn't current, starts making a new one on
+    another thread.  When it's done, thumbnailChanged() is emitted, and it can be asked for
+    again.  Only one is made at a time for each Frame.
+
+    Thumbnails in memory are checked against Frame::generation(), so only the Frames that
+    have changed get redone.  They're bounded by THUMBNAIL_CACHE_LIMIT, the least recently
+    used ones get thrown out first.
+
+    There's also a cache on disk, so a long sheet doesn't have to be redone each time it's
+    opened.  The generation can't be used for that (it starts over each run), so the files
+    are named by a hash of what went into the render: the frame size, and where each Cel is,
+    and the size and modification time of the PNG that it's saved in.  A Frame that has a
+    Cel that's loaded up (and could have unsaved changes) is only kept in memory.
+
+    Since any change makes a new file, the old ones are cleaned out when the cache is made
+    (in the background), and again each time THUMBNAIL_PRUNE_AFTER bytes of new ones have
+    been saved.  Ones older than THUMBNAIL_DISK_MAX_AGE days are removed, then the oldest of
+    the rest until they fit in THUMBNAIL_DISK_LIMIT.  A file's modification time is bumped
+    each time it's read, so the ones that are still used are kept.
+*/
+
+
+#include "widgets/timeline/thumbnailcache.h"
+#include "blitapp.h"
+#include "animation/animation.h"
+#include "animation/frame.h"
+#include "animation/celref.h"
+#include "animation/cel.h"
+#include "util.h"
+#include <QtConcurrent/QtConcurrentRun>
+#include <QFutureWatcher>
+#include <QCryptographicHash>
+#include <QStandardPaths>
+#include <QStringList>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QPainter>
+#include <QDebug>
+
+
+/*!
+    Creates an empty ThumbnailCache.  The disk cache is put in the user's cache directory.
+*/
+ThumbnailCache::ThumbnailCache(QObject *parent) :
+    QObject(parent),
+    _thumbs(THUMBNAIL_CACHE_LIMIT)
+{
+    QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if (!cacheDir.isEmpty()) {
+        _dir = cacheDir + QDir::separator() + THUMBNAIL_DIR_NAME + QDir::separator();
+        QtConcurrent::run(&ThumbnailCache::_prune, _dir);
+    }
+
+    qDebug() << "[ThumbnailCache created] dir=" << _dir;
+}
+
+
+/*!
+    Deconstructor.  Jobs that are still running only have copies of what they need, so
+    they're left to finish on their own.
+*/
+ThumbnailCache::~ThumbnailCache() {
+    qDebug() << "[ThumbnailCache destroyed]";
+}
+
+
+/*!
+    Returns the thumbnail for \a frame that's in memory.  If there isn't one, or it's out of
+    date, a new one is started and thumbnailChanged() will be emitted when it's ready.  Might
+    return a null QImage.
+*/
+QImage ThumbnailCache::thumbnail(Frame *frame) {
+    if (!frame)
+        return QImage();
+
+    Thumb *thumb = _thumbs.object(frame);
+    QSize size = thumbnailSize(frame->frameSize());
+    if (!thumb || (thumb->generation != frame->generation()) || (thumb->image.size() != size))
+        _request(frame);
+
+    return thumb ? thumb->image : QImage();
+}
+
+
+/*!
+    Returns where \a frame's thumbnail is in the disk cache.  If it's not on disk, or what's
+    there is out of date, an empty string is returned.
+*/
+QString ThumbnailCache::thumbnailPath(Frame *frame) {
+    Thumb *thumb = frame ? _thumbs.object(frame) : NULL;
+    if (!thumb || (thumb->generation != frame->generation()))
+        return QString();
+
+    return thumb->path;
+}
+
+
+/*!
+    Returns how big the thumbnail of a frame that's \a frameSize will be.  They're all
+    THUMBNAIL_HEIGHT tall, keeping the aspect ratio (up to THUMBNAIL_MAX_WIDTH wide).
+*/
+QSize ThumbnailCache::thumbnailSize(QSize frameSize) {
+    if (frameSize.isEmpty())
+        return QSize();
+
+    int width = qRound((qreal)THUMBNAIL_HEIGHT * frameSize.width() / frameSize.height());
+    return QSize(qBound(1, width, THUMBNAIL_MAX_WIDTH), THUMBNAIL_HEIGHT);
+}
+
+
+/*!
+    Throws out all of the thumbnails in memory.  The ones on disk are kept.
+*/
+void ThumbnailCache::clear() {
+    _thumbs.clear();
+}
+
+
+/*!
+    Triggered when a Frame that has been thumbnailed changes.  What's cached is out of date now.
+*/
+void ThumbnailCache::_onFrameContentChanged() {
+    Frame *frame = qobject_cast<Frame *>(sender());
+    if (frame)
+        emit thumbnailChanged(frame);
+}
+
+
+/*!
+    Triggered when a Frame that has been thumbnailed is deleted.  Throws out its thumbnail.
+*/
+void ThumbnailCache::_onFrameDestroyed(QObject *obj) {
+    // Already partly destroyed, so only the pointer value can be used
+    Frame *frame = static_cast<Frame *>(obj);
+    _thumbs.remove(frame);
+    _pending.remove(frame);
+}
+
+
+/*!
+    Triggered when a Job is done, puts the thumbnail in memory.  If the Frame changed while
+    it was being made, it will be redone the next time it's asked for.
+*/
+void ThumbnailCache::_onJobFinished() {
+    QFutureWatcher<Result> *watcher = static_cast<QFutureWatcher<Result> *>(sender());
+    QPointer<Frame> frame = _jobs.take(watcher);
+    Result result = watcher->result();
+    watcher->deleteLater();
+
+    if (!frame)
+        return;
+
+    Thumb *thumb = new Thumb;
+    thumb->image = result.image;
+    thumb->path = result.path;
+    thumb->generation = _pending.take(frame);
+    _thumbs.insert(frame, thumb, qMax(thumb->image.byteCount() / 1024, 1));
+
+    // Enough new ones on disk, clean it out again
+    _saved += result.saved;
+    if (_saved >= THUMBNAIL_PRUNE_AFTER) {
+        _saved = 0;
+        QtConcurrent::run(&ThumbnailCache::_prune, _dir);
+    }
+
+    emit thumbnailChanged(frame);
+}
+
+
+/*!
+    Internal function.  Starts making a thumbnail of \a frame on another thread, unless one
+    is being made already.  What's needed from the Cels is copied, so nothing is shared with
+    the thread; loaded up images are shared implicitly, and the rest are read from their file.
+*/
+void ThumbnailCache::_request(Frame *frame) {
+    if (_pending.contains(frame))
+        return;
+
+    Job job;
+    job.frameSize = frame->frameSize();
+    job.size = thumbnailSize(job.frameSize);
+    job.dir = _dir;
+    if (job.size.isEmpty())
+        return;
+
+    // Watch it for changes
+    connect(frame, &Frame::contentChanged, this, &ThumbnailCache::_onFrameContentChanged, Qt::UniqueConnection);
+    connect(frame, &Frame::destroyed, this, &ThumbnailCache::_onFrameDestroyed, Qt::UniqueConnection);
+
+    // Need to go in the reverse order of how they appear in the list (bottom first)
+    Animation *anim = BlitApp::app()->anim();
+    QList<CelRef *> refs = frame->cels();
+    for (int i = refs.size() - 1; i >= 0; i--) {
+        Cel *cel = refs.at(i)->cel();
+        if (!cel)
+            continue;
+
+        Layer layer;
+        layer.pos = refs.at(i)->pos().toPoint();
+        layer.size = cel->size();
+
+        QStringList files = cel->fileResources();
+        if (anim && !cel->active() && (files.size() == 1))
+            layer.path = anim->resourceDir() + files.first();        // Saved when it was deactivated
+        else
+            layer.image = cel->image();
+
+        job.layers.append(layer);
+    }
+
+    _pending.insert(frame, frame->generation());
+
+    QFutureWatcher<Result> *watcher = new QFutureWatcher<Result>(this);
+    connect(watcher, &QFutureWatcher<Result>::finished, this, &ThumbnailCache::_onJobFinished);
+    _jobs.insert(watcher, frame);
+    watcher->setFuture(QtConcurrent::run(&ThumbnailCache::_run, job));
+}
+
+
+/*!
+    Internal function, runs on another thread.  Makes the thumbnail for \a job, from the disk
+    cache if it's there.  Otherwise it's rendered at the full frame size and then scaled down
+    (smoothly), and saved to the disk cache if every layer came from a file.
+*/
+ThumbnailCache::Result ThumbnailCache::_run(Job job) {
+    Result result;
+
+    // Name in the disk cache
+    bool onDisk = !job.dir.isEmpty();
+    QString desc = QString("%1x%2 %3x%4").arg(job.frameSize.width()).arg(job.frameSize.height())
+                                         .arg(job.size.width()).arg(job.size.height());
+    for (auto iter = job.layers.begin(); onDisk && (iter != job.layers.end()); iter++) {
+        QFileInfo fi(iter->path);
+        onDisk = !iter->path.isEmpty() && fi.exists();
+        desc += QString("|%1 %2,%3 %4x%5 %6 %7").arg(fi.absoluteFilePath())
+                                               .arg(iter->pos.x()).arg(iter->pos.y())
+                                               .arg(iter->size.width()).arg(iter->size.height())
+                                               .arg(fi.lastModified().toMSecsSinceEpoch()).arg(fi.size());
+    }
+
+    if (onDisk) {
+        result.path = job.dir + QCryptographicHash::hash(desc.toUtf8(), QCryptographicHash::Sha1).toHex() + ".png";
+
+        QImage cached(result.path);
+        if (cached.size() == job.size) {
+            result.image = cached.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+
+            // Still in use, so _prune() sees it as new
+            QFile file(result.path);
+            if (file.open(QIODevice::ReadWrite))
+                file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+
+            return result;
+        }
+    }
+
+    // Draw it
+    QImage full = util::mkBlankImage(job.frameSize);
+    QPainter p(&full);
+    for (auto iter = job.layers.begin(); iter != job.layers.end(); iter++) {
+        QImage image = iter->path.isEmpty() ? iter->image : QImage(iter->path);
+        if (!image.isNull())
+            p.drawImage(iter->pos, image);
+    }
+    p.end();
+
+    result.image = full.scaled(job.size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+
+    // Keep it around for next time
+    if (onDisk) {
+        if (!QDir().mkpath(job.dir) || !result.image.save(result.path)) {
+            qDebug() << "[ThumbnailCache] Error, couldn't save" << result.path;
+            result.path.clear();
+        } else
+            result.saved = QFileInfo(result.path).size();
+    }
+
+    return result;
+}
+
+
+/*!
+    Internal function, runs on another thread.  Removes the thumbnails in \a dir that are
+    past THUMBNAIL_DISK_MAX_AGE, then the oldest ones until what's left is under
+    THUMBNAIL_DISK_LIMIT.
+*/
+void ThumbnailCache::_prune(QString dir) {
+    QFileInfoList files = QDir(dir).entryInfoList(QStringList() << "*.png", QDir::Files, QDir::Time);    // Newest first
+    QDateTime cutoff = QDateTime::currentDateTime().addDays(-THUMBNAIL_DISK_MAX_AGE);
+
+    qint64 total = 0;
+    int removed = 0;
+    for (auto iter = files.begin(); iter != files.end(); iter++) {
+        total += iter->size();
+        if ((total > THUMBNAIL_DISK_LIMIT) || (iter->lastModified() < cutoff)) {
+            if (QFile::remove(iter->absoluteFilePath())) {
+                total -= iter->size();
+                removed++;
+            }
+        }
+    }
+
+    if (removed > 0)
+        qDebug() << "[ThumbnailCache _prune] removed" << removed << "old thumbnails from" << dir;
+}
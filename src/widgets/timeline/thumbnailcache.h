@@ -0,0 +1,98 @@
+// File:         thumbnailcache.h
+// Author:       Ben Summerton (define-private-public)
+// Description:  Header file for the ThumbnailCache class.
+
+
+#ifndef THUMBNAIL_CACHE_H
+#define THUMBNAIL_CACHE_H
+
+#define THUMBNAIL_HEIGHT 36                        // Width goes by the aspect ratio of the frames
+#define THUMBNAIL_MAX_WIDTH (THUMBNAIL_HEIGHT * 3)
+#define THUMBNAIL_CACHE_LIMIT (16 * 1024)        // Most memory (in KiB) the thumbnails can take up
+#define THUMBNAIL_DIR_NAME "thumbnails"
+#define THUMBNAIL_DISK_LIMIT (64 * 1024 * 1024)    // Most bytes the thumbnails on disk can take up
+#define THUMBNAIL_DISK_MAX_AGE 30                // Days a thumbnail on disk is kept for
+#define THUMBNAIL_PRUNE_AFTER (8 * 1024 * 1024)    // Bytes of new thumbnails saved before the disk cache is cleaned out again
+
+
+#include <QObject>
+#include <QPointer>
+#include <QCache>
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QString>
+#include <QPoint>
+#include <QSize>
+template <typename T> class QFutureWatcher;
+class Frame;
+
+
+class ThumbnailCache : public QObject {
+    Q_OBJECT;
+
+public:
+    ThumbnailCache(QObject *parent=NULL);
+    ~ThumbnailCache();
+
+    QImage thumbnail(Frame *frame);
+    QString thumbnailPath(Frame *frame);
+    QSize thumbnailSize(QSize frameSize);
+    void clear();
+
+
+signals:
+    void thumbnailChanged(Frame *frame);        // A new one is ready, or the old one is out of date
+
+
+private slots:
+    void _onFrameContentChanged();
+    void _onFrameDestroyed(QObject *obj);
+    void _onJobFinished();
+
+
+private:
+    // What's in the memory cache
+    struct Thumb {
+        QImage image;
+        QString path;                // Where it's in the disk cache, empty if it isn't
+        quint32 generation;            // Frame::generation() it was made from
+    };
+
+    // Copy of what's needed to draw a Cel, so it can be done on another thread
+    struct Layer {
+        QImage image;                // When the Cel is loaded up (might have unsaved changes)
+        QString path;                // Otherwise, the file it's saved in
+        QPoint pos;
+        QSize size;
+    };
+
+    // One thumbnail to make
+    struct Job {
+        QSize frameSize;
+        QSize size;
+        QList<Layer> layers;        // Bottom to top
+        QString dir;                // Disk cache
+    };
+
+    // What comes back from a Job
+    struct Result {
+        QImage image;
+        QString path;
+        qint64 saved = 0;            // Bytes written to the disk cache
+    };
+
+    void _request(Frame *frame);
+    static Result _run(Job job);
+    static void _prune(QString dir);
+
+    QCache<Frame *, Thumb> _thumbs;                                // Cost is in KiB
+    QHash<Frame *, quint32> _pending;                            // Generations being made right now
+    QHash<QFutureWatcher<Result> *, QPointer<Frame>> _jobs;        // Which Frame each running Job is for
+    QString _dir;                                                // Where the disk cache is
+    qint64 _saved = 0;                                            // Bytes saved to the disk cache since it was last pruned
+
+};
+
+
+#endif // THUMBNAIL_CACHE_H
@@ -0,0 +1,484 @@
+// File:         tickstrip.cpp
+// Author:       Ben Summerton (define-private-public)
+// Description:  Source implementation for TickStrip Class
+
+
+/*!
+    \inmodule Timeline
+    \class TickStrip
+    \brief Draws the Ticks of every plane in the Timeline, but only the ones on screen.
+
+    Sheets can get long (tens of thousands of frames), so making a QGraphicsItem for each
+    TimedFrame makes opening and scrolling the Timeline slow.  Instead, the TickStrip is one
+    item that paints the exposed area procedurally.  The first TimedFrame on screen is found
+    with XSheet::frameAtSeq(), and then it walks along the plane until it goes off screen.
+
+    When the Timeline is zoomed out so far that a tick is narrower than TICK_MIN_DETAIL_WIDTH,
+    an overview is drawn instead.  Frames that would land on the same pixel column are skipped
+    over, so it's never more work than the width of the screen.
+
+    Hit testing is just arithmetic on the sequence number, see timedFrameAt().
+
+    When thumbnails are turned on (Timeline::showThumbnails()), a row of them goes above the
+    Ticks.  It's split into slots as wide as a thumbnail, and each one shows the Frame (of the
+    current plane) that's at its left edge.  So it's never more thumbnails than fit on screen,
+    no matter how zoomed out it is.  They come from the Timeline's ThumbnailCache, and until
+    one is ready an empty box is drawn.
+
+    Hovering over a Tick (or a thumbnail) shows some info about the TimedFrame in a tooltip.
+*/
+
+
+#include "blitapp.h"
+#include "widgets/timeline/tickstrip.h"
+#include "widgets/timeline/timeline.h"
+#include "widgets/timeline/ruler.h"
+#include "animation/timedframe.h"
+#include "animation/frame.h"
+#include "animation/xsheet.h"
+#include <QtCore/qmath.h>
+#include <QSizeF>
+#include <QRectF>
+#include <QColor>
+#include <QPainter>
+#include <QPen>
+#include <QStyleOptionGraphicsItem>
+#include <QGraphicsSceneMouseEvent>
+#include <QGraphicsSceneHoverEvent>
+
+
+TickStrip::TickStrip(Timeline *timeline, QGraphicsItem *parent) :
+    QGraphicsObject(parent),
+    _timeline(timeline)
+{
+    // Main constructor, it's always assumed that the pointer to the Timeline isn't NULL
+    Q_ASSERT(timeline != NULL);
+
+    // So exposedRect is filled in for paint()
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+    setAcceptHoverEvents(true);                // For the tooltips
+
+    connect(_timeline->thumbnails(), &ThumbnailCache::thumbnailChanged, this, &TickStrip::_onThumbnailChanged);
+
+    // Rows for the planes are right under the Ruler
+    setPos(0, RULER_HEIGHT);
+    updateGeometry();
+}
+
+
+QRectF TickStrip::boundingRect() const {
+    // All of the planes, as long as the sequence (plus one for the last tick's border)
+    return QRectF(QPointF(0, 0), _size);
+}
+
+
+/*!
+    Paints the ticks that are in the exposed area, each plane gets its own row.
+*/
+void TickStrip::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    XSheet *xsheet = _timeline->xsheet();
+    if (!xsheet)
+        return;
+
+    QRectF exposed = option->exposedRect;
+    int firstPlane = qMax(planeAt(exposed.top()), 0);
+    int lastPlane = qMin(planeAt(exposed.bottom()), xsheet->numPlanes() - 1);
+    bool detailed = _timeline->tickWidth() >= TICK_MIN_DETAIL_WIDTH;
+
+    for (int plane = firstPlane; plane <= lastPlane; plane++) {
+        if (detailed)
+            _paintDetailed(painter, plane, exposed);
+        else
+            _paintOverview(painter, plane, exposed);
+    }
+
+    if (exposed.top() < ticksTop())
+        _paintThumbnails(painter, exposed);
+}
+
+
+int TickStrip::type() const {
+    // enable qgraphicsitem_cast
+    return Type;
+}
+
+
+void TickStrip::mousePressEvent(QGraphicsSceneMouseEvent *event) {
+    TimedFrame *tf = timedFrameAt(event->pos());
+    if ((event->button() == Qt::LeftButton) && tf) {
+        // For when a frame is clicked, will stop playing the animation
+        BlitApp::app()->playAnimation(false);
+        _timeline->selectTickByTimedFrame(tf);
+        _pressed = tf;
+        _firstSP = event->scenePos();
+        event->accept();
+    } else
+        event->ignore();
+}
+
+
+void TickStrip::mouseReleaseEvent(QGraphicsSceneMouseEvent *event) {
+    // Null out the first scene pos
+    _firstSP = QPointF();
+
+    if (_moving && _pressed) {
+        // For when the frame moves
+        emit doneMoving(_pressed, event);
+        event->accept();
+    }
+
+    _moving = false;
+    _pressed = NULL;
+}
+
+
+void TickStrip::mouseMoveEvent(QGraphicsSceneMouseEvent *event) {
+    if (!_pressed)
+        return;
+
+    if (!_moving && (qAbs(event->scenePos().x() - _firstSP.x()) >= _timeline->tickWidth())) {
+        // If a tick isn't currently moving and the mouse have moved at least one full tick's
+        // width (at the current zoom), start the moving process
+        _moving = true;
+    }
+
+    if (_moving)
+        emit moving(_pressed, event);
+}
+
+
+void TickStrip::hoverMoveEvent(QGraphicsSceneHoverEvent *event) {
+    // Only redo the tooltip when it's over something else
+    TimedFrame *tf = timedFrameAt(event->pos());
+    if (tf != _hovered) {
+        _hovered = tf;
+        setToolTip(_toolTip(tf));
+    }
+}
+
+
+void TickStrip::hoverLeaveEvent(QGraphicsSceneHoverEvent *event) {
+    _hovered = NULL;
+    setToolTip(QString());
+}
+
+
+/*!
+    Returns where the first plane's row starts (in item coordinates), it's under the
+    thumbnails if they're shown.
+*/
+qreal TickStrip::ticksTop() {
+    return _timeline->thumbnailsShown() ? TICK_THUMBNAIL_ROW_HEIGHT : 0;
+}
+
+
+/*!
+    Returns where \a plane's row starts (in item coordinates).
+*/
+qreal TickStrip::rowTop(int plane) {
+    return ticksTop() + (plane * TICK_HEIGHT);
+}
+
+
+/*!
+    Returns which plane's row \a y (in item coordinates) is in.  Could be outside of the
+    XSheet's planes (e.g. -1 for the thumbnails).
+*/
+int TickStrip::planeAt(qreal y) {
+    return qFloor((y - ticksTop()) / TICK_HEIGHT);
+}
+
+
+/*!
+    Returns the TimedFrame whose tick is at \a pos (in item coordinates), or NULL if there
+    isn't one there.  It's found by the sequence number, no items are looked at.  If \a pos
+    is over a thumbnail, that one's TimedFrame is given back.
+*/
+TimedFrame *TickStrip::timedFrameAt(QPointF pos) {
+    XSheet *xsheet = _timeline->xsheet();
+    if (!xsheet || (pos.x() < 0))
+        return NULL;
+
+    if (pos.y() < ticksTop()) {
+        qreal slot = _thumbnailSlotWidth();
+        if ((pos.y() < 0) || (slot <= 0))
+            return NULL;
+
+        qreal slotLeft = qFloor(pos.x() / slot) * slot;
+        return xsheet->frameAtSeq(_timeline->seqNumAt(slotLeft), _thumbnailPlane());
+    }
+
+    int plane = planeAt(pos.y());
+    if ((plane < 0) || (plane >= xsheet->numPlanes()))
+        return NULL;
+
+    return xsheet->frameAtSeq(_timeline->seqNumAt(pos.x()), plane);
+}
+
+
+/*!
+    Returns the area (in item coordinates) that \a tf's tick takes up.
+*/
+QRectF TickStrip::tickRect(TimedFrame *tf) {
+    if (!tf)
+        return QRectF();
+
+    qreal w = _timeline->tickWidth();
+    return QRectF(_timeline->xAt(tf->seqNum()), rowTop(tf->plane()), tf->hold() * w, TICK_HEIGHT);
+}
+
+
+/*!
+    Should be called when the length of the XSheet, the number of planes, the width of the
+    ticks, or if the thumbnails are shown has changed.
+*/
+void TickStrip::updateGeometry() {
+    XSheet *xsheet = _timeline->xsheet();
+    QSizeF size;
+    if (xsheet)
+        size = QSizeF(_timeline->xAt(xsheet->seqLength() + 1) + 1, rowTop(xsheet->numPlanes()));
+
+    if (size != _size) {
+        prepareGeometryChange();
+        _size = size;
+    }
+}
+
+
+/*!
+    Schedules a redraw of just \a tf's tick.
+*/
+void TickStrip::updateTick(TimedFrame *tf) {
+    if (tf)
+        update(tickRect(tf).adjusted(-1, -1, 1, 1));
+}
+
+
+/*!
+    Schedules a redraw of \a plane's row, from \a seqNum to the end.  Used when ticks have
+    moved over (e.g. a hold changed).
+*/
+void TickStrip::updateFrom(int plane, int seqNum) {
+    qreal x = _timeline->xAt(qMax(seqNum, 1));
+    update(QRectF(x - 1, rowTop(plane) - 1, _size.width() - x + 2, TICK_HEIGHT + 2));
+
+    // What the thumbnails show will have moved over too (starting with the slot x is in)
+    qreal slot = _thumbnailSlotWidth();
+    if ((plane == _thumbnailPlane()) && (slot > 0)) {
+        qreal slotLeft = qFloor(x / slot) * slot;
+        update(QRectF(slotLeft, 0, _size.width() - slotLeft, ticksTop()));
+    }
+}
+
+
+/*!
+    Schedules a redraw of all of the thumbnails.
+*/
+void TickStrip::updateThumbnails() {
+    update(QRectF(0, 0, _size.width(), ticksTop()));
+}
+
+
+/*!
+    Triggered by the ThumbnailCache when \a frame's thumbnail is ready (or is out of date).
+    The thumbnails on screen are redrawn (only the ones in the view actually are), and so is
+    the tooltip if it's for \a frame.
+*/
+void TickStrip::_onThumbnailChanged(Frame *frame) {
+    updateThumbnails();
+
+    // Tooltip that's up might need it
+    if (_hovered && (_hovered->frame() == frame))
+        setToolTip(_toolTip(_hovered));
+}
+
+
+/*!
+    Internal function.  Draws each tick of \a plane in \a exposed with a border and a key dot.
+    Will draw the tick of the current TimedFrame as selected.
+*/
+void TickStrip::_paintDetailed(QPainter *painter, int plane, const QRectF &exposed) {
+    XSheet *xsheet = _timeline->xsheet();
+    TimedFrame *cur = _timeline->highlightedTimedFrame();
+    QColor lineClr = Qt::darkGray;
+    QColor fillClr = Qt::white;
+    QColor selectedClr(0xB2, 0xE4, 0xF1);
+    double padding = (_timeline->tickWidth() / 2.0) - (TICK_KEY_SIZE / 2.0);
+    QPen pen(lineClr, 1, Qt::SolidLine, Qt::SquareCap, Qt::MiterJoin);
+
+    // Find the first one on screen, then walk until we're off of it
+    TimedFrame *tf = xsheet->frameAtSeq(_timeline->seqNumAt(qMax(exposed.left(), 0.0)), plane);
+    if (!tf)
+        return;
+
+    // Each one starts where the last one ended, so only the first needs its sequence number looked up
+    int numFrames = xsheet->numFrames(plane);
+    int seqNum = tf->seqNum();
+    for (int i = tf->index(); i < numFrames; i++) {
+        tf = xsheet->frameAt(i, plane);
+        QRectF rect(_timeline->xAt(seqNum), rowTop(plane), tf->hold() * _timeline->tickWidth(), TICK_HEIGHT);
+        if (rect.left() > exposed.right())
+            break;
+        seqNum += tf->hold();
+
+        // The tick
+        painter->setPen(pen);
+        painter->fillRect(rect, (tf == cur) ? selectedClr : fillClr);
+        painter->drawRect(rect);
+
+        // Draw the Dot
+        QRectF keyRect;
+        keyRect.setX(rect.x() + padding);
+        keyRect.setY(rect.y() + TICK_HEIGHT - TICK_KEY_SIZE - padding);
+        keyRect.setSize(QSizeF(TICK_KEY_SIZE, TICK_KEY_SIZE));
+        painter->setPen(Qt::NoPen);
+        painter->fillRect(keyRect, Qt::black);
+    }
+}
+
+
+/*!
+    Internal function.  Draws \a plane in \a exposed when zoomed out too far to see each tick.
+    The row is filled in, and there is a line where each TimedFrame starts.  If more than one
+    starts in the same pixel column, only the first one is looked at, then it jumps to the
+    frame at the next column.  The current TimedFrame is always shown, even if its tick is
+    less than a pixel wide.
+*/
+void TickStrip::_paintOverview(QPainter *painter, int plane, const QRectF &exposed) {
+    XSheet *xsheet = _timeline->xsheet();
+    TimedFrame *cur = _timeline->highlightedTimedFrame();
+    qreal top = rowTop(plane);
+    qreal planeEnd = _timeline->xAt(xsheet->planeLength(plane) + 1);
+    qreal left = qMax(exposed.left(), 0.0);
+    qreal right = qMin(exposed.right(), planeEnd);
+    if (left >= right)
+        return;
+
+    // Background of the row
+    QRectF row(left, top, right - left, TICK_HEIGHT);
+    painter->fillRect(row, Qt::white);
+
+    // A line where each frame starts (at most one per pixel column)
+    painter->setPen(QPen(Qt::darkGray, 0));
+    int numFrames = xsheet->numFrames(plane);
+    TimedFrame *tf = xsheet->frameAtSeq(_timeline->seqNumAt(left), plane);
+    int i = tf ? tf->index() : numFrames;
+    while (i < numFrames) {
+        tf = xsheet->frameAt(i, plane);
+        qreal x = _timeline->xAt(tf->seqNum());
+        if (x > right)
+            break;
+
+        painter->drawLine(QPointF(x, top), QPointF(x, top + TICK_HEIGHT));
+
+        // Skip to what's at the next pixel column over
+        TimedFrame *next = xsheet->frameAtSeq(_timeline->seqNumAt(qFloor(x) + 1), plane);
+        if (!next)
+            break;
+        i = qMax(i + 1, next->index());
+    }
+
+    // Top and bottom of the row
+    painter->drawLine(QPointF(left, top), QPointF(right, top));
+    painter->drawLine(QPointF(left, top + TICK_HEIGHT), QPointF(right, top + TICK_HEIGHT));
+
+    // Current frame, at least a pixel wide
+    if (cur && (cur->plane() == plane)) {
+        QRectF rect = tickRect(cur);
+        rect.setWidth(qMax(rect.width(), 1.0));
+        painter->fillRect(rect & row, QColor(0x40, 0x9C, 0xC8));
+    }
+}
+
+
+/*!
+    Internal function.  Draws the thumbnails that are in \a exposed.  Each slot shows the
+    Frame that's at its left edge; if its thumbnail isn't ready yet, only the box is drawn.
+    The slot of the current TimedFrame is outlined.
+*/
+void TickStrip::_paintThumbnails(QPainter *painter, const QRectF &exposed) {
+    XSheet *xsheet = _timeline->xsheet();
+    ThumbnailCache *thumbnails = _timeline->thumbnails();
+    TimedFrame *cur = _timeline->highlightedTimedFrame();
+    int plane = _thumbnailPlane();
+    qreal slot = _thumbnailSlotWidth();
+    if (slot <= 0)
+        return;
+
+    // Background of the row
+    QRectF row(0, 0, _size.width(), ticksTop());
+    painter->fillRect(row & exposed, QColor(0xE0, 0xE0, 0xE0));
+
+    // Only the slots that are on screen, up to the end of the plane
+    qreal planeEnd = _timeline->xAt(xsheet->planeLength(plane) + 1);
+    int first = qFloor(qMax(exposed.left(), 0.0) / slot);
+    int last = qFloor(qMin(exposed.right(), planeEnd - 1) / slot);
+    QPen pen(Qt::darkGray, 0);
+    QPen curPen(QColor(0x40, 0x9C, 0xC8), 2);
+
+    for (int i = first; i <= last; i++) {
+        TimedFrame *tf = xsheet->frameAtSeq(_timeline->seqNumAt(i * slot), plane);
+        if (!tf)
+            break;
+
+        QRectF box((i * slot) + TICK_THUMBNAIL_PADDING, TICK_THUMBNAIL_PADDING,
+                   slot - (2 * TICK_THUMBNAIL_PADDING), THUMBNAIL_HEIGHT);
+        painter->fillRect(box, Qt::white);
+
+        QImage image = thumbnails->thumbnail(tf->frame());
+        if (!image.isNull())
+            painter->drawImage(box.topLeft(), image);
+
+        painter->setPen((tf == cur) ? curPen : pen);
+        painter->drawRect(box);
+    }
+}
+
+
+/*!
+    Internal function.  Returns which plane the thumbnails are for, the current TimedFrame's.
+*/
+int TickStrip::_thumbnailPlane() {
+    TimedFrame *cur = _timeline->curTimedFrame();
+    return cur ? cur->plane() : 0;
+}
+
+
+/*!
+    Internal function.  Returns how wide each thumbnail's slot is, zero if they aren't shown.
+*/
+qreal TickStrip::_thumbnailSlotWidth() {
+    if (!_timeline->thumbnailsShown())
+        return 0;
+
+    QSize size = _timeline->thumbnails()->thumbnailSize(BlitApp::app()->frameSize());
+    return size.isEmpty() ? 0 : size.width() + (2 * TICK_THUMBNAIL_PADDING);
+}
+
+
+/*!
+    Internal function.  Returns the tooltip for \a tf's Tick.  If its thumbnail is in the disk
+    cache, that's shown too.
+*/
+QString TickStrip::_toolTip(TimedFrame *tf) {
+    if (!tf)
+        return QString();
+
+    Frame *frame = tf->frame();
+    ThumbnailCache *thumbnails = _timeline->thumbnails();
+    thumbnails->thumbnail(frame);            // So there might be one next time
+
+    int seqNum = tf->seqNum();
+    QString info = QString("<b>%1</b><br>Sequence: %2 - %3<br>Hold: %4<br>Plane: %5<br>Cels: %6")
+                       .arg(frame->name().toHtmlEscaped())
+                       .arg(seqNum).arg(seqNum + tf->hold() - 1)
+                       .arg(tf->hold())
+                       .arg(tf->plane() + 1)
+                       .arg(frame->numCels());
+
+    QString path = thumbnails->thumbnailPath(frame);
+    if (!path.isEmpty())
+        info = QString("<img src=\"%1\"><br>").arg(path.toHtmlEscaped()) + info;
+
+    return info;
+}
@@ -0,0 +1,96 @@
+// File:         tickstrip.h
+// Author:       Ben Summerton (define-private-public)
+// Description:  A TickStrip draws all of the Ticks (the graphical representation of a TimedFrame) in the
+//               Timeline widget, a row of them for each plane of the XSheet.  It doesn't modify any of
+//               the TimedFrames, it just draws them and tells the Timeline what was clicked on.
+//
+//               There isn't an item for each TimedFrame.  Only the part of the strip that's on screen
+//               is drawn, and what's under the mouse is figured out from the sequence number.
+//
+//               Thumbnails of the current plane's Frames can be shown in a row above the Ticks.
+
+
+#ifndef TICK_STRIP_H
+#define TICK_STRIP_H
+
+
+#define TICK_WIDTH 14                    // At full detail, see Timeline::tickWidth()
+#define TICK_HEIGHT 28
+#define TICK_KEY_SIZE 6
+#define TICK_MIN_DETAIL_WIDTH 6            // Narrower than this and only the overview is drawn
+#define TICK_THUMBNAIL_PADDING 2
+#define TICK_THUMBNAIL_ROW_HEIGHT (THUMBNAIL_HEIGHT + (2 * TICK_THUMBNAIL_PADDING))
+#define TICK_STRIP_TYPE 1
+
+
+#include "widgets/timeline/thumbnailcache.h"
+#include <QGraphicsObject>
+#include <QPointer>
+#include <QPointF>
+class TimedFrame;
+class Frame;
+class Timeline;
+
+
+class TickStrip : public QGraphicsObject {
+    Q_OBJECT;
+
+public:
+    enum { Type = UserType + TICK_STRIP_TYPE };
+
+    // Constructors
+    TickStrip(Timeline *timeline, QGraphicsItem *parent=NULL);
+
+    // Overridden Functions
+    QRectF boundingRect() const;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget=NULL);
+    int type() const;
+
+    void mousePressEvent(QGraphicsSceneMouseEvent *event);
+    void mouseReleaseEvent(QGraphicsSceneMouseEvent *event);
+    void mouseMoveEvent(QGraphicsSceneMouseEvent *event);
+    void hoverMoveEvent(QGraphicsSceneHoverEvent *event);
+    void hoverLeaveEvent(QGraphicsSceneHoverEvent *event);
+
+    // Hit testing & geometry
+    qreal ticksTop();
+    qreal rowTop(int plane);
+    int planeAt(qreal y);
+    TimedFrame *timedFrameAt(QPointF pos);
+    QRectF tickRect(TimedFrame *tf);
+    void updateGeometry();
+    void updateTick(TimedFrame *tf);
+    void updateFrom(int plane, int seqNum);
+    void updateThumbnails();
+
+
+signals:
+    void moving(TimedFrame *tf, QGraphicsSceneMouseEvent *event);        // Used for when a tick is being moved
+    void doneMoving(TimedFrame *tf, QGraphicsSceneMouseEvent *event);    // Used for when a tick is done being moved
+
+
+private slots:
+    void _onThumbnailChanged(Frame *frame);
+
+
+private:
+    void _paintDetailed(QPainter *painter, int plane, const QRectF &exposed);
+    void _paintOverview(QPainter *painter, int plane, const QRectF &exposed);
+    void _paintThumbnails(QPainter *painter, const QRectF &exposed);
+    int _thumbnailPlane();
+    qreal _thumbnailSlotWidth();
+    QString _toolTip(TimedFrame *tf);
+
+    // Member vars
+    QPointer<Timeline> _timeline;        // Pointer to the parent Timeline widget
+    QSizeF _size;                        // Size of the strip, all of the planes at the current tick width
+    QPointer<TimedFrame> _pressed;        // TimedFrame that the mouse was pressed on (can be NULL)
+    bool _moving = false;                // Flag for if a tick is currently being moved
+    QPointF _firstSP;                    // Used for moving a tick
+    QPointer<TimedFrame> _hovered;        // What the tooltip is for
+
+};
+
+
+#endif // TICK_STRIP_H
+
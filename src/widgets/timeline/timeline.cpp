@@ -4,23 +4,29 @@
 
 
 #include "widgets/timeline/timeline.h"
-#include "widgets/timeline/tick.h"
+#include "widgets/timeline/tickstrip.h"
+#include "widgets/timeline/thumbnailcache.h"
 #include "widgets/timeline/ruler.h"
 #include "widgets/timeline/cursor.h"
 #include "widgets/timeline/trianglemarker.h"
 #include "widgets/timeline/bracketmarker.h"
 #include "animation/xsheet.h"
 #include "animation/timedframe.h"
+#include "blitapp.h"
+#include <QtCore/qmath.h>
 #include <QFrame>
+#include <QScrollBar>
 #include <QGraphicsScene>
 #include <QGraphicsView>
 #include <QGraphicsSceneMouseEvent>
+#include <QWheelEvent>
 #include <QHBoxLayout>
 #include <QDebug>
 
 
 Timeline::Timeline(QWidget *parent) :
-    QWidget(parent)
+    QWidget(parent),
+    _tickWidth(TICK_WIDTH)
 {
     // Widgets and layout
     QHBoxLayout *layout = new QHBoxLayout(this);
@@ -35,8 +41,11 @@ Timeline::Timeline(QWidget *parent) :
     _view->setFrameShape(QFrame::NoFrame);
     _view->setAlignment(Qt::AlignLeft | Qt::AlignTop);
     _view->setSceneRect(0, 0, _scene->width(), TIMELINE_HEIGHT);
+    _view->viewport()->installEventFilter(this);        // Ctrl + Wheel zooms
     layout->addWidget(_view);
 
+    _thumbnails = new ThumbnailCache(this);
+
     // Lastly, set the XSheet, which should take care of everything else
 //    setXSheet(xsheet);
 }
@@ -55,10 +64,9 @@ void Timeline::setXSheet(XSheet *xsheet) {
     // XSheet will also reset the Timeline.
 
     // First clear out the old stuff
-    _scene->clear();            // Will delete all of the items  (Including cursor, ruler, and trimarker)
-    _ticks.clear();                // Clear out the list
-    _tickMap.clear();            // Clear out the map
-    curTick = NULL;                // Reset the pointer
+    _scene->clear();            // Will delete all of the items  (Including ticks, cursor, ruler, and trimarker)
+    _curTF = NULL;                // Reset the pointers
+    _highlightTF = NULL;
 
     // Change the XSheet, and disconnect some old signals
     if (_xsheet) {
@@ -81,6 +89,7 @@ void Timeline::setXSheet(XSheet *xsheet) {
 
     // Check for set XSheet
     if (!_xsheet) {
+        _tickStrip = NULL;
         _ruler = NULL;
         _cursor = NULL;
         _triMarker = NULL;
@@ -89,16 +98,19 @@ void Timeline::setXSheet(XSheet *xsheet) {
         return;
     }
 
-    // Make the ruler, cursor, and tri-marker
-    _ruler = new Ruler(_xsheet->seqLength());
+    // Make the ticks, ruler, cursor, and tri-marker
+    _tickStrip = new TickStrip(this);
+    _tickStrip->setZValue(0);
+
+    _ruler = new Ruler(this, _xsheet->seqLength());
     _ruler->setZValue(1);
     _ruler->setVisible(!_xsheet.isNull());
 
-    _cursor = new Cursor();
+    _cursor = new Cursor(this);
     _cursor->setZValue(2);
     _cursor->setVisible(!_xsheet.isNull());
 
-    _triMarker = new TriangleMarker();
+    _triMarker = new TriangleMarker(this);
     _triMarker->setZValue(1);
     _triMarker->hide();                    // Hidden by default
 
@@ -113,25 +125,30 @@ void Timeline::setXSheet(XSheet *xsheet) {
     _rightBM->hide();                // Hidden by default
 
 
-    // Add in all of the ticks to the timeline
-    QList<QPointer<TimedFrame>> frames = _xsheet->frames();
-    for (auto fIter = frames.begin(); fIter != frames.end(); fIter++)
-        addTick(*fIter);
-
-    // Add in the cursor, ruler, and markers
+    // Add in the ticks, cursor, ruler, and markers
+    _scene->addItem(_tickStrip);
     _scene->addItem(_ruler);
     _scene->addItem(_cursor);
     _scene->addItem(_triMarker);
+    _cursor->setLineHeight(_height());
     _scene->addItem(_leftBM);
     _scene->addItem(_rightBM);
 
     // Add some signals/sots
-    connect(_xsheet, &XSheet::frameAdded, this, &Timeline::addTick);
-    connect(_xsheet, &XSheet::frameRemoved, this, &Timeline::removeTickByTimedFrame);
-    connect(_xsheet, &XSheet::seqNumsChanged, this, &Timeline::updateRuler);
+    connect(_tickStrip, &TickStrip::moving, this, &Timeline::movingTick);
+    connect(_tickStrip, &TickStrip::doneMoving, this, &Timeline::doneMovingTick);
+    connect(this, &Timeline::tickSelected, _cursor, &Cursor::onTickSelected);
+    connect(_xsheet, &XSheet::frameRemoved, this, &Timeline::_onFrameRemoved);
+    connect(_xsheet, &XSheet::changesCommitted, this, &Timeline::_onChangesCommitted);
+    connect(_xsheet, &XSheet::seqNumsChanged, this, &Timeline::updateTicks);
+    connect(_xsheet, &XSheet::planeAdded, this, &Timeline::_onPlaneAdded);
     connect(_xsheet, &XSheet::frameMoved, _cursor, &Cursor::moveToTimedFrame);
     connect(_xsheet, &XSheet::seqLegnthChanged, _leftBM, &BracketMarker::onXSheetSeqLengthChanged);
     connect(_xsheet, &XSheet::seqLegnthChanged, _rightBM, &BracketMarker::onXSheetSeqLengthChanged);
+
+    // Room for all of the planes
+    updateRuler();
+    updateGeometry();
 }
 
 
@@ -142,32 +159,65 @@ XSheet *Timeline::xsheet() {
 
 
 void Timeline::selectTickByIndex(int index) {
-    // Sets off a Tick's "select()," signal via an index number.  The Index should correspond with a Tick
-    // in the _ticks list.  If supplied an invalid index, a debug message will print an nothing will happen
+    // Selects a Tick via an index number.  The Index should correspond with a TimedFrame in the
+    // current plane.  If supplied an invalid index, a debug message will print an nothing will happen
 
     // Check for set XSheet
     if (!_xsheet)
         return;
 
-    if ((index < 0) || (index >= _ticks.size())) {
+    int plane = _curTF ? _curTF->plane() : 0;
+    if ((index < 0) || (index >= _xsheet->numFrames(plane))) {
         qDebug() << "Invalid index supplied for selectTickByIndex() in Timeline; index=" << index;
         return;
     }
 
     // Else, all good!
-    _ticks[index]->select();
+    selectTickByTimedFrame(_xsheet->frameAt(index, plane));
 }
 
 
 void Timeline::selectTickByTimedFrame(TimedFrame *tf) {
-    // Selects a tick By a pointer to a Frame.  Will do nothing if the pointer to the Frame doesn't exist.
+    // Selects the Tick of a TimedFrame.  Will do nothing if it's already the selected one.  Will change
+    // the current frame and set the Canvas widget, then emits tickSelected()
 
     // Check for set XSheet
-    if (!_xsheet)
+    if (!_xsheet || !tf || (_curTF == tf))
         return;
 
-    if (_tickMap.contains(tf))
-        _tickMap[tf]->select();
+    // Swap for ourselves (first, since setting the current frame will come back here)
+    TimedFrame *old = _curTF;
+    _curTF = tf;
+
+    // Set the current Frame as well as the canvas
+    BlitApp::app()->setCurTimedFrame(tf);
+    BlitApp::app()->setCurSeqNum(tf->seqNum());
+
+    // Other signals
+    emit tickSelected(tf);
+    _tickStrip->updateTick(tf);
+    if (old)
+        _tickStrip->updateTick(old);
+    _tickStrip->updateThumbnails();                // Outline (or even the plane) might have changed
+}
+
+
+/*!
+    Draws \a tf's Tick as if it was selected, without actually selecting it.  Nothing else
+    about the current frame is changed, so this is cheap enough to call on each frame of
+    playback.  Passing NULL goes back to showing the selected Tick.
+
+    \sa selectTickByTimedFrame()
+*/
+void Timeline::highlightTickByTimedFrame(TimedFrame *tf) {
+    if (!_xsheet || (_highlightTF == tf))
+        return;
+
+    TimedFrame *old = highlightedTimedFrame();
+    _highlightTF = tf;
+    _tickStrip->updateTick(old);
+    _tickStrip->updateTick(highlightedTimedFrame());
+    _tickStrip->updateThumbnails();
 }
 
 
@@ -181,6 +231,31 @@ void Timeline::turnOnSelectivePlayback(bool enabled) {
 }
 
 
+/*!
+    Will show/hide a row of Frame thumbnails above the Ticks.  The Timeline gets taller (or
+    shorter), so whatever contains it should resize to its sizeHint().
+
+    \sa thumbnails()
+*/
+void Timeline::showThumbnails(bool show) {
+    if (_showThumbnails == show)
+        return;
+
+    _showThumbnails = show;
+    if (!_tickStrip)
+        return;
+
+    // Everything under the thumbnails moves down (or up)
+    _tickStrip->updateGeometry();
+    _tickStrip->update();
+    _cursor->setLineHeight(_height());
+    _leftBM->updateDimmer();
+    _rightBM->updateDimmer();
+    updateRuler();
+    updateGeometry();
+}
+
+
 /*!
     Returns a pointer to the Cursor widget set.  Will be NULL if there is no XSheet set.
 */
@@ -205,88 +280,164 @@ BracketMarker *Timeline::rightBM() {
 }
 
 
-QList<Tick *> Timeline::ticks() {
-    // Returns a list of pointers to the Ticks currently in the Timeline.  Should all be in order
-    return _ticks;
+/*!
+    Returns the TimedFrame whose Tick is selected.  Can be NULL.
+*/
+TimedFrame *Timeline::curTimedFrame() {
+    return _curTF;
 }
 
 
-Tick *Timeline::tickByTimedFrame(TimedFrame *tf) {
-    // Finds a Tick in the Timeline by looking for its Frame pointer.  If it's not found, then a NULL
-    // pointer will be returned
-    if (!_tickMap.contains(tf))
-        return NULL;
-    else
-        return _tickMap[tf];
+/*!
+    Returns the TimedFrame whose Tick is drawn as selected.  That's the one from
+    highlightTickByTimedFrame() if there is one, otherwise it's curTimedFrame().  Can be NULL.
+*/
+TimedFrame *Timeline::highlightedTimedFrame() {
+    return _highlightTF ? _highlightTF : _curTF;
 }
 
 
-void Timeline::addTick(TimedFrame *tf) {
-    // Will add a tick to the timeline.  This should be only called via the frameAdded() signal in the
-    // XSheet class, but it's being called internall when setting an XSheet.
+/*!
+    Returns the item that draws all of the Ticks.  Will be NULL if there is no XSheet set.
+*/
+TickStrip *Timeline::tickStrip() {
+    return _tickStrip;
+}
 
-    // Check for set XSheet
-    if (!_xsheet)
-        return;
 
+/*!
+    Returns the cache of Frame thumbnails that the Timeline uses.  It's always there, even if
+    the thumbnails aren't shown (e.g. the tooltips use it).
+*/
+ThumbnailCache *Timeline::thumbnails() {
+    return _thumbnails;
+}
 
-    // Make the Tick from the Frame
-    Tick *tick = new Tick(this, tf);
-    _ticks.append(tick);
-    _scene->addItem(tick);
-    _tickMap[tf] = tick;
-    
-    // Frame -> Tick
 
-    // Connect up a crapton of signals
-    // Tick -> Others
-    connect(tick, &Tick::moving, this, &Timeline::movingTick);
-    connect(tick, &Tick::doneMoving, this, &Timeline::doneMovingTick);
-    connect(tick, &Tick::selected, _cursor, &Cursor::onTickSelected);
+/*!
+    Returns true if the row of thumbnails is shown above the Ticks.
+
+    \sa showThumbnails()
+*/
+bool Timeline::thumbnailsShown() {
+    return _showThumbnails;
 }
-    
-    
-void Timeline::removeTickByTimedFrame(TimedFrame *tf) {
-    // Delete a Tick from the GraphicsScene by its Frame object (or pointer to it).  It will not delete
-    // the Frame object.  If the Frame/Tick isn't found, then nothing will happen.  This funciton will
-    // usually be called after a Frame has been removed from the XSheet any everything else has updated.
-    //
-    // This should be called by the frameRemoved() signal in XSheet
 
-    // Check for set XSheet
+
+/*!
+    Returns how wide (in scene coordinates) one sequence number is in the Timeline.  It's
+    TICK_WIDTH normally, less when zoomed out.
+
+    \sa setTickWidth()
+*/
+qreal Timeline::tickWidth() {
+    return _tickWidth;
+}
+
+
+/*!
+    Returns the sequence number that is at \a x (in scene coordinates).  Anything left of the
+    first sequence number is 1.  There's a hair of slack, so it always gives back the same
+    sequence number for an xAt() when zoomed to an uneven tick width.
+*/
+int Timeline::seqNumAt(qreal x) {
+    if (x < 0)
+        return 1;
+
+    return qFloor((x / _tickWidth) + 1e-6) + 1;
+}
+
+
+/*!
+    Returns where (in scene coordinates) \a seqNum starts.
+*/
+qreal Timeline::xAt(int seqNum) {
+    return (seqNum - 1) * _tickWidth;
+}
+
+
+/*!
+    Zooms the Timeline so that a sequence number is \a width wide.  It can't be wider than
+    TICK_WIDTH, or narrower than TIMELINE_MIN_TICK_WIDTH.  Below TICK_MIN_DETAIL_WIDTH only an
+    overview of the ticks is drawn.
+
+    The Cursor and BracketMarkers stay over the same sequence numbers.
+*/
+void Timeline::setTickWidth(qreal width) {
+    width = qBound((qreal)TIMELINE_MIN_TICK_WIDTH, width, (qreal)TICK_WIDTH);
+    if (width == _tickWidth)
+        return;
+
+    qreal factor = width / _tickWidth;
+    _tickWidth = width;
+
     if (!_xsheet)
         return;
 
+    // Keep everything over the same sequence number
+    _cursor->setX(_cursor->x() * factor);
+    _leftBM->setX(_leftBM->x() * factor);
+    _leftBM->updateDimmer();
+    _rightBM->setX(_rightBM->x() * factor);
+    _rightBM->updateDimmer();
 
-    if (_tickMap.contains(tf)) {
-        // Get rid of the Tick, don't delete yet
-        Tick *tick = _tickMap[tf];
-        _ticks.removeOne(tick);
-        _scene->removeItem(tick);
-        _tickMap.remove(tf);
+    _tickStrip->update();
+    updateRuler();                // Resizes the TickStrip too
+}
+
+
+/*!
+    Shows more detail, by TIMELINE_ZOOM_STEP.
+*/
+void Timeline::zoomIn() {
+    setTickWidth(_tickWidth * TIMELINE_ZOOM_STEP);
+}
+
+
+/*!
+    Shows more of the sheet, by TIMELINE_ZOOM_STEP.
+*/
+void Timeline::zoomOut() {
+    setTickWidth(_tickWidth / TIMELINE_ZOOM_STEP);
+}
 
-        // Now select another tick, using the old sequence number
-        TimedFrame *nextTF = _xsheet->frameAtSeq(tf->seqNum());
-        if (nextTF) 
-            _tickMap[nextTF]->select();                    // Some other Frame shares the number, select it
-        else {
-            // Okay, must have been the last frame, select the "next," last farme
-            _tickMap[_xsheet->frameAtSeq(_xsheet->seqLength())]->select();
-        }
 
-        // Disconnect signals, where the Frame is the sender (don't need to worry about Tick as sender)
-        disconnect(tf, 0, tick, 0);
+/*!
+    Zooms out (or in) so all of the sheet fits in the view, as long as that's within the
+    limits of setTickWidth().
+*/
+void Timeline::zoomToFit() {
+    if (!_xsheet || (_xsheet->seqLength() < 1))
+        return;
+
+    setTickWidth((_view->viewport()->width() - 1) / (qreal)_xsheet->seqLength());
+}
 
-        // Redraw
-        tick->update();
 
-        // Delete after
-        delete tick;
+/*!
+    Watches the view for Ctrl + Wheel, which zooms in and out around the mouse.
+*/
+bool Timeline::eventFilter(QObject *obj, QEvent *event) {
+    if ((obj == _view->viewport()) && (event->type() == QEvent::Wheel)) {
+        QWheelEvent *we = static_cast<QWheelEvent *>(event);
+        if ((we->modifiers() & Qt::ControlModifier) && _xsheet) {
+            // Keep what's under the mouse there
+            qreal seq = _view->mapToScene(we->pos()).x() / _tickWidth;
+            if (we->angleDelta().y() > 0)
+                zoomIn();
+            else if (we->angleDelta().y() < 0)
+                zoomOut();
+            _view->horizontalScrollBar()->setValue(qRound((seq * _tickWidth) - we->pos().x()));
+
+            return true;
+        }
     }
+
+    return QWidget::eventFilter(obj, event);
 }
 
 
-void Timeline::movingTick(QGraphicsSceneMouseEvent *event) {
+void Timeline::movingTick(TimedFrame *tf, QGraphicsSceneMouseEvent *event) {
     // This slot will ne called when a Tick emits its moving signal.  It will show the TriangleMarker when
     // a Tick is being moved.
 
@@ -295,14 +446,14 @@ void Timeline::movingTick(QGraphicsSceneMouseEvent *event) {
         return;
 
     Q_ASSERT(_triMarker != NULL);
-    _triMarker->moveToSeqNum(_seqNumAtEvent(event));
+    _triMarker->moveToSeqNum(_seqNumAtEvent(event, tf->plane()));
     _triMarker->show();
 }
 
 
-void Timeline::doneMovingTick(QGraphicsSceneMouseEvent *event) {
-    // This slot is called when a Tick emits its doneMoving signal.  It will hide the TriangleMarker and 
-    // possibly move a Frame/Tick in the XSheet/Timeline
+void Timeline::doneMovingTick(TimedFrame *tf, QGraphicsSceneMouseEvent *event) {
+    // This slot is called when the TickStrip emits its doneMoving signal.  It will hide the TriangleMarker
+    // and possibly move a Frame/Tick in the XSheet/Timeline
 
     // Check for set XSheet
     if (!_xsheet)
@@ -311,24 +462,24 @@ void Timeline::doneMovingTick(QGraphicsSceneMouseEvent *event) {
     Q_ASSERT(_triMarker != NULL);
     _triMarker->hide();
 
-    // Do the move
-    Tick *tick = qobject_cast<Tick *>(sender());
-    TimedFrame *tf = tick->timedFrame();
-    int seqNum = _seqNumAtEvent(event);
+    // Do the move (the frame stays in its plane)
+    int plane = tf->plane();
+    int seqNum = _seqNumAtEvent(event, plane);
 
     // Figure out which way the frame is omving
+    int planeLength = _xsheet->planeLength(plane);
     if ((seqNum != 1) && (tf->seqNum() < seqNum))
         seqNum -= 1;                            // Moving a Frame to the right
-    else if (seqNum >= _xsheet->seqLength())
-        seqNum = _xsheet->seqLength() - 1;        // Tick/ Frame should be moved to the end
+    if (seqNum >= planeLength)
+        seqNum = planeLength - 1;                // Tick/ Frame should be moved to the end
 
     // Check for a self move
     if (tf->hasSeqNum(seqNum))
         return;
     
     // Do the move
-    _xsheet->moveFrame(tf->seqNum(), seqNum);
-    tick->select();
+    _xsheet->moveFrame(tf->seqNum(), seqNum, plane);
+    selectTickByTimedFrame(tf);
 }
 
 
@@ -350,31 +501,121 @@ void Timeline::updateRuler() {
     if (_ruler->boundingRect().width() > redrawRect.width())
         redrawRect = _ruler->boundingRect();
 
+    // The ticks might need more (or less) room too
+    _tickStrip->updateGeometry();
+
     // Setup the view to only have a specific view size of the Scene
-    _view->setSceneRect(0, 0, _ruler->boundingRect().width(), TIMELINE_HEIGHT);
+    _view->setSceneRect(0, 0, _ruler->boundingRect().width(), _height());
     _scene->invalidate(_ruler->x(), _ruler->y(), redrawRect.width(), redrawRect.height());
 
 }
 
 
-int Timeline::_seqNumAtEvent(QGraphicsSceneMouseEvent *event) {
+void Timeline::updateTicks(int plane, int first, int last) {
+    // Should be called by the XSheet's seqNumsChanged() signal.  The Ticks for the TimedFrames at
+    // index [first, last] of plane have moved, so that part of the plane's row (and anything after it,
+    // since holds can shrink) is redrawn.  Then the Ruler is resized to match.
+
+    // Check for set XSheet
+    if (!_xsheet)
+        return;
+
+    Q_UNUSED(last);
+    TimedFrame *tf = _xsheet->frameAt(first, plane);
+    if (tf)
+        _tickStrip->updateFrom(plane, tf->seqNum());
+    else
+        _tickStrip->updateFrom(plane, _xsheet->planeLength(plane) + 1);
+
+    updateRuler();
+}
+
+
+void Timeline::_onFrameRemoved(TimedFrame *tf) {
+    // Called by the XSheet's frameRemoved() signal.  If it was the selected Tick, another one in the
+    // same plane gets selected.  The part of the row it was in is redrawn.
+
+    // Check for set XSheet
+    if (!_xsheet)
+        return;
+
+    int plane = tf->plane();
+    _tickStrip->updateFrom(plane, tf->seqNum());
+    _tickStrip->updateGeometry();
+
+    if (_curTF && (_curTF != tf))
+        return;
+
+    // Select another tick (in the same plane), using the old sequence number
+    _curTF = NULL;
+    TimedFrame *nextTF = _xsheet->frameAtSeq(tf->seqNum(), plane);
+    if (!nextTF) {
+        // Okay, must have been the last frame, select the "next," last farme
+        nextTF = _xsheet->frameAtSeq(_xsheet->planeLength(plane), plane);
+    }
+    selectTickByTimedFrame(nextTF);
+}
+
+
+void Timeline::_onChangesCommitted() {
+    // Called by the XSheet's changesCommitted() signal, after a batch of changes.  The Ticks have
+    // been redrawn already (seqNumsChanged()), but frameRemoved() and frameMoved() weren't sent.  So
+    // this checks if the selected Tick is still there and where it is now, all at once.
+
+    // Check for set XSheet
+    if (!_xsheet)
+        return;
+
+    if (_curTF && (_curTF->index() >= 0)) {
+        _cursor->moveToTimedFrame(_curTF);
+        return;
+    }
+
+    // Gone, select whatever is under the cursor now (in the same plane)
+    int plane = _curTF ? qBound(0, _curTF->plane(), _xsheet->numPlanes() - 1) : 0;
+    int seqNum = qBound(1, _cursor->seqNumOver(), _xsheet->planeLength(plane));
+    _curTF = NULL;
+    selectTickByTimedFrame(_xsheet->frameAtSeq(seqNum, plane));
+}
+
+
+void Timeline::_onPlaneAdded(int plane) {
+    // Called by the XSheet's planeAdded() signal.  Makes room for another row of Ticks.
+    _cursor->setLineHeight(_height());
+    updateRuler();
+    _leftBM->updateDimmer();
+    _rightBM->updateDimmer();
+    updateGeometry();
+}
+
+
+qreal Timeline::_height() {
+    // Internal function.  How tall the scene is, the Ruler plus a row of Ticks for each plane (and
+    // the thumbnails if they're shown).
+    int planes = _xsheet ? _xsheet->numPlanes() : 1;
+    qreal thumbnails = _showThumbnails ? TICK_THUMBNAIL_ROW_HEIGHT : 0;
+    return RULER_HEIGHT + thumbnails + (planes * TICK_HEIGHT);
+}
+
+
+int Timeline::_seqNumAtEvent(QGraphicsSceneMouseEvent *event, int plane) {
     // Takes in a mouse event, looks at its position, then determines an appropriate sequence number
-    // based upon the X Position.
+    // based upon the X Position.  It's snapped to the start of the frame in the plane that's under it.
 
     // Check for set XSheet
     if (!_xsheet)
         return 1;        // TODO I don't think it should be returning this at all, investigate
 
-    int x = event->scenePos().x();
+    qreal x = event->scenePos().x();
     if (x < 0)
         return 1;
     else {
-        TimedFrame *tf = _xsheet->frameAtSeq((x / TICK_WIDTH) + 1);
+        TimedFrame *tf = _xsheet->frameAtSeq(seqNumAt(x), plane);
         if (tf)
             return tf->seqNum();        // Good Frame, return its sequence number
         else {
             // Couldn't find frame, must be at the end.
-            return (_xsheet->seqLength() + 1);    // Put it at the end
+            return (_xsheet->planeLength(plane) + 1);    // Put it at the end
         }
     }
 }
@@ -4,7 +4,8 @@
 //               Have an XSheet set to it.  The XSheet could be a Null XSheet though in some cases.
 //
 //               A Bit of terminology:
-//                 Tick -- A Marking that represents an entire frame & its hold.
+//                 Tick -- A Marking that represents an entire frame & its hold.  They're all drawn by
+//                         one TickStrip, there isn't an object for each one.
 //                 Ruler -- Meausres how "long," the sequence is in terms of frame count numbers.
 //                 Cursor -- Cursor that is used to mark the current position in the timeline
 //                 TriMaker -- A small black triangle that is used as a marker when there is user
@@ -14,16 +15,18 @@
 #ifndef TIMELINE_H
 #define TIMELINE_H
 
-#define TIMELINE_HEIGHT (RULER_HEIGHT + TICK_HEIGHT)
+#define TIMELINE_HEIGHT (RULER_HEIGHT + TICK_HEIGHT)        // With only one plane
+#define TIMELINE_MIN_TICK_WIDTH 0.01                        // Most zoomed out, 100 frames to a pixel
+#define TIMELINE_ZOOM_STEP 1.25                                // How much each step of zooming changes it by
 
 
 #include <QWidget>
 #include <QPointer>
 #include <QList>
-#include <QHash>
 class TimedFrame;
 class XSheet;
-class Tick;
+class TickStrip;
+class ThumbnailCache;
 class Ruler;
 class Cursor;
 class TriangleMarker;
@@ -43,10 +46,20 @@ public:
     void setXSheet(XSheet *xsheet);
     XSheet *xsheet();
 
-    // Tick operations
-    QList<Tick *> ticks();
-    Tick *tickByTimedFrame(TimedFrame *tf);
-    
+    // Ticks
+    TimedFrame *curTimedFrame();
+    TimedFrame *highlightedTimedFrame();
+    TickStrip *tickStrip();
+
+    // Thumbnails
+    ThumbnailCache *thumbnails();
+    bool thumbnailsShown();
+
+    // Sequence number <-> scene coordinates
+    qreal tickWidth();
+    int seqNumAt(qreal x);
+    qreal xAt(int seqNum);
+
     // When we need to touch internals
     Cursor *timelineCursor();
     BracketMarker *leftBM();
@@ -54,35 +67,56 @@ public:
 
 
 public slots:
-    void addTick(TimedFrame *tf);
-    void removeTickByTimedFrame(TimedFrame *tf);
-    void movingTick(QGraphicsSceneMouseEvent *event);        // Tells a tick that its moving
-    void doneMovingTick(QGraphicsSceneMouseEvent *event);
+    void movingTick(TimedFrame *tf, QGraphicsSceneMouseEvent *event);        // Tells a tick that its moving
+    void doneMovingTick(TimedFrame *tf, QGraphicsSceneMouseEvent *event);
     void updateRuler();
+    void updateTicks(int plane, int first, int last);
 
     void selectTickByIndex(int index);        // "Selects," a Tick
     void selectTickByTimedFrame(TimedFrame *tf);
+    void highlightTickByTimedFrame(TimedFrame *tf);        // Only draws it as selected
 
     void turnOnSelectivePlayback(bool enabled);
+    void showThumbnails(bool show);
 
+    // Zooming
+    void setTickWidth(qreal width);
+    void zoomIn();
+    void zoomOut();
+    void zoomToFit();
 
-public:
-    // Member vars
-    QPointer<Tick> curTick;                        // Currently selected Tick, may be NULL
+
+signals:
+    void tickSelected(TimedFrame *tf);        // When a new tick has been selected
+
+
+protected:
+    bool eventFilter(QObject *obj, QEvent *event);
+
+
+private slots:
+    void _onFrameRemoved(TimedFrame *tf);
+    void _onChangesCommitted();
+    void _onPlaneAdded(int plane);
 
 
 private:
-    int _seqNumAtEvent(QGraphicsSceneMouseEvent *event);
-    
+    int _seqNumAtEvent(QGraphicsSceneMouseEvent *event, int plane);
+    qreal _height();
+
     // Member variables
     QPointer<XSheet> _xsheet;                    // Pointer to XSheet (could possibly be NULL)
+    QPointer<TimedFrame> _curTF;                // TimedFrame of the currently selected Tick, may be NULL
+    QPointer<TimedFrame> _highlightTF;            // Drawn as selected instead of _curTF (e.g. during playback), may be NULL
+    qreal _tickWidth;                            // How wide a single sequence number is (zoom)
+    ThumbnailCache *_thumbnails;                // Thumbnails of the Frames, kept across XSheets
+    bool _showThumbnails = false;                // Are the thumbnails drawn above the Ticks?
 
     QGraphicsScene *_scene = NULL;                // Scene that cotains the Tickers, Ruler, Cursor, etc...
     QGraphicsView *_view = NULL;                // Just the view for the scene
+    TickStrip *_tickStrip = NULL;                // Draws all of the Ticks
     Ruler *_ruler = NULL;                        // Pointer to ruler contained in _scene
     Cursor *_cursor = NULL;                        // Pointer to cursor contained in _scene
-    QList<Tick *> _ticks;                        // List of all the Ticks currently in the timeline (in order)
-    QHash<TimedFrame *, Tick *> _tickMap;        // Use a Frame pointer to Map to a Tick pointer (unordered)
 
     // Markers
     TriangleMarker *_triMarker = NULL;            // Pointer to TriangleMarker
@@ -4,16 +4,20 @@
 
 
 #include "widgets/timeline/trianglemarker.h"
-#include "widgets/timeline/tick.h"
+#include "widgets/timeline/tickstrip.h"
 #include "widgets/timeline/ruler.h"
+#include "widgets/timeline/timeline.h"
 #include <QPointF>
 #include <QPolygonF>
 #include <QPen>
 
 
-TriangleMarker::TriangleMarker(QGraphicsItem *parent) :
-    QGraphicsPolygonItem(parent)
+TriangleMarker::TriangleMarker(Timeline *timeline, QGraphicsItem *parent) :
+    QGraphicsPolygonItem(parent),
+    _timeline(timeline)
 {
+    Q_ASSERT(_timeline != NULL);
+
     // Setup some points that will draw an isoscles triangle.
     QPolygonF poly;
     poly << QPointF(5, 0)
@@ -43,6 +47,6 @@ void TriangleMarker::moveToSeqNum(int num) {
         num = 1;
 
     qreal mid = boundingRect().width() / 2.0;
-    setPos(((num - 1) * TICK_WIDTH) - mid + 1, RULER_HEIGHT + TICK_HEIGHT);
+    setPos(_timeline->xAt(num) - mid + 1, RULER_HEIGHT + _timeline->tickStrip()->rowTop(1));        // Under the first plane
 }
 
@@ -16,17 +16,22 @@
 
 
 #include <QGraphicsPolygonItem>
+class Timeline;
 
 
 class TriangleMarker : public QGraphicsPolygonItem {
 public:
     enum { Type = UserType + TRIANGLE_MARKER_TYPE };
 
-    TriangleMarker(QGraphicsItem *parent=NULL);
+    TriangleMarker(Timeline *timeline, QGraphicsItem *parent=NULL);
     int type() const;
 
     void moveToSeqNum(int num);
 
+
+private:
+    Timeline *_timeline;        // Timeline (QWidget) that owns this TriangleMarker
+
 };
 
 
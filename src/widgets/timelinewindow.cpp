@@ -7,7 +7,6 @@
 #include "widgets/timelinewindow.h"
 #include "ui_timeline_window.h"
 #include "widgets/timeline/timeline.h"
-#include "widgets/timeline/tick.h"
 #include "widgets/timeline/cursor.h"
 #include "widgets/timeline/bracketmarker.h"
 #include "animation/pngcel.h"
@@ -16,7 +15,10 @@
 #include "animation/timedframe.h"
 #include "animation/xsheet.h"
 #include "animation/animation.h"
+#include "animation/timing.h"
 #include "blitapp.h"
+#include "undohistory.h"
+#include "playbackengine.h"
 #include <QString>
 #include <QDateTime>
 #include <QTimeLine>
@@ -26,6 +28,10 @@
 #include <QSpinBox>
 #include <QHBoxLayout>
 #include <QVBoxLayout>
+#include <QMenu>
+#include <QAction>
+#include <QInputDialog>
+#include <QUndoStack>
 #include <QCloseEvent>
 #include <QKeyEvent>
 
@@ -43,6 +49,19 @@ TimelineWindow::TimelineWindow(BlitApp *blitapp, QWidget *parent) :
     _ui->setupUi(this);
     _timeline = _ui->timeline;
 
+    // Range operations
+    _timingMenu = new QMenu(this);
+    _setHoldsAction = _timingMenu->addAction(tr("Set Holds..."));
+    _scaleHoldsAction = _timingMenu->addAction(tr("Scale Holds..."));
+    _collapseAction = _timingMenu->addAction(tr("Collapse Repeats"));
+    _timingMenu->addSeparator();
+    _reverseAction = _timingMenu->addAction(tr("Reverse"));
+    _pingPongAction = _timingMenu->addAction(tr("Ping-pong"));
+    _timingMenu->addSeparator();
+    _shiftLeftAction = _timingMenu->addAction(tr("Shift Left"));
+    _shiftRightAction = _timingMenu->addAction(tr("Shift Right"));
+    _ui->timingButton->setMenu(_timingMenu);
+
     // Metrics
     setWindowTitle("Timeline");
 //    setWindowFlags(Qt::Tool);
@@ -55,6 +74,7 @@ TimelineWindow::TimelineWindow(BlitApp *blitapp, QWidget *parent) :
 
     // Signals & Slots
     connect(blitapp, &BlitApp::curTimedFrameChanged, _timeline, &Timeline::selectTickByTimedFrame);
+    connect(_timeline, &Timeline::tickSelected, this, &TimelineWindow::onTickSelected);
 //    connect(_timeline->timelineCursor(), &Cursor::overNewTick, this, &TimelineWindow::onTickSelected);        // Defunct?
 //    connect(_ui->frameNameEdit, &QLineEdit::textEdited, this, &TimelineWindow::onFrameNameEditChanged);
     connect(blitapp, &BlitApp::curSeqNumChanged, this, &TimelineWindow::_onCurSeqNumChanged);
@@ -62,6 +82,9 @@ TimelineWindow::TimelineWindow(BlitApp *blitapp, QWidget *parent) :
     connect(_ui->copyFrameButton, &QToolButton::clicked, this, &TimelineWindow::_onCopyFrameClicked);
     connect(_ui->addFrameButton, &QToolButton::clicked, this, &TimelineWindow::_onAddFrameClicked);
     connect(_ui->deleteFrameButton, &QToolButton::clicked, this, &TimelineWindow::_onDeleteFrameClicked);
+    connect(_ui->addPlaneButton, &QToolButton::clicked, this, &TimelineWindow::_onAddPlaneClicked);
+    connect(_ui->thumbnailsButton, &QToolButton::toggled, this, &TimelineWindow::_onThumbnailsToggled);
+    connect(_timingMenu, &QMenu::triggered, this, &TimelineWindow::_onTimingMenuTriggered);
     connect(_ui->fpsSpinner, valueChangedSignal, this, &TimelineWindow::_onFPSSpinnerChanged);
 
     // Playback stuff
@@ -136,6 +159,24 @@ void TimelineWindow::keyPressEvent(QKeyEvent *event) {
             event->accept();
             break;
 
+        case Qt::Key_BracketLeft:
+            // Zoom out the Timeline
+            _timeline->zoomOut();
+            event->accept();
+            break;
+
+        case Qt::Key_BracketRight:
+            // Zoom in the Timeline
+            _timeline->zoomIn();
+            event->accept();
+            break;
+
+        case Qt::Key_Backslash:
+            // Fit the whole sheet in the Timeline
+            _timeline->zoomToFit();
+            event->accept();
+            break;
+
         defaut:
             // Call the base class in any other case
             QWidget::keyPressEvent(event);
@@ -158,6 +199,9 @@ void TimelineWindow::setAnimation(Animation *anim) {
     _ui->copyFrameButton->setEnabled(animSet);
     _ui->addFrameButton->setEnabled(animSet);
     _ui->deleteFrameButton->setEnabled(animSet);
+    _ui->addPlaneButton->setEnabled(animSet);
+    _ui->thumbnailsButton->setEnabled(animSet);
+    _ui->timingButton->setEnabled(animSet);
     _ui->fpsLabel->setEnabled(animSet);
     _ui->fpsSpinner->setEnabled(animSet);
 
@@ -169,19 +213,16 @@ void TimelineWindow::setAnimation(Animation *anim) {
 
     // Change the widget values depending upon an Animation being set
     if (animSet) {
-        // Set an XSheet, connect the tocks, and set some default values
+        // Set an XSheet and set some default values
         _timeline->setXSheet(anim->xsheet());
 
-        // Connect all ticks to onTickSelected() slot
-        QListIterator<Tick *> ticks(_timeline->ticks());
-        while (ticks.hasNext())
-            connect(ticks.next(), &Tick::selected, this, &TimelineWindow::onTickSelected);
-
         // Last few widget settings
         _ui->fpsSpinner->setValue(anim->xsheet()->FPS());        // Set FPS value
         _checkDisableDeleteFrame();                            // Check to disable to delete frame button
 
         connect(anim->xsheet(), &XSheet::frameMoved, this, &TimelineWindow::_onTimedFrameMoved);
+        connect(anim->xsheet(), &XSheet::changesCommitted, this, &TimelineWindow::_onTimedFrameMoved);
+        setFixedHeight(sizeHint().height());                // Might have more than one plane
 
         // connect the right bracket marker from the timeline
         connect(_timeline->rightBM(), &BracketMarker::seqNumOverChanged, this, &TimelineWindow::_onRightBracketMarkerSeqNumOverChanged);
@@ -249,22 +290,23 @@ void TimelineWindow::_onHoldSpinnerChanged(int hold) {
 
 void TimelineWindow::onTickSelected() {
     // When a Tick/Frame has been selected (or is set to the current). this function will be called.
-    Tick *tick = qobject_cast<Tick *>(sender());
 
     // Make sure there is a XSheet first
-    if (!BlitApp::app()->xsheet())
+    if (!BlitApp::app()->xsheet() || !tf)
         return;
 
     // Make sure not to move the Frames
     _changingFrames = true;
 
     // Set the widget values
-    TimedFrame *tf= tick->timedFrame();
     _ui->frameNameLabel->setText(tf->frame()->name());
     _ui->frameNumLabel->setText(QString::number(tf->seqNum()));
     _ui->holdSpinner->setValue(tf->hold());
 
     _changingFrames = false;
+
+    // Might have changed planes
+    _checkDisableDeleteFrame();
 }
 
 
@@ -298,18 +340,29 @@ void TimelineWindow::_onDeleteFrameClicked(bool checked) {
 
     // Vars
     XSheet *xsheet = BlitApp::app()->xsheet();
+    int plane = _curPlane();
     int overSeq = _timeline->timelineCursor()->seqNumOver();
 
     // Bounds check
-    if (overSeq > xsheet->seqLength())
-        overSeq = xsheet->seqLength();
+    if (overSeq > xsheet->planeLength(plane))
+        overSeq = xsheet->planeLength(plane);
     
-    // Do the removal, slots/signals should be taken care of,  Cleanup Cels
-    TimedFrame *tf = xsheet->removeFrame(overSeq);
-    tf->frame()->removeCelFiles();
-    delete tf->frame();
+    // Do the removal, slots/signals should be taken care of
+    TimedFrame *tf = xsheet->removeFrame(overSeq, plane);
+    Frame *frame = tf->frame();
     delete tf;
 
+    // Cleanup the Frame & its Cels, unless it's still used elsewhere in the sheet (e.g. after a ping-pong)
+    bool used = false;
+    QList<QPointer<TimedFrame>> refs = frame->timedFrames();
+    for (auto iter = refs.begin(); !used && (iter != refs.end()); iter++)
+        used = (*iter && ((*iter)->index() >= 0));
+
+    if (!used) {
+        frame->removeCelFiles();
+        delete frame;
+    }
+
     // Save the file
     BlitApp::app()->saveAnim();
     
@@ -318,6 +371,93 @@ void TimelineWindow::_onDeleteFrameClicked(bool checked) {
 }
 
 
+void TimelineWindow::_onAddPlaneClicked(bool checked) {
+    // Adds a new plane on top of the others, with one blank Frame in it (so every plane always
+    // has at least one Frame).  The new Frame is made current.
+    if (BlitApp::app()->anim() == NULL)
+        return;
+
+    playAnimation(false);
+
+    XSheet *xsheet = BlitApp::app()->xsheet();
+    int plane = xsheet->addPlane();
+    TimedFrame *tf = _mkNewFrame();
+    xsheet->addFrame(tf, XSHEET_END, plane);
+
+    // Select it
+    _timeline->selectTickByTimedFrame(tf);
+
+    // Another row in the Timeline
+    setFixedHeight(sizeHint().height());
+
+    BlitApp::app()->saveAnim();
+}
+
+
+void TimelineWindow::_onThumbnailsToggled(bool checked) {
+    // Shows/hides the thumbnails above the Ticks, which changes how tall the Timeline is
+    _timeline->showThumbnails(checked);
+    setFixedHeight(sizeHint().height());
+}
+
+
+void TimelineWindow::_onTimingMenuTriggered(QAction *action) {
+    // Does one of the range operations from the Timing menu, over the range from _timingRange().
+    // Each one is a single step in the undo history.
+    if (BlitApp::app()->anim() == NULL)
+        return;
+
+    playAnimation(false);
+
+    // What to work on
+    XSheet *xsheet = BlitApp::app()->xsheet();
+    int plane = _curPlane();
+    int first, count;
+    if (!_timingRange(first, count))
+        return;
+
+    QList<TimedFrame *> frames;
+    for (int i = first; i < (first + count); i++)
+        frames.append(xsheet->frameAt(i, plane));
+
+    // Do it
+    bool ok = false;
+    if (action == _setHoldsAction) {
+        int hold = QInputDialog::getInt(this, tr("Set Holds"), tr("Hold each frame for:"),
+                                        BlitApp::app()->curTimedFrame()->hold(), 1, 999, 1, &ok);
+        if (ok)
+            _retime(first, count, Timing::setHolds(frames, hold), tr("Set Holds"));
+    } else if (action == _scaleHoldsAction) {
+        double factor = QInputDialog::getDouble(this, tr("Scale Holds"), tr("Multiply the holds by:"),
+                                                2.0, 0.01, 100.0, 2, &ok);
+        if (ok)
+            _retime(first, count, Timing::scaleHolds(frames, factor), tr("Scale Holds"));
+    } else if (action == _collapseAction)
+        _retime(first, count, Timing::collapse(frames), tr("Collapse Repeats"));
+    else if (action == _reverseAction)
+        _retime(first, count, Timing::reverse(frames), tr("Reverse"));
+    else if (action == _pingPongAction)
+        _retime(first, count, Timing::pingPong(frames), tr("Ping-pong"));
+    else if (action == _shiftLeftAction) {
+        // Trades places with the frame before it
+        if (first == 0)
+            return;
+
+        frames.prepend(xsheet->frameAt(first - 1, plane));
+        _retime(first - 1, count + 1, Timing::rotate(frames, -1), tr("Shift Left"));
+    } else if (action == _shiftRightAction) {
+        // And the one after
+        if ((first + count) >= xsheet->numFrames(plane))
+            return;
+
+        frames.append(xsheet->frameAt(first + count, plane));
+        _retime(first, count + 1, Timing::rotate(frames, 1), tr("Shift Right"));
+    }
+
+    _checkDisableDeleteFrame();
+}
+
+
 void TimelineWindow::_onFPSSpinnerChanged(int fps) {
     // Changes the FPS of the animaion
     // Check for a set Animation
@@ -362,6 +502,7 @@ void TimelineWindow::playAnimation(bool play) {
         // // Stop playback
         _ui->playButton->setChecked(false);
         _playbackTimeline->stop();
+        _selectPlayedFrame();
     }
 
     // Set some other GUI stuff
@@ -370,6 +511,7 @@ void TimelineWindow::playAnimation(bool play) {
     _ui->copyFrameButton->setEnabled(!_playingAnim);
     _ui->addFrameButton->setEnabled(!_playingAnim);
     _ui->deleteFrameButton->setEnabled(!_playingAnim);
+    _ui->timingButton->setEnabled(!_playingAnim);
     _ui->selectivePlaybackButton->setEnabled(!_playingAnim);
 
     // Emit the signal
@@ -393,7 +535,7 @@ void TimelineWindow::_onBeginningClicked(bool checked) {
     if (_ui->selectivePlaybackButton->isChecked())
         _timeline->timelineCursor()->moveToSeqNum(_timeline->leftBM()->seqNumOver());
     else
-        _timeline->selectTickByIndex(0);
+        _timeline->selectTickByTimedFrame(BlitApp::app()->xsheet()->frames(_curPlane()).first());
 }
 
 
@@ -406,7 +548,7 @@ void TimelineWindow::_onEndClicked(bool checked) {
     if (_ui->selectivePlaybackButton->isChecked())
         _timeline->timelineCursor()->moveToSeqNum(_timeline->rightBM()->seqNumOver() + 1);
     else {
-        _timeline->selectTickByIndex(_timeline->ticks().size() - 1);
+        _timeline->selectTickByTimedFrame(BlitApp::app()->xsheet()->frames(_curPlane()).last());
         _timeline->timelineCursor()->moveToSeqNum(BlitApp::app()->xsheet()->seqLength() + 1);
     }
 }
@@ -465,7 +607,7 @@ void TimelineWindow::goBy(int numFrames) {
 
     
     XSheet *xsheet = BlitApp::app()->xsheet();
-    QList<QPointer<TimedFrame>> frames = xsheet->frames();
+    QList<QPointer<TimedFrame>> frames = xsheet->frames(_curPlane());
     int curTimedFrameIndex = frames.indexOf(BlitApp::app()->curTimedFrame());
     TimedFrame *tf = NULL;
 
@@ -524,10 +666,13 @@ void TimelineWindow::_setupPlayback(int startSeq) {
     Cursor *cursor = _timeline->timelineCursor();
     int endSeq = xsheet->seqLength() + 1;
 
+    int loopSeq = 1;
+
     // Use selective playback or not?
     if (_ui->selectivePlaybackButton->isChecked()) {
         startSeq = _timeline->leftBM()->seqNumOver();
         endSeq = _timeline->rightBM()->seqNumOver() + 1;
+        loopSeq = startSeq;
     }
     
     // Fixes a playback bug when the cursor is at the end
@@ -538,12 +683,18 @@ void TimelineWindow::_setupPlayback(int startSeq) {
     qreal msPerSeq = 1000.0 / (qreal)xsheet->FPS();
     qreal duration = msPerSeq * (endSeq - startSeq);
     
+    // Where the frames are might have changed since the last time
+    _playbackTF = NULL;
+
     // Setup the duration and ranges for the timeline:w
     _playbackTimeline->setDuration(duration);
     _playbackTimeline->setFrameRange(startSeq, endSeq);
 //    _playbackTimeline->setLoopCount(_ui->loopButton->isChecked() ? 0 : 1);
     _playbackTimeline->setUpdateInterval(10);
     _playbackTimeline->setCurveShape(QTimeLine::LinearCurve);
+
+    // So the engine knows what's coming up (and where a loop goes back to)
+    BlitApp::app()->playback()->setRange(loopSeq, endSeq - 1, _ui->loopButton->isChecked());
 }
 
 
@@ -553,7 +704,53 @@ void TimelineWindow::_checkDisableDeleteFrame() {
     if (!BlitApp::app()->xsheet())
         return;
 
-    _ui->deleteFrameButton->setEnabled(BlitApp::app()->xsheet()->numFrames() > 1);
+    _ui->deleteFrameButton->setEnabled(BlitApp::app()->xsheet()->numFrames(_curPlane()) > 1);
+}
+
+
+int TimelineWindow::_curPlane() {
+    // Internal function.  Returns the plane that the current TimedFrame is in, frame operations
+    // happen on that plane.
+    TimedFrame *tf = BlitApp::app()->curTimedFrame();
+    return tf ? tf->plane() : 0;
+}
+
+
+bool TimelineWindow::_timingRange(int &first, int &count) {
+    // Internal function.  Finds the range of frames (by index, in the current plane) that the
+    // Timing menu works on.  With selective playback on, it's the frames between the brackets,
+    // otherwise the whole plane.  Returns false if there are none.
+    XSheet *xsheet = BlitApp::app()->xsheet();
+    int plane = _curPlane();
+    first = 0;
+    count = xsheet->numFrames(plane);
+
+    if (_ui->selectivePlaybackButton->isChecked()) {
+        int length = xsheet->planeLength(plane);
+        int startSeq = _timeline->leftBM()->seqNumOver();
+        int endSeq = qMin(_timeline->rightBM()->seqNumOver(), length);
+        if ((startSeq > endSeq) || (startSeq < 1))
+            return false;
+
+        first = xsheet->frameAtSeq(startSeq, plane)->index();
+        count = xsheet->frameAtSeq(endSeq, plane)->index() - first + 1;
+    }
+
+    return (count > 0);
+}
+
+
+void TimelineWindow::_retime(int first, int count, QList<TimedFrame *> after, QString text) {
+    // Internal function.  Swaps out count frames from first (in the current plane) with
+    // after, as an undoable step.  Pushing it does the swap (and saves).
+    XSheet *xsheet = BlitApp::app()->xsheet();
+    int plane = _curPlane();
+
+    QList<TimedFrame *> before;
+    for (int i = first; i < (first + count); i++)
+        before.append(xsheet->frameAt(i, plane));
+
+    BlitApp::app()->history()->stack()->push(new TimingCommand(xsheet, plane, first, before, after, text));
 }
 
 
@@ -581,28 +778,27 @@ void TimelineWindow::_addTimedFrameToAnimation(TimedFrame *tf) {
 
     // Variables
     XSheet *xsheet = BlitApp::app()->xsheet();
+    int plane = _curPlane();
     int overSeq = _timeline->timelineCursor()->seqNumOver();
     int at = -1;
 
-    // Check where the cursor is and figure out a position to add the Frame
-    if (overSeq < xsheet->seqLength()) {
+    // Check where the cursor is and figure out a position to add the Frame (in the current plane)
+    if (overSeq < xsheet->planeLength(plane)) {
         // Within bounds of the current sequence, split of the seq nums for that frame
-        TimedFrame *overFrame = xsheet->frameAtSeq(overSeq);
+        TimedFrame *overFrame = xsheet->frameAtSeq(overSeq, plane);
         QList<int> seqNums = overFrame->seqNums();
         QList<int> firstHalf = seqNums.mid(0, seqNums.size() / 2);
 
         // If we are in the first half, then insert it before, else, insert it after
         at = (firstHalf.contains(overSeq)) ? overFrame->seqNum() : (overFrame->seqNum() + overFrame->hold());
     } else
-        at = xsheet->seqLength() + 1;        // Pop it onto the end
+        at = XSHEET_END;        // Pop it onto the end
 
     // Make and add the Frame (takes care of the Tick too)
-    xsheet->addFrame(tf, at);
+    xsheet->addFrame(tf, at, plane);
 
-    // Connect up the Tick, add a slot/signal and select it
-    Tick *newTick = _timeline->tickByTimedFrame(tf);
-    connect(newTick, &Tick::selected, this, &TimelineWindow::onTickSelected);
-    newTick->select();
+    // Select it
+    _timeline->selectTickByTimedFrame(tf);
 
     // Save the file
     BlitApp::app()->saveAnim();
@@ -637,10 +833,66 @@ void TimelineWindow::_onPlaybackTimelineFrameChanged(int frame) {
     // through the timeline and possibly change to the next frame.  It is assumed that the animation
     // is currently playing.
 
-    // Pull out the cursor object, and manipulate it
+    // Pull out the cursor object, and manipulate it.  That changes the current sequence number,
+    // which the Canvas follows
     Cursor *cursor = _timeline->timelineCursor();
     cursor->moveToSeqNum(frame);
-    cursor->getTickOver()->select();                // Won't always do something
+
+    // Won't always do something, the current plane might be shorter than the others.  Nothing is
+    // selected until playback stops, the Tick is only drawn as if it was
+    TimedFrame *last = _playbackTF;
+    TimedFrame *tf = _playbackFrameAt(frame);
+    _timeline->highlightTickByTimedFrame(tf);
+    if (tf && (tf != last)) {
+        _ui->frameNameLabel->setText(tf->frame()->name());
+        _ui->frameNumLabel->setText(QString::number(_playbackTFStart));
+    }
+}
+
+
+TimedFrame *TimelineWindow::_playbackFrameAt(int seqNum) {
+    // Internal function.  Returns the TimedFrame of the current plane at seqNum, for playback.  Playback
+    // almost always stays on the same frame or goes onto the next one, so those are checked first without
+    // searching the XSheet.  Only when it jumps (e.g. looping) is XSheet::frameAtSeq() used.
+    XSheet *xsheet = BlitApp::app()->xsheet();
+    int plane = _curPlane();
+    if (!xsheet)
+        return NULL;
+
+    // Same one
+    if (_playbackTF && (seqNum >= _playbackTFStart) && (seqNum < _playbackTFEnd))
+        return _playbackTF;
+
+    // The next one
+    TimedFrame *tf = NULL;
+    if (_playbackTF && (seqNum == _playbackTFEnd)) {
+        tf = xsheet->frameAt(_playbackTF->index() + 1, plane);
+        if (tf)
+            _playbackTFStart = _playbackTFEnd;
+    }
+
+    // Somewhere else
+    if (!tf) {
+        tf = xsheet->frameAtSeq(seqNum, plane);
+        if (tf)
+            _playbackTFStart = tf->seqNum();
+    }
+
+    _playbackTF = tf;
+    _playbackTFEnd = tf ? (_playbackTFStart + tf->hold()) : 0;
+    return tf;
+}
+
+
+void TimelineWindow::_selectPlayedFrame() {
+    // Internal function.  Called when playback stops, actually makes the frame that was being shown the
+    // current one (playback only highlights them).
+    _timeline->highlightTickByTimedFrame(NULL);
+    _playbackTF = NULL;
+
+    TimedFrame *tf = _timeline->timelineCursor()->timedFrameOver();
+    if (tf)
+        _timeline->selectTickByTimedFrame(tf);
 }
 
 
@@ -654,6 +906,7 @@ void TimelineWindow::_onPlaybackTimelineFinished() {
     } else {
         // Un-check the play button
         _ui->playButton->setChecked(false);
+        _selectPlayedFrame();
 
         // Fix the GUI
         _ui->holdSpinner->setEnabled(true);
@@ -661,6 +914,7 @@ void TimelineWindow::_onPlaybackTimelineFinished() {
         _ui->copyFrameButton->setEnabled(true);
         _ui->addFrameButton->setEnabled(true);
         _ui->deleteFrameButton->setEnabled(true);
+        _ui->timingButton->setEnabled(true);
         _ui->selectivePlaybackButton->setEnabled(true);
 
         _playingAnim = false;
@@ -18,10 +18,10 @@
 
 #include <QWidget>
 #include <QTimeLine>
+#include <QPointer>
 class BlitApp;
 class TimedFrame;
 class Animation;
-class Tick;
 class Timeline;
 class QString;
 class QTimeLine;
@@ -29,6 +29,8 @@ class QLabel;
 class QSpinBox;
 class QToolButton;
 class QHBoxLayout;
+class QMenu;
+class QAction;
 
 
 namespace Ui {
@@ -51,7 +53,7 @@ signals:
 public slots:
     void setAnimation(Animation *anim);
 
-    void onTickSelected();
+    void onTickSelected(TimedFrame *tf);
 
     // Play state
     void playAnimation(bool play=true);            // false for stop
@@ -83,6 +85,9 @@ private slots:
     void _onCopyFrameClicked(bool checked);
     void _onAddFrameClicked(bool checked);
     void _onDeleteFrameClicked(bool checked);
+    void _onAddPlaneClicked(bool checked);
+    void _onThumbnailsToggled(bool checked);
+    void _onTimingMenuTriggered(QAction *action);
     void _onFPSSpinnerChanged(int fps);
 
 
@@ -95,9 +100,14 @@ private:
     // Internal functions
     TimedFrame *_mkNewFrame(int hold=1);
     void _setupPlayback(int startSeq);
+    TimedFrame *_playbackFrameAt(int seqNum);
+    void _selectPlayedFrame();
     void _checkDisableDeleteFrame();
     void _addTimedFrameToAnimation(TimedFrame *tf);
     void _adjustTimingLabel(quint32 seqNum);
+    int _curPlane();
+    bool _timingRange(int &first, int &count);
+    void _retime(int first, int count, QList<TimedFrame *> after, QString text);
 
 
     // Member vars
@@ -105,11 +115,24 @@ private:
     bool _playingAnim = false;
     QTimeLine  *_playbackTimeline;
     bool _loopDone = false;
+    QPointer<TimedFrame> _playbackTF;        // Last frame shown during playback
+    int _playbackTFStart = 0;                // First sequence number of _playbackTF
+    int _playbackTFEnd = 0;                  // Sequence number right after _playbackTF's hold
 
     // GUI
     Ui::TimelineWindow *_ui;
     Timeline *_timeline;
 
+    // Timing menu
+    QMenu *_timingMenu;
+    QAction *_setHoldsAction;
+    QAction *_scaleHoldsAction;
+    QAction *_reverseAction;
+    QAction *_pingPongAction;
+    QAction *_shiftLeftAction;
+    QAction *_shiftRightAction;
+    QAction *_collapseAction;
+
 };
 
 
@@ -13,6 +13,7 @@
 #include "tools/shapetool.h"
 #include "tools/filltool.h"
 #include "tools/movetool.h"
+#include "tools/selecttool.h"
 #include "tools/resizetool.h"
 #include "tools/colorpickertool.h"
 #include <QGridLayout>
@@ -25,13 +26,14 @@ Toolbox::Toolbox(QWidget *parent) :
     // Load up the tools
     // TODO should be plugins
     _tools.append(new PenTool(this));
-//    _tools.append(new BrushTool(this));
+    _tools.append(new BrushTool(this));
     _tools.append(new EraserTool(this));
     _tools.append(new LineTool(this));
     _tools.append(new ShapeTool(this));
     _tools.append(new FillTool(this));
     _tools.append(new MoveTool(this));
-//    _tools.append(new ResizeTool(this));
+    _tools.append(new SelectTool(this));
+    _tools.append(new ResizeTool(this));
     _tools.append(new ColorPickerTool(this));
 
     // Widget construction and signals/slots